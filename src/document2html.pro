@@ -32,15 +32,18 @@ win32|win64 {
 	LIBS += -L$${PWD}/libs/curl/lib/ -llibcurl \
 			-L$${PWD}/libs/iconv/lib/ -llibiconvStatic \
 			-L$${PWD}/libs/pymagic/lib/ -llibmagic \
-			-L$${PWD}/libs/tidy/lib/ -ltidys
+			-L$${PWD}/libs/tidy/lib/ -ltidys \
+			-lpsapi
 }
 unix:!macx {
 	LIBS += -ltidy \
-			-lcurl
+			-lcurl \
+			-lpthread
 }
 
 SOURCES += main.cpp \
 		   libs/tools.cpp \
+		   libs/arena/arena.cpp \
 		   libs/curlwrapper/curlwrapper.cpp \
 		   libs/fileext/archive/archive.cpp \
 		   libs/fileext/cfb/cfb.cpp \
@@ -51,6 +54,8 @@ SOURCES += main.cpp \
 		   libs/fileext/excel/excel.cpp \
 		   libs/fileext/excel/format.cpp \
 		   libs/fileext/excel/formula.cpp \
+		   libs/fileext/excel/numberformat.cpp \
+		   libs/fileext/excel/sharedstrings.cpp \
 		   libs/fileext/excel/sheet.cpp \
 		   libs/fileext/excel/xlsx.cpp \
 		   libs/fileext/html/html.cpp \
@@ -64,6 +69,7 @@ SOURCES += main.cpp \
 		   libs/fileext/epub/epub.cpp \
 		   libs/fileext/json/json.cpp \
 		   libs/fileext/odt/odt.cpp \
+		   libs/fileext/pdf/cmap.cpp \
 		   libs/fileext/pdf/pdf.cpp \
 		   libs/fileext/ppt/ppt.cpp \
 		   libs/fileext/fileext.cpp \
@@ -75,6 +81,7 @@ SOURCES += main.cpp \
 		   libs/lodepng/lodepng.cpp
 
 HEADERS += libs/tools.hpp \
+		   libs/arena/arena.hpp \
 		   libs/curlwrapper/curlwrapper.hpp \
 		   libs/fileext/archive/archive.hpp \
 		   libs/fileext/cfb/cfb.hpp \
@@ -87,6 +94,8 @@ HEADERS += libs/tools.hpp \
 		   libs/fileext/excel/format.hpp \
 		   libs/fileext/excel/frmt.hpp \
 		   libs/fileext/excel/formula.hpp \
+		   libs/fileext/excel/numberformat.hpp \
+		   libs/fileext/excel/sharedstrings.hpp \
 		   libs/fileext/excel/sheet.hpp \
 		   libs/fileext/excel/xlsx.hpp \
 		   libs/fileext/html/html.hpp \
@@ -100,6 +109,7 @@ HEADERS += libs/tools.hpp \
 		   libs/fileext/epub/epub.hpp \
 		   libs/fileext/json/json.hpp \
 		   libs/fileext/odt/odt.hpp \
+		   libs/fileext/pdf/cmap.hpp \
 		   libs/fileext/pdf/pdf.hpp \
 		   libs/fileext/ppt/ppt.hpp \
 		   libs/fileext/fileext.hpp \
@@ -0,0 +1,146 @@
+/**
+ * @brief   Arena (bump) allocator for pugixml trees
+ * @package arena
+ * @file    arena.cpp
+ * @author  dmryutov (dmryutov@gmail.com)
+ * @date    18.10.2026
+ */
+#include <cstdlib>
+
+#if defined(_WIN32) || defined(_WIN64)
+	#include <windows.h>
+	#include <psapi.h>
+#else
+	#include <sys/resource.h>
+#endif
+
+#include "../pugixml/pugixml.hpp"
+
+#include "arena.hpp"
+
+
+namespace arena {
+
+/**
+ * Allocation header size. Header is stored before every allocation and keeps its owner,
+ * so memory allocated by heap and arena can be freed by the same function
+ */
+const size_t HEADER_SIZE = 16;
+/** Allocation owner: heap */
+const size_t OWNER_HEAP  = 0x48454150;
+/** Allocation owner: arena */
+const size_t OWNER_ARENA = 0x4152454E;
+/** Allocations bigger than this part of block are taken from heap */
+const size_t LARGE_DIVIDER = 4;
+
+/** Active arena of current thread */
+thread_local Arena* CURRENT_ARENA = nullptr;
+/** Install allocation functions before any pugixml tree is created */
+const bool IS_INSTALLED = (pugi::set_memory_management_functions(allocate, deallocate), true);
+
+// Arena
+Arena::Arena(size_t blockSize)
+	: m_blockSize(blockSize) {}
+
+Arena::~Arena() {
+	release();
+}
+
+void* Arena::allocate(size_t size) {
+	// Align to header size
+	size = (size + HEADER_SIZE - 1) & ~(HEADER_SIZE - 1);
+	if (static_cast<size_t>(m_end - m_position) < size) {
+		char* block = static_cast<char*>(malloc(m_blockSize));
+		if (!block)
+			return nullptr;
+		m_blockList.push_back(block);
+		m_position = block;
+		m_end = block + m_blockSize;
+		m_reservedSize += m_blockSize;
+	}
+	void* result = m_position;
+	m_position += size;
+	++m_allocationCount;
+	return result;
+}
+
+void Arena::release() {
+	for (auto block : m_blockList)
+		free(block);
+	m_blockList.clear();
+	m_position = nullptr;
+	m_end = nullptr;
+	m_reservedSize = 0;
+}
+
+size_t Arena::getBlockSize() const {
+	return m_blockSize;
+}
+
+size_t Arena::getAllocationCount() const {
+	return m_allocationCount;
+}
+
+size_t Arena::getReservedSize() const {
+	return m_reservedSize;
+}
+
+
+// Scope
+Scope::Scope(Arena& arena)
+	: m_previous(CURRENT_ARENA)
+{
+	CURRENT_ARENA = &arena;
+}
+
+Scope::~Scope() {
+	CURRENT_ARENA = m_previous;
+}
+
+
+// Functions
+void* allocate(size_t size) {
+	size_t* header;
+	Arena* arena = CURRENT_ARENA;
+	if (arena && size + HEADER_SIZE <= arena->getBlockSize() / LARGE_DIVIDER) {
+		header = static_cast<size_t*>(arena->allocate(size + HEADER_SIZE));
+		if (!header)
+			return nullptr;
+		*header = OWNER_ARENA;
+	}
+	else {
+		header = static_cast<size_t*>(malloc(size + HEADER_SIZE));
+		if (!header)
+			return nullptr;
+		*header = OWNER_HEAP;
+	}
+	return reinterpret_cast<char*>(header) + HEADER_SIZE;
+}
+
+void deallocate(void* ptr) {
+	if (!ptr)
+		return;
+	size_t* header = reinterpret_cast<size_t*>(static_cast<char*>(ptr) - HEADER_SIZE);
+	// Arena memory is freed with arena
+	if (*header == OWNER_HEAP)
+		free(header);
+}
+
+size_t getPeakMemoryUsage() {
+	#if defined(_WIN32) || defined(_WIN64)
+		PROCESS_MEMORY_COUNTERS counters;
+		if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+			return counters.PeakWorkingSetSize / 1024;
+		return 0;
+	#else
+		struct rusage usage;
+		getrusage(RUSAGE_SELF, &usage);
+		#if defined(__APPLE__)
+			return usage.ru_maxrss / 1024;
+		#else
+			return usage.ru_maxrss;
+		#endif
+	#endif
+}
+
+}  // End namespace
@@ -0,0 +1,160 @@
+/**
+ * @brief   Arena (bump) allocator for pugixml trees
+ * @package arena
+ * @file    arena.hpp
+ * @author  dmryutov (dmryutov@gmail.com)
+ * @version 1.0
+ * @date    18.10.2026
+ */
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+
+/**
+ * @namespace arena
+ * @brief
+ *     Arena (bump) allocator for pugixml trees
+ * @details
+ *     Allocation functions are installed to pugixml at program start. While arena is active
+ *     in current thread (see `arena::Scope`) all pugixml memory is taken from it and freed
+ *     in one shot when arena is destroyed. Otherwise default heap is used
+ */
+namespace arena {
+
+	/**
+	 * @class Arena
+	 * @brief
+	 *     Memory arena which allocates memory by big blocks and frees it all at once
+	 */
+	class Arena {
+	public:
+		/**
+		 * @param[in] blockSize
+		 *     Size of memory block
+		 * @since 1.0
+		 */
+		Arena(size_t blockSize = 1 << 20);
+
+		/** Destructor (frees all memory blocks) */
+		~Arena();
+
+		Arena(const Arena&) = delete;
+		Arena& operator=(const Arena&) = delete;
+
+		/**
+		 * @brief
+		 *     Allocate memory from arena
+		 * @param[in] size
+		 *     Size of memory
+		 * @return
+		 *     Pointer to allocated memory (16-byte aligned)
+		 * @since 1.0
+		 */
+		void* allocate(size_t size);
+
+		/**
+		 * @brief
+		 *     Free all memory blocks
+		 * @since 1.0
+		 */
+		void release();
+
+		/**
+		 * @brief
+		 *     Get memory block size
+		 * @return
+		 *     Block size (in bytes)
+		 * @since 1.0
+		 */
+		size_t getBlockSize() const;
+
+		/**
+		 * @brief
+		 *     Get amount of allocations
+		 * @return
+		 *     Allocation count
+		 * @since 1.0
+		 */
+		size_t getAllocationCount() const;
+
+		/**
+		 * @brief
+		 *     Get amount of memory reserved by arena
+		 * @return
+		 *     Reserved memory size (in bytes)
+		 * @since 1.0
+		 */
+		size_t getReservedSize() const;
+
+	private:
+		/** Memory block size */
+		size_t m_blockSize;
+		/** Memory blocks */
+		std::vector<char*> m_blockList;
+		/** Current position in last block */
+		char* m_position = nullptr;
+		/** End of last block */
+		char* m_end = nullptr;
+		/** Allocation count */
+		size_t m_allocationCount = 0;
+		/** Reserved memory size */
+		size_t m_reservedSize = 0;
+	};
+
+	/**
+	 * @class Scope
+	 * @brief
+	 *     Activate arena for current thread until end of scope
+	 */
+	class Scope {
+	public:
+		/**
+		 * @param[in] arena
+		 *     Arena which should be used by pugixml in current thread
+		 * @since 1.0
+		 */
+		Scope(Arena& arena);
+
+		/** Destructor (restores previous arena) */
+		~Scope();
+
+		Scope(const Scope&) = delete;
+		Scope& operator=(const Scope&) = delete;
+
+	private:
+		/** Previously active arena */
+		Arena* m_previous;
+	};
+
+	/**
+	 * @brief
+	 *     Allocation function for pugixml
+	 * @param[in] size
+	 *     Size of memory
+	 * @return
+	 *     Pointer to allocated memory
+	 * @since 1.0
+	 */
+	void* allocate(size_t size);
+
+	/**
+	 * @brief
+	 *     Deallocation function for pugixml (arena memory is freed with arena only)
+	 * @param[in] ptr
+	 *     Pointer to memory
+	 * @since 1.0
+	 */
+	void deallocate(void* ptr);
+
+	/**
+	 * @brief
+	 *     Get peak resident set size of current process
+	 * @return
+	 *     Peak RSS (in kilobytes)
+	 * @since 1.0
+	 */
+	size_t getPeakMemoryUsage();
+
+}  // End namespace
@@ -6,6 +6,7 @@
  * @date    22.08.2017 -- 29.10.2017
  */
 #pragma once
+#include <cerrno>
 #include <codecvt>
 #include <iostream>
 #include <sstream>
@@ -81,4 +82,108 @@ std::string htmlSpecialDecode(const std::string& code, int base) {
 	return output;
 }
 
+bool isUtf8(const char* data, size_t size, bool isPartial) {
+	const auto* p   = reinterpret_cast<const unsigned char*>(data);
+	const auto* end = p + size;
+	while (p < end) {
+		if (*p < 0x80) {
+			++p;
+			continue;
+		}
+
+		size_t length;
+		if ((*p & 0xE0) == 0xC0 && *p >= 0xC2)
+			length = 2;
+		else if ((*p & 0xF0) == 0xE0)
+			length = 3;
+		else if ((*p & 0xF8) == 0xF0 && *p <= 0xF4)
+			length = 4;
+		else
+			return false;
+
+		for (size_t i = 1; i < length; ++i) {
+			if (p + i == end)
+				return isPartial;
+			if ((p[i] & 0xC0) != 0x80)
+				return false;
+		}
+		p += length;
+	}
+	return true;
+}
+
+void appendUtf8(std::string& output, unsigned int code) {
+	if (code < 0x80) {
+		output += static_cast<char>(code);
+	}
+	else if (code < 0x800) {
+		output += static_cast<char>(0xC0 | (code >> 6));
+		output += static_cast<char>(0x80 | (code & 0x3F));
+	}
+	else if (code < 0x10000) {
+		output += static_cast<char>(0xE0 | (code >> 12));
+		output += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+		output += static_cast<char>(0x80 | (code & 0x3F));
+	}
+	else {
+		output += static_cast<char>(0xF0 | (code >> 18));
+		output += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+		output += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+		output += static_cast<char>(0x80 | (code & 0x3F));
+	}
+}
+
+
+// Decoder
+Decoder::Decoder(const std::string& fromCode, const std::string& toCode)
+	: m_converter(iconv_open(toCode.c_str(), fromCode.c_str())) {}
+
+Decoder::~Decoder() {
+	if (isValid())
+		iconv_close(static_cast<iconv_t>(m_converter));
+}
+
+bool Decoder::isValid() const {
+	return m_converter != reinterpret_cast<void*>(-1);
+}
+
+void Decoder::decode(const char* data, size_t size, std::string& result) {
+	if (!isValid()) {
+		result.append(data, size);
+		return;
+	}
+
+	std::string input = m_tail;
+	input.append(data, size);
+	m_tail.clear();
+
+	#if defined(_WIN32) || defined(_WIN64)
+		const char* ip = input.data();
+	#else
+		char* ip = &input[0];
+	#endif
+	size_t iCount = input.size();
+	char buffer[4096];
+
+	while (iCount > 0) {
+		char* op = buffer;
+		size_t oCount = sizeof(buffer);
+		size_t status = iconv(static_cast<iconv_t>(m_converter), &ip, &iCount, &op, &oCount);
+		result.append(buffer, sizeof(buffer) - oCount);
+
+		if (status != (size_t) - 1)
+			break;
+		// Incomplete sequence at the end of chunk
+		if (errno == EINVAL) {
+			m_tail.assign(ip, iCount);
+			break;
+		}
+		// Invalid sequence: skip one byte
+		if (errno == EILSEQ) {
+			++ip;
+			--iCount;
+		}
+	}
+}
+
 }  // End namespace
@@ -3,7 +3,7 @@
  * @package encoding
  * @file    encoding.hpp
  * @author  dmryutov (dmryutov@gmail.com)
- * @version 1.0.1
+ * @version 1.2
  * @date    22.08.2017 -- 29.10.2017
  */
 #pragma once
@@ -48,4 +48,85 @@ namespace encoding {
 	 */
 	std::string htmlSpecialDecode(const std::string& code, int base = 16);
 
+	/**
+	 * @brief
+	 *     Check if data is valid UTF-8 sequence
+	 * @param[in] data
+	 *     Input data
+	 * @param[in] size
+	 *     Data size
+	 * @param[in] isPartial
+	 *     True if data may end with incomplete multibyte sequence
+	 * @return
+	 *     True if data is valid UTF-8
+	 * @since 1.1
+	 */
+	bool isUtf8(const char* data, size_t size, bool isPartial = false);
+
+	/**
+	 * @brief
+	 *     Append Unicode code point to string in UTF-8
+	 * @param[out] output
+	 *     Result string
+	 * @param[in] code
+	 *     Unicode code point
+	 * @since 1.2
+	 */
+	void appendUtf8(std::string& output, unsigned int code);
+
+	/**
+	 * @class Decoder
+	 * @brief
+	 *     Incremental encoding converter (for data read by chunks)
+	 * @note
+	 *     Requires `iconv` library
+	 */
+	class Decoder {
+	public:
+		/**
+		 * @param[in] fromCode
+		 *     Old encoding
+		 * @param[in] toCode
+		 *     New encoding
+		 * @since 1.1
+		 */
+		Decoder(const std::string& fromCode, const std::string& toCode = "UTF-8");
+
+		/** Destructor */
+		~Decoder();
+
+		Decoder(const Decoder&) = delete;
+		Decoder& operator=(const Decoder&) = delete;
+
+		/**
+		 * @brief
+		 *     Check if conversion between encodings is supported
+		 * @return
+		 *     True if converter was opened
+		 * @since 1.1
+		 */
+		bool isValid() const;
+
+		/**
+		 * @brief
+		 *     Convert next chunk of data. Incomplete multibyte sequence at the end of chunk
+		 *     is kept until next call
+		 * @param[in] data
+		 *     Input data
+		 * @param[in] size
+		 *     Data size
+		 * @param[out] result
+		 *     Converted data (appended)
+		 * @since 1.1
+		 */
+		void decode(const char* data, size_t size, std::string& result);
+
+	private:
+		/** Iconv descriptor */
+		void* m_converter;
+		/** Incomplete sequence from previous chunk */
+		std::string m_tail;
+	};
+
+
 }  // End namespace
@@ -29,17 +29,89 @@ const int FREE_SECTOR   = 0xFFFFFFFF;
 /** Hex string char list */
 const char HEX_DATA[] = "0123456789ABCDEF";
 
-// public:
+// Stream public:
+bool Stream::empty() const {
+	return m_size == 0;
+}
+
+size_t Stream::size() const {
+	return m_size;
+}
+
+void Stream::read(size_t offset, size_t length, std::string& output) const {
+	output.clear();
+	if (offset >= m_size)
+		return;
+
+	length = std::min(length, m_size - offset);
+	size_t sectorMask = (static_cast<size_t>(1) << m_sectorShift) - 1;
+	while (length) {
+		// Copy part of data which is stored in current sector
+		size_t position = m_sectorList[offset >> m_sectorShift] + (offset & sectorMask);
+		if (position >= m_dataSize)
+			break;
+		size_t chunk = std::min(length, sectorMask + 1 - (offset & sectorMask));
+		chunk = std::min(chunk, m_dataSize - position);
+		output.append(m_data + position, chunk);
+		offset += chunk;
+		length -= chunk;
+	}
+}
+
+const char* Stream::view(size_t offset, size_t& length, std::string& buffer) const {
+	if (offset >= m_size || length == 0) {
+		length = 0;
+		buffer.clear();
+		return buffer.data();
+	}
+
+	length = std::min(length, m_size - offset);
+	size_t sectorSize = static_cast<size_t>(1) << m_sectorShift;
+	size_t position   = m_sectorList[offset >> m_sectorShift] + (offset & (sectorSize - 1));
+	// Chunk is contiguous if all its sectors follow each other in container
+	bool isContiguous = (position < m_dataSize && length <= m_dataSize - position);
+	size_t lastSector = (offset + length - 1) >> m_sectorShift;
+	for (size_t i = offset >> m_sectorShift; isContiguous && i < lastSector; ++i)
+		isContiguous = (m_sectorList[i + 1] == m_sectorList[i] + sectorSize);
+	if (isContiguous)
+		return m_data + position;
+
+	read(offset, length, buffer);
+	length = buffer.size();
+	return buffer.data();
+}
+
+void Stream::clear() {
+	m_data     = nullptr;
+	m_dataSize = 0;
+	m_size     = 0;
+	m_sectorList.clear();
+	m_sectorList.shrink_to_fit();
+}
+
+
+// Cfb public:
 Cfb::Cfb(const std::string& fileName)
 	: m_fileName(fileName) {}
 
 void Cfb::parse() {
-	std::ifstream inputFile(m_fileName, std::ios::binary);
-	m_data.assign(std::istreambuf_iterator<char>(inputFile), std::istreambuf_iterator<char>());
-	inputFile.close();
+	// Map file into memory, so streams can be read from their sectors without copying
+	m_file.reset(new tools::MappedFile(m_fileName));
+	if (m_file->data()) {
+		m_fileData = m_file->data();
+		m_fileSize = m_file->size();
+	}
+	else {
+		m_file.reset();
+		std::ifstream inputFile(m_fileName, std::ios::binary);
+		m_data.assign(std::istreambuf_iterator<char>(inputFile), std::istreambuf_iterator<char>());
+		inputFile.close();
+		m_fileData = m_data.data();
+		m_fileSize = m_data.size();
+	}
 
 	// Check CFB 8 bytes signature (widespread and deprecated)
-	auto abSig = binToHex(readByte<std::string>(m_data, 0, 8));
+	auto abSig = binToHex(readByte<std::string>(m_fileData, m_fileSize, 0, 8));
 	if (abSig != "D0CF11E0A1B11AE1" && abSig != "0E11FC0DD0CF11E0")
 		return;
 
@@ -83,7 +155,7 @@ std::string Cfb::getStream(const std::string& name, int offset, bool isRoot) con
 				int sectorSize = 1 << m_sectorShift;
 				do {
 					offset  = (start + 1) << m_sectorShift;
-					stream += m_data.substr(offset, sectorSize);
+					stream += readByte<std::string>(m_fileData, m_fileSize, offset, sectorSize);
 					start   = (start < static_cast<int>(m_fatChains.size()))
 							  ? m_fatChains[start]
 							  : END_OF_CHAIN;
@@ -95,7 +167,43 @@ std::string Cfb::getStream(const std::string& name, int offset, bool isRoot) con
 	return "";
 }
 
+bool Cfb::openStream(const std::string& name, Stream& stream) const {
+	for (const auto& entry : m_fatEntries) {
+		if (entry.first != name)
+			continue;
+
+		int    start = entry.second.at("start");
+		size_t size  = static_cast<unsigned int>(entry.second.at("size"));
+		// Small streams are stored in MiniFAT sectors of root stream
+		bool isMini  = size < m_miniSectorCutoff;
+		const std::vector<int>& chains = isMini ? m_miniFatChains : m_fatChains;
+
+		stream.clear();
+		stream.m_data        = isMini ? m_miniFat.data() : m_fileData;
+		stream.m_dataSize    = isMini ? m_miniFat.size() : m_fileSize;
+		stream.m_sectorShift = isMini ? m_miniSectorShift : m_sectorShift;
+		size_t sectorSize    = static_cast<size_t>(1) << stream.m_sectorShift;
+		size_t sectorCount   = (size + sectorSize - 1) / sectorSize;
+
+		stream.m_sectorList.reserve(sectorCount);
+		while (start != END_OF_CHAIN && stream.m_sectorList.size() < sectorCount) {
+			size_t sector = static_cast<unsigned int>(start);
+			stream.m_sectorList.push_back((isMini ? sector : sector + 1) << stream.m_sectorShift);
+			start = (start >= 0 && start < static_cast<int>(chains.size()))
+					? chains[start]
+					: END_OF_CHAIN;
+		}
+		// Chain may be shorter than stream size in broken files
+		stream.m_size = std::min(size, stream.m_sectorList.size() * sectorSize);
+		return true;
+	}
+	return false;
+}
+
 void Cfb::clear() {
+	m_file.reset();
+	m_fileData = nullptr;
+	m_fileSize = 0;
 	m_data.clear();
 	m_fatChains.clear();
 	m_fatEntries.clear();
@@ -146,7 +254,7 @@ std::string Cfb::decodeUTF16(const std::string& data) {
 }
 
 
-// protected:
+// Cfb protected:
 std::string Cfb::binToHex(const std::string& input) {
 	std::string out;
 	for (auto sc : input) {
@@ -234,27 +342,27 @@ std::string Cfb::unicodeToUtf8(std::string input, bool check) const {
 }
 
 
-// private:
+// Cfb private:
 void Cfb::handleHeader() {
-	m_isLittleEndian   = (binToHex(readByte<std::string>(m_data, 0x1C, 2)) == "FEFF");
-	m_version          = readByte<unsigned short>(m_data, 0x1A, 2);
-	m_sectorShift      = readByte<unsigned short>(m_data, 0x1E, 2);
-	m_miniSectorShift  = readByte<unsigned short>(m_data, 0x20, 2);
-	m_miniSectorCutoff = readByte<unsigned short>(m_data, 0x38, 2);
-
-	m_cDir     = (m_version == 4) ? readByte<int>(m_data, 0x28, 4) : 0;
-	m_fDir     = readByte<int>(m_data, 0x30, 4);
-	m_cFAT     = readByte<int>(m_data, 0x2C, 4);
-	m_cMiniFat = readByte<int>(m_data, 0x40, 4);
-	m_fMiniFat = readByte<int>(m_data, 0x3C, 4);
-	m_cDifat   = readByte<int>(m_data, 0x48, 4);
-	m_fDifat   = readByte<int>(m_data, 0x44, 4);
+	m_isLittleEndian   = (binToHex(readByte<std::string>(m_fileData, m_fileSize, 0x1C, 2)) == "FEFF");
+	m_version          = readByte<unsigned short>(m_fileData, m_fileSize, 0x1A, 2);
+	m_sectorShift      = readByte<unsigned short>(m_fileData, m_fileSize, 0x1E, 2);
+	m_miniSectorShift  = readByte<unsigned short>(m_fileData, m_fileSize, 0x20, 2);
+	m_miniSectorCutoff = readByte<unsigned short>(m_fileData, m_fileSize, 0x38, 2);
+
+	m_cDir     = (m_version == 4) ? readByte<int>(m_fileData, m_fileSize, 0x28, 4) : 0;
+	m_fDir     = readByte<int>(m_fileData, m_fileSize, 0x30, 4);
+	m_cFAT     = readByte<int>(m_fileData, m_fileSize, 0x2C, 4);
+	m_cMiniFat = readByte<int>(m_fileData, m_fileSize, 0x40, 4);
+	m_fMiniFat = readByte<int>(m_fileData, m_fileSize, 0x3C, 4);
+	m_cDifat   = readByte<int>(m_fileData, m_fileSize, 0x48, 4);
+	m_fDifat   = readByte<int>(m_fileData, m_fileSize, 0x44, 4);
 }
 
 void Cfb::handleDifat() {
 	// First 109 links to the chains are stored in header
 	for (int i = 0; i < 109; i++)
-		m_Difat.emplace_back(readByte<int>(m_data, 0x4C + i*4, 4));
+		m_Difat.emplace_back(readByte<int>(m_fileData, m_fileSize, 0x4C + i*4, 4));
 	// Searching for links to the chains in files > 8,5 Mb
 	if (m_fDifat != END_OF_CHAIN) {
 		int offset = m_fDifat;
@@ -264,9 +372,9 @@ void Cfb::handleDifat() {
 		do {
 			int start = (offset + 1) << m_sectorShift;
 			for (i = 0; i < (size - 4); i += 4)
-				m_Difat.emplace_back(readByte<int>(m_data, start + i, 4));
+				m_Difat.emplace_back(readByte<int>(m_fileData, m_fileSize, start + i, 4));
 			// Link to the next DIFAT-sector is in the last "word" in current DIFAT-sector
-			offset = readByte<int>(m_data, start + i, 4);
+			offset = readByte<int>(m_fileData, m_fileSize, start + i, 4);
 		} while (offset != END_OF_CHAIN && ++j < m_cDifat);
 	}
 
@@ -281,7 +389,7 @@ void Cfb::handleFatChains() {
 		int offset = (df + 1) << m_sectorShift;
 		// Get FAT-chain: index - current sector, value - index of next element
 		for (int j = 0; j < size; j += 4)
-			m_fatChains.emplace_back(readByte<int>(m_data, offset + j, 4));
+			m_fatChains.emplace_back(readByte<int>(m_fileData, m_fileSize, offset + j, 4));
 	}
 }
 
@@ -293,7 +401,7 @@ void Cfb::handleMiniFatChains() {
 		int start = (offset + 1) << m_sectorShift;
 		// Read chain from current sector
 		for (int i = 0; i < size; i += 4)
-			m_miniFatChains.emplace_back(readByte<int>(m_data, start + i, 4));
+			m_miniFatChains.emplace_back(readByte<int>(m_fileData, m_fileSize, start + i, 4));
 		offset = (offset < static_cast<int>(m_fatChains.size()))
 				 ? m_fatChains[offset]
 				 : END_OF_CHAIN;
@@ -307,7 +415,7 @@ void Cfb::handleDirectoryStructure() {
 		int start = (offset + 1) << m_sectorShift;
 		// Read 4/128 entrances in each sector
 		for (int i = 0; i < size; i += 128) {
-			auto entry = readByte<std::string>(m_data, start + i, 128);
+			auto entry = readByte<std::string>(m_fileData, m_fileSize, start + i, 128);
 			auto sz    = readByte<unsigned short>(entry, 0x40, 2) - 2;
 			m_fatEntries.push_back({
 				utf16ToAnsi(readByte<std::string>(entry, 0, sz)), {
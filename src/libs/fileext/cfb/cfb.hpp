@@ -4,16 +4,20 @@
  * @file      cfb.hpp
  * @author    dmryutov (dmryutov@gmail.com)
  * @copyright rembish (https://github.com/rembish/TextAtAnyCost)
- * @version   1.1
+ * @version   1.2
  * @date      18.09.2016 -- 29.01.2018
  */
 #pragma once
 
 #include <algorithm>
 #include <map>
+#include <memory>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
+#include "../../tools.hpp"
+
 
 /**
  * @namespace cfb
@@ -22,6 +26,88 @@
  */
 namespace cfb {
 
+/**
+ * @class Stream
+ * @brief
+ *     Binary stream which is read on demand from its sector chain
+ * @details
+ *     Stream holds only list of sector offsets, data stays in CFB file buffer (mapped file),
+ *     so it is valid while parent @ref Cfb object is not cleared. Reading is thread-safe
+ * @since 1.2
+ */
+class Stream {
+public:
+	/**
+	 * @brief
+	 *     Check if stream is empty
+	 * @return
+	 *     True if stream has no data
+	 * @since 1.2
+	 */
+	bool empty() const;
+
+	/**
+	 * @brief
+	 *     Get stream size
+	 * @return
+	 *     Stream size
+	 * @since 1.2
+	 */
+	size_t size() const;
+
+	/**
+	 * @brief
+	 *     Copy part of stream
+	 * @param[in] offset
+	 *     Start position in stream
+	 * @param[in] length
+	 *     Size of data chunk
+	 * @param[out] output
+	 *     Data chunk (shorter than #length at the end of stream)
+	 * @since 1.2
+	 */
+	void read(size_t offset, size_t length, std::string& output) const;
+
+	/**
+	 * @brief
+	 *     Get part of stream without copying
+	 * @details
+	 *     Chunk is copied to #buffer only if it spans sectors which are not adjacent in
+	 *     container
+	 * @param[in] offset
+	 *     Start position in stream
+	 * @param[in,out] length
+	 *     Size of data chunk (shorter than requested at the end of stream)
+	 * @param[out] buffer
+	 *     Buffer for chunks which are not stored contiguously
+	 * @return
+	 *     Pointer to data chunk
+	 * @since 1.2
+	 */
+	const char* view(size_t offset, size_t& length, std::string& buffer) const;
+
+	/**
+	 * @brief
+	 *     Clear sector list
+	 * @since 1.2
+	 */
+	void clear();
+
+private:
+	friend class Cfb;
+
+	/** Sectors container data */
+	const char* m_data = nullptr;
+	/** Sectors container size */
+	size_t m_dataSize = 0;
+	/** Sector offsets in container */
+	std::vector<size_t> m_sectorList;
+	/** Sector size shift */
+	unsigned short m_sectorShift = 9;
+	/** Stream size */
+	size_t m_size = 0;
+};
+
 /**
  * @class Cfb
  * @brief
@@ -49,11 +135,35 @@ public:
 	 *     Size of data chunk
 	 * @return
 	 *     Number value
+	 * @throw std::out_of_range
+	 *     Offset %1 is out of data range
 	 * @since 1.0
 	 */
 	template<typename T>
 	T readByte(const std::string& data, size_t offset, int size) const;
 
+	/**
+	 * @brief
+	 *     Read binary data
+	 * @tparam T
+	 *     Result data type
+	 * @param[in] data
+	 *     Binary data
+	 * @param[in] dataSize
+	 *     Size of #data
+	 * @param[in] offset
+	 *     Start position in #data
+	 * @param[in] size
+	 *     Size of data chunk
+	 * @return
+	 *     Number value
+	 * @throw std::out_of_range
+	 *     Offset %1 is out of data range
+	 * @since 1.2
+	 */
+	template<typename T>
+	T readByte(const char* data, size_t dataSize, size_t offset, int size) const;
+
 	/**
 	 * @brief
 	 *     Parse file-system-like structure within a file
@@ -76,6 +186,19 @@ public:
 	 */
 	std::string getStream(const std::string& name, int offset = 0, bool isRoot = false) const;
 
+	/**
+	 * @brief
+	 *     Open binary stream for reading without copying its content
+	 * @param[in] name
+	 *     Stream name
+	 * @param[out] stream
+	 *     Stream
+	 * @return
+	 *     True if stream exists
+	 * @since 1.2
+	 */
+	bool openStream(const std::string& name, Stream& stream) const;
+
 	/**
 	 * @brief
 	 *     Clear all data and release resources
@@ -122,8 +245,14 @@ protected:
 	 */
 	std::string unicodeToUtf8(std::string input, bool check = false) const;
 
-	/** File binary data */
+	/** Mapped file */
+	std::unique_ptr<tools::MappedFile> m_file;
+	/** File binary data (if file can't be mapped) */
 	std::string m_data;
+	/** File content (mapped file or #m_data) */
+	const char* m_fileData = nullptr;
+	/** File size */
+	size_t m_fileSize = 0;
 	/** FAT sector size shift (1 << 9 = 512) */
 	unsigned short m_sectorShift = 9;
 	/** MiniFAT sector size shift (1 << 6 = 64) */
@@ -220,16 +349,31 @@ private:
 
 template<typename T>
 T Cfb::readByte(const std::string& data, size_t offset, int size) const {
-	std::string str = data.substr(offset, size);
-	if (m_isLittleEndian)
-		std::reverse(str.begin(), str.end());
+	return readByte<T>(data.data(), data.size(), offset, size);
+}
 
+template<typename T>
+T Cfb::readByte(const char* data, size_t dataSize, size_t offset, int size) const {
+	if (offset >= dataSize)
+		throw std::out_of_range("Offset "+ std::to_string(offset) +" is out of data range");
+
+	// Combine bytes directly, without temporary strings
+	size_t count = std::min(static_cast<size_t>(size), dataSize - offset);
+	const unsigned char* bytes = reinterpret_cast<const unsigned char*>(data + offset);
 	union {
 		unsigned long long i;
 		T t;
 	} value;
 
-	value.i = std::stoull(binToHex(str), nullptr, 16);
+	value.i = 0;
+	if (m_isLittleEndian) {
+		for (size_t i = count; i > 0; --i)
+			value.i = (value.i << 8) | bytes[i - 1];
+	}
+	else {
+		for (size_t i = 0; i < count; ++i)
+			value.i = (value.i << 8) | bytes[i];
+	}
 	return value.t;
 
 	/*unsigned long long i;
@@ -241,10 +385,12 @@ T Cfb::readByte(const std::string& data, size_t offset, int size) const {
 }
 
 template<>
-inline std::string Cfb::readByte<std::string>(const std::string& data, size_t offset,
+inline std::string Cfb::readByte<std::string>(const char* data, size_t dataSize, size_t offset,
 											   int size) const
 {
-	return data.substr(offset, size);
+	if (offset > dataSize)
+		throw std::out_of_range("Offset "+ std::to_string(offset) +" is out of data range");
+	return std::string(data + offset, std::min(static_cast<size_t>(size), dataSize - offset));
 	/*std::string str = binToHex(data.substr(offset, size));
 
 	std::string out;
@@ -7,8 +7,12 @@
  * @date      12.07.2016 -- 18.10.2017
  */
 #include <algorithm>
+#include <cctype>
+#include <cstring>
 #include <fstream>
 
+#include "../../arena/arena.hpp"
+
 #include "docx.hpp"
 
 
@@ -48,10 +52,13 @@ const std::vector<std::string> CONTENT_TAGS {
 };
 /** Horizontal align map */
 const std::unordered_map<std::string, std::string> HORZ_ALIGN {
-	{"left",   "left"},
-	{"center", "center"},
-	{"right",  "right"},
-	{"both",   "justify"},
+	{"left",       "left"},
+	{"start",      "left"},
+	{"center",     "center"},
+	{"right",      "right"},
+	{"end",        "right"},
+	{"both",       "justify"},
+	{"distribute", "justify"}
 };
 /** Vertical align map */
 const std::unordered_map<std::string, std::string> VERT_ALIGN {
@@ -104,6 +111,12 @@ const std::vector<std::string> BORDER_LIST {
 	"right",
 	"bottom"
 };
+/** Max length of style `basedOn` chain */
+const size_t MAX_STYLE_DEPTH = 32;
+/** Size of inflated block in streaming mode */
+const size_t BLOCK_SIZE = 1 << 16;
+/** Arena block size for trees of one body element in streaming mode */
+const size_t ELEMENT_ARENA_SIZE = 1 << 18;
 
 // public:
 Docx::Docx(const std::string& fileName)
@@ -113,39 +126,55 @@ void Docx::convert(bool addStyle, bool extractImages, char mergingMode) {
 	m_addStyle      = addStyle;
 	m_extractImages = extractImages;
 	m_mergingMode   = mergingMode;
-	auto mainNode   = m_htmlTree.append_child("html").append_child("body");
 
 	getNumberingMap();
 	getStyleMap();
 	getRelationshipMap();
 
+	// Streaming mode (body is converted in `saveHtml()`)
+	if (m_streamMode) {
+		m_extractImages = false;
+		return;
+	}
+
 	pugi::xml_document tree;
 	Ooxml::extractFile(m_fileName, "word/document.xml", tree);
 
-	for (const auto& node : tree.child("w:document").child("w:body")) {
+	auto mainNode = m_htmlTree.append_child("html").append_child("body");
+	convertBody(tree.child("w:document").child("w:body"), mainNode);
+}
+
+
+// protected:
+void Docx::streamHtml(std::ostream& output) {
+	streamBody(output);
+}
+
+
+// private:
+void Docx::convertBody(const pugi::xml_node& bodyNode, pugi::xml_node& mainNode) {
+	for (const auto& node : bodyNode) {
 		// Lists are handled specific => could double visit certain elements. Keep track
 		// of visited elements and skip any that have been visited already
 		std::string nodeName = node.name();
-		if (nodeName == "w:sectPr" ||
-			find(m_visitedNodeList.begin(), m_visitedNodeList.end(), node) !=
-				m_visitedNodeList.end()
-		)
+		if (nodeName == "w:sectPr")
+			continue;
+		auto& info = getParagraphInfo(node);
+		if (info.m_isVisited)
 			continue;
-		std::string headerValue = isHeader(node);
-		if (!headerValue.empty()) {
-			auto header = mainNode.append_child(headerValue.c_str());
+		if (!info.m_header.empty()) {
+			auto header = mainNode.append_child(info.m_header.c_str());
 			getParagraphText(node, header);
 			if (!header.first_child())
 				header.parent().remove_child(header);
 		}
 		else if (nodeName == "w:p") {
 			// Certain `p` tags denoted as `Title` tags. Strip out them
-			auto pStyle = node.select_node(".//w:pStyle");
-			std::string isTitle = pStyle.node().attribute("w:val").value();
-			if (isTitle == "Title")
+			auto pStyle = node.child("w:pPr").child("w:pStyle");
+			if (strcmp(pStyle.attribute("w:val").value(), "Title") == 0)
 				continue;
 			// Parse out the needed info from node
-			if (isLi(node)) {
+			if (info.m_isLi) {
 				buildList(node, mainNode);
 			}
 			// Handle generic `p` tag
@@ -161,12 +190,169 @@ void Docx::convert(bool addStyle, bool extractImages, char mergingMode) {
 			buildTable(node, table);
 			continue;
 		}
-		m_visitedNodeList.emplace_back(node);
+		getParagraphInfo(node).m_isVisited = true;
 	}
 }
 
+void Docx::streamBody(std::ostream& output) {
+	ooxml::FileReader reader(m_fileName, "word/document.xml");
+	std::vector<char> block(BLOCK_SIZE);
+	std::string buffer;
+	// Consecutive list items (they are converted together)
+	std::string group;
+	// Nesting level inside `w:body` (-1 if body is not opened yet)
+	int depth = -1;
+	size_t position     = 0;
+	size_t elementStart = std::string::npos;
+
+	while (true) {
+		size_t tagStart = buffer.find('<', position);
+		size_t tagEnd   = std::string::npos;
+		if (tagStart != std::string::npos)
+			tagEnd = findTagEnd(buffer, tagStart);
+
+		// Markup is incomplete: drop processed data and inflate next block
+		if (tagEnd == std::string::npos) {
+			size_t offset = (elementStart != std::string::npos) ? elementStart :
+							(tagStart != std::string::npos) ? tagStart : buffer.size();
+			buffer.erase(0, offset);
+			if (elementStart != std::string::npos)
+				elementStart = 0;
+			position = (tagStart != std::string::npos) ? tagStart - offset : buffer.size();
+
+			size_t size = reader.read(block.data(), block.size());
+			if (size == 0)
+				break;
+			buffer.append(block.data(), size);
+			continue;
+		}
+		position = tagEnd;
+
+		// Skip comments, declarations and processing instructions
+		char type = buffer[tagStart + 1];
+		if (type == '!' || type == '?')
+			continue;
+		bool isClosing = (type == '/');
+		bool isEmpty   = (buffer[tagEnd - 2] == '/');
+
+		if (depth < 0) {
+			if (!isClosing && !isEmpty && isTagName(buffer, tagStart + 1, "w:body"))
+				depth = 0;
+			continue;
+		}
+		if (isClosing) {
+			// End of `w:body`
+			if (depth == 0)
+				break;
+			if (--depth != 0)
+				continue;
+		}
+		else if (depth == 0) {
+			elementStart = tagStart;
+			if (!isEmpty) {
+				++depth;
+				continue;
+			}
+		}
+		else {
+			if (!isEmpty)
+				++depth;
+			continue;
+		}
+
+		// Top-level element is complete
+		const char* element = buffer.data() + elementStart;
+		size_t elementSize  = tagEnd - elementStart;
+		elementStart = std::string::npos;
+		if (isTagName(buffer, tagStart + (isClosing ? 2 : 1), "w:sectPr"))
+			continue;
+
+		// Trees of element are freed right after it is written (not with conversion arena)
+		arena::Arena memory(ELEMENT_ARENA_SIZE);
+		arena::Scope memoryScope(memory);
+		pugi::xml_document tree;
+		tree.load_buffer(element, elementSize);
+		if (getParagraphInfo(tree.first_child()).m_isLi) {
+			m_paragraphInfoMap.clear();
+			group.append(element, elementSize);
+			continue;
+		}
+		m_paragraphInfoMap.clear();
+		if (!group.empty()) {
+			pugi::xml_document groupTree;
+			groupTree.load_buffer(group.data(), group.size(),
+								  pugi::parse_default | pugi::parse_fragment);
+			writeBlocks(groupTree, output);
+			group.clear();
+		}
+		writeBlocks(tree, output);
+	}
+
+	if (!group.empty()) {
+		arena::Arena memory(ELEMENT_ARENA_SIZE);
+		arena::Scope memoryScope(memory);
+		pugi::xml_document groupTree;
+		groupTree.load_buffer(group.data(), group.size(),
+							  pugi::parse_default | pugi::parse_fragment);
+		writeBlocks(groupTree, output);
+	}
+}
+
+void Docx::writeBlocks(const pugi::xml_node& parentNode, std::ostream& output) {
+	pugi::xml_document htmlTree;
+	auto body = htmlTree.append_child("body");
+	convertBody(parentNode, body);
+	for (const auto& child : body) {
+		child.print(output, "", pugi::format_raw | pugi::format_no_empty_element_tags);
+		output << '\n';
+	}
+
+	// Nodes of next elements may reuse memory of these ones
+	m_paragraphInfoMap.clear();
+	m_paragraphNode = pugi::xml_node();
+	m_hasRunStyle   = false;
+}
+
+size_t Docx::findTagEnd(const std::string& data, size_t start) {
+	const char* terminator = ">";
+	if (data.compare(start, 4, "<!--") == 0)
+		terminator = "-->";
+	else if (data.compare(start, 9, "<![CDATA[") == 0)
+		terminator = "]]>";
+	else if (data.compare(start, 2, "<?") == 0)
+		terminator = "?>";
+	else if (data.size() - start < 9 && data.compare(start, 2, "<!") == 0)
+		return std::string::npos;
+
+	if (*terminator != '>') {
+		size_t end = data.find(terminator, start + 2);
+		return (end == std::string::npos) ? end : end + strlen(terminator);
+	}
+	// Tag: `>` can be inside attribute value
+	char quote = 0;
+	for (size_t i = start + 1; i < data.size(); ++i) {
+		if (quote) {
+			if (data[i] == quote)
+				quote = 0;
+		}
+		else if (data[i] == '"' || data[i] == '\'') {
+			quote = data[i];
+		}
+		else if (data[i] == '>') {
+			return i + 1;
+		}
+	}
+	return std::string::npos;
+}
+
+bool Docx::isTagName(const std::string& data, size_t start, const char* name) {
+	size_t size = strlen(name);
+	if (data.compare(start, size, name) != 0)
+		return false;
+	char next = data[start + size];
+	return (next == '>' || next == '/' || isspace(static_cast<unsigned char>(next)));
+}
 
-// private:
 void Docx::getNumberingMap() {
 	pugi::xml_document tree;
 	Ooxml::extractFile(m_fileName, "word/numbering.xml", tree);
@@ -199,39 +385,44 @@ void Docx::getStyleMap() {
 	pugi::xml_document tree;
 	Ooxml::extractFile(m_fileName, "word/styles.xml", tree);
 
-	// This is a partial document and actual H1 is the document title, which
-	// will be displayed elsewhere
+	std::unordered_map<std::string, pugi::xml_node> nodeMap;
 	for (const auto& node : tree.select_nodes("//w:style")) {
 		auto nd = node.node();
-		std::unordered_map<std::string, std::string> style {
-			{"header",    ""},
-			{"font_size", ""},
-			{"based_on",  ""}
-		};
-		// Get header info
-		auto name = nd.child("w:name");
-		if (!name)
-			continue;
-		std::string value = name.attribute("w:val").value();
-		transform(value.begin(), value.end(), value.begin(), ::tolower);
-		if (HEADER_LIST.find(value) != HEADER_LIST.end())
-			style["header"] = HEADER_LIST.at(value);
-
-		// Get size info
-		auto rPr = nd.child("w:rPr");
-		if (!rPr)
-			continue;
-		auto size = rPr.child("w:sz");
-		if (size)
-			style["font_size"] = size.attribute("w:val").value();
+		std::string styleId = nd.attribute("w:styleId").value();
+		nodeMap[styleId] = nd;
+		if (nd.attribute("w:default").as_bool() &&
+			strcmp(nd.attribute("w:type").value(), "paragraph") == 0
+		)
+			m_defaultStyleId = styleId;
+	}
 
-		// Get based on info
-		auto basedOn = nd.child("w:basedOn");
-		if (basedOn)
-			style["based_on"] = basedOn.attribute("w:val").value();
+	std::vector<pugi::xml_node> chain;
+	for (const auto& item : nodeMap) {
+		// Collect `basedOn` chain (it may be broken or cyclic)
+		chain.clear();
+		for (auto nd = item.second; nd && chain.size() < MAX_STYLE_DEPTH; ) {
+			if (find(chain.begin(), chain.end(), nd) != chain.end())
+				break;
+			chain.emplace_back(nd);
+			auto basedOn = nodeMap.find(nd.child("w:basedOn").attribute("w:val").value());
+			nd = (basedOn != nodeMap.end()) ? basedOn->second : pugi::xml_node();
+		}
 
-		std::string styleId = nd.attribute("w:styleId").value();
-		m_styleMap[styleId] = style;
+		// Apply properties from base style to derived one
+		Style& style = m_styleMap[item.first];
+		for (auto nd = chain.rbegin(); nd != chain.rend(); ++nd) {
+			readParagraphStyle(nd->child("w:pPr"), style);
+			readRunStyle(nd->child("w:rPr"), style.m_run);
+		}
+		getParagraphCss(style, style.m_css);
+
+		// Get header info. This is a partial document and actual H1 is the document title,
+		// which will be displayed elsewhere
+		std::string name = item.second.child("w:name").attribute("w:val").value();
+		transform(name.begin(), name.end(), name.begin(), ::tolower);
+		auto header = HEADER_LIST.find(name);
+		if (header != HEADER_LIST.end())
+			style.m_header = header->second;
 	}
 }
 
@@ -247,40 +438,35 @@ void Docx::getRelationshipMap() {
 }
 
 
-std::string Docx::isHeader(const pugi::xml_node& node) const {
-	if (isTopLevel(node))
-		return "h2";
-	std::string el_isNaturalHeader = isNaturalHeader(node);
-	if (!el_isNaturalHeader.empty())
-		return el_isNaturalHeader;
-	if (hasIndentationLevel(node))
-		return "";
-	if (strcmp(node.name(), "w:tbl") == 0)
-		return "";
-	return "";
-}
+ParagraphInfo& Docx::getParagraphInfo(const pugi::xml_node& node) {
+	auto result = m_paragraphInfoMap.emplace(node.hash_value(), ParagraphInfo());
+	auto& info  = result.first->second;
+	if (!result.second)
+		return info;
 
-std::string Docx::isNaturalHeader(const pugi::xml_node& node) const {
-	auto pPr = node.child("w:pPr");
-	if (!pPr)
-		return "";
-	auto pStyle = pPr.child("w:pStyle");
-	if (!pStyle)
-		return "";
-	std::string styleId = pStyle.attribute("w:val").value();
-	if (m_styleMap.at(styleId).at("header") != "false")
-		return m_styleMap.at(styleId).at("header");
-	return "";
-}
+	auto pPr   = node.child("w:pPr");
+	auto numPr = pPr.child("w:numPr");
+	auto ilvl  = numPr.child("w:ilvl");
+	info.m_numId = numPr.child("w:numId").attribute("w:val").value();
+	if (ilvl)
+		info.m_ilvl = ilvl.attribute("w:val").as_int();
 
-std::string Docx::getNumberingId(const pugi::xml_node& node) const {
-	auto numId = node.select_node(".//w:numId");
-	return numId.node().attribute("w:val").value();
+	info.m_isTopLevel = isTopLevel(info.m_numId, info.m_ilvl);
+	if (info.m_isTopLevel)
+		info.m_header = "h2";
+	else
+		info.m_header = isNaturalHeader(pPr.child("w:pStyle").attribute("w:val").value());
+	info.m_isLi = (info.m_header.empty() && ilvl);
+	return info;
 }
 
-bool Docx::hasIndentationLevel(const pugi::xml_node& node) const {
-	auto ilvl = node.select_nodes(".//w:numPr/w:ilvl");
-	return (ilvl.end() - ilvl.begin() != 0);
+std::string Docx::isNaturalHeader(const char* styleId) const {
+	if (!*styleId)
+		return "";
+	auto style = m_styleMap.find(styleId);
+	if (style == m_styleMap.end())
+		return "";
+	return style->second.m_header;
 }
 
 // Paragraph
@@ -333,9 +519,10 @@ void Docx::buildHyperlink(const pugi::xml_node& xmlNode, pugi::xml_node& htmlNod
 	auto hyperlinkId = xmlNode.attribute("r:id").value();
 
 	// Once we have hyperlinkId then we need to replace hyperlink tag with its child run tags
-	if (m_relationshipMap.find(hyperlinkId) != m_relationshipMap.end()) {
+	auto relationship = m_relationshipMap.find(hyperlinkId);
+	if (relationship != m_relationshipMap.end()) {
 		auto link = htmlNode.append_child("a");
-		link.append_attribute("href") = m_relationshipMap[hyperlinkId].c_str();
+		link.append_attribute("href") = relationship->second.c_str();
 		getParagraphText(xmlNode, link);
 	}
 }
@@ -369,9 +556,10 @@ void Docx::buildImage(const pugi::xml_node& xmlNode, pugi::xml_node& htmlNode) {
 
 	std::string imageId = getImageId(xmlNode);
 	// This image does not have image id
-	if (m_relationshipMap.find(imageId) == m_relationshipMap.end())
+	auto relationship = m_relationshipMap.find(imageId);
+	if (relationship == m_relationshipMap.end())
 		return;
-	std::string path = "word/" + m_relationshipMap[imageId];
+	std::string path = "word/" + relationship->second;
 
 	// Load image
 	std::string ext = path.substr(path.find_last_of('.') + 1);
@@ -405,10 +593,10 @@ void Docx::buildTable(const pugi::xml_node& xmlNode, pugi::xml_node& htmlNode) {
 void Docx::buildTr(const pugi::xml_node& xmlNode, pugi::xml_node& htmlNode) {
 	int colIndex = 0;
 	for (const auto& child : xmlNode.children("w:tc")) {
-		if (find(m_visitedNodeList.begin(), m_visitedNodeList.end(), child) != m_visitedNodeList.end())
+		if (getParagraphInfo(child).m_isVisited)
 			continue;
-		// Keep track of m_visitedNodeList
-		m_visitedNodeList.emplace_back(xmlNode);
+		// Keep track of visited nodes
+		getParagraphInfo(xmlNode).m_isVisited = true;
 
 		// vMerge is what docx uses to denote that table cell is part of rowspan. First
 		// cell has vMerge - start of rowspan, and vMerge will be denoted with `restart`.
@@ -426,15 +614,14 @@ void Docx::buildTr(const pugi::xml_node& xmlNode, pugi::xml_node& htmlNode) {
 		bool needNewLine = false;
 		for (const auto& tdContent : child) {
 			// Since we are doing look-a-heads in this loop we need to check already visited nodes
-			if (find(m_visitedNodeList.begin(), m_visitedNodeList.end(), tdContent) !=
-				m_visitedNodeList.end()
-			)
+			auto& info = getParagraphInfo(tdContent);
+			if (info.m_isVisited)
 				continue;
 
 			std::string tdContentName = tdContent.name();
 			// Check to see if it is list or regular paragraph
-			// If it is a list, create list and update m_visitedNodeList
-			if (isLi(tdContent)) {
+			// If it is a list, create list and mark its nodes as visited
+			if (info.m_isLi) {
 				buildList(tdContent, td);
 			}
 			else if (tdContentName == "w:tbl") {
@@ -443,7 +630,7 @@ void Docx::buildTr(const pugi::xml_node& xmlNode, pugi::xml_node& htmlNode) {
 			}
 			// Do nothing
 			else if (tdContentName == "w:tcPr") {
-				m_visitedNodeList.push_back(tdContent);
+				info.m_isVisited = true;
 				continue;
 			}
 			else {
@@ -472,8 +659,8 @@ void Docx::buildTr(const pugi::xml_node& xmlNode, pugi::xml_node& htmlNode) {
 					td.append_copy(nd);
 				// Add style
 				if (m_addStyle) {
-					td.remove_attribute("style");
-					td.append_copy(prevTd->attribute("style"));
+					td.remove_attribute("class");
+					td.append_copy(prevTd->attribute("class"));
 				}
 			}
 			// Colspan
@@ -485,7 +672,7 @@ void Docx::buildTr(const pugi::xml_node& xmlNode, pugi::xml_node& htmlNode) {
 				}
 				// Add style
 				if (m_addStyle)
-					newTd.append_copy(newTd.previous_sibling().attribute("style"));
+					newTd.append_copy(newTd.previous_sibling().attribute("class"));
 
 				colIndex++;
 			}
@@ -543,16 +730,23 @@ void Docx::buildList(const pugi::xml_node& xmlNode, pugi::xml_node& htmlNode) {
 	nestedLists.emplace_back(htmlNode);
 
 	for (const auto& li : liNodes) {
-		if (!isLi(li)) {
+		auto& info = getParagraphInfo(li);
+		if (!info.m_isLi) {
 			// Get content and visited nodes
 			buildNonListContent(li, htmlNode);
-			m_visitedNodeList.emplace_back(li);
+			info.m_isVisited = true;
 			continue;
 		}
 
-		int ilvl = getIndentationLevel(li);
-		std::string numId = getNumberingId(li);
-		std::string listType = m_numberingMap[numId][ilvl];
+		int ilvl = info.m_ilvl;
+		const std::string& numId = info.m_numId;
+		std::string listType;
+		auto numbering = m_numberingMap.find(numId);
+		if (numbering != m_numberingMap.end() && ilvl >= 0 &&
+			ilvl < static_cast<int>(numbering->second.size()))
+		{
+			listType = numbering->second[ilvl];
+		}
 		if (listType.empty())
 			listType = "decimal";
 
@@ -581,26 +775,28 @@ void Docx::buildList(const pugi::xml_node& xmlNode, pugi::xml_node& htmlNode) {
 		getParagraphText(li, node);
 		currentList = node;
 
-		m_visitedNodeList.push_back(li);
+		info.m_isVisited = true;
 	}
 }
 
-void Docx::getListNodes(const pugi::xml_node& node, std::vector<pugi::xml_node>& liNodes) const {
+void Docx::getListNodes(const pugi::xml_node& node, std::vector<pugi::xml_node>& liNodes) {
 	liNodes.emplace_back(node);
-	std::string currentNumId  = getNumberingId(node);
-	int startIndentationLevel = getIndentationLevel(node);
-	for (auto li = node; li; li = li.next_sibling()) {
+	const auto& startInfo = getParagraphInfo(node);
+	std::string currentNumId  = startInfo.m_numId;
+	int startIndentationLevel = startInfo.m_ilvl;
+	for (auto li = node.next_sibling(); li; li = li.next_sibling()) {
 		if (!li.child_value())
 			continue;
 
-		// Stop lists if come across list item that should be heading
-		if (isTopLevel(li))
+		// Stop lists if come across element that should be heading
+		const auto& info = getParagraphInfo(li);
+		if (!info.m_header.empty())
 			break;
-		bool isListItem = isLi(li);
-		if (isListItem && (startIndentationLevel > getIndentationLevel(li)))
+		bool isListItem = info.m_isLi;
+		if (isListItem && (startIndentationLevel > info.m_ilvl))
 			break;
 
-		std::string numId = getNumberingId(li);
+		const std::string& numId = info.m_numId;
 		// Not `p` tag or list item
 		if (numId.empty() || numId == "-1") {
 			liNodes.emplace_back(li);
@@ -618,32 +814,22 @@ void Docx::getListNodes(const pugi::xml_node& node, std::vector<pugi::xml_node>&
 	}
 }
 
-int Docx::getIndentationLevel(const pugi::xml_node& node) const {
-	auto ilvl = node.select_node(".//w:ilvl");
-	if (!ilvl)
-		return -1;
-	return ilvl.node().attribute("w:val").as_int();
-}
-
-bool Docx::isLi(const pugi::xml_node& node) const {
-	if (!isHeader(node).empty())
-		return false;
-	return hasIndentationLevel(node);
-}
-
-bool Docx::isTopLevel(const pugi::xml_node& node) const {
-	int ilvl = getIndentationLevel(node);
+bool Docx::isTopLevel(const std::string& numId, int ilvl) const {
 	if (ilvl != 0)
 		return false;
-	return (m_numberingMap.at(getNumberingId(node))[ilvl] == "upperRoman");
+	auto numbering = m_numberingMap.find(numId);
+	if (numbering == m_numberingMap.end() || numbering->second.empty())
+		return false;
+	return (numbering->second[ilvl] == "upperRoman");
 }
 
-bool Docx::isLastLi(const pugi::xml_node& node, const std::string& currentNumId) const {
+bool Docx::isLastLi(const pugi::xml_node& node, const std::string& currentNumId) {
 	for (auto li = node; li; li = li.next_sibling()) {
-		if (!isLi(li))
+		const auto& info = getParagraphInfo(li);
+		if (!info.m_isLi)
 			continue;
 
-		if (currentNumId != getNumberingId(li))
+		if (currentNumId != info.m_numId)
 			return true;
 		// If here, we have found another list item in current list, so `li` is not last
 		return false;
@@ -665,12 +851,6 @@ void Docx::buildNonListContent(const pugi::xml_node& xmlNode, pugi::xml_node& ht
 }
 
 // Style
-bool Docx::hasStyle(const pugi::xml_node& node, const std::string& style) const {
-	auto child = node.child(style.c_str());
-	std::string childValue = child.attribute("w:val").value();
-	return (child && childValue != "false");
-}
-
 std::string Docx::getStyleValue(const pugi::xml_node& parentNode, const std::string& nodeName,
 								const std::string& styleName) const
 {
@@ -686,108 +866,293 @@ void Docx::addTextStyle(pugi::xml_node& node, const std::string& style) const {
 		node = node.append_child(style.c_str());
 }
 
-void Docx::addStyle(const pugi::xml_node& xmlNode, pugi::xml_node& htmlNode) const {
-	std::unordered_map<std::string, std::string> parentStyleMap;
-	std::unordered_map<std::string, std::string> elementStyleMap;
-	std::string value;
+void Docx::addStyle(const pugi::xml_node& xmlNode, pugi::xml_node& htmlNode) {
 	auto node = htmlNode;
-	auto parentNode  = xmlNode.parent().child("w:pPr");
-	auto elementNode = xmlNode.child("w:rPr");
+	const Style& paragraphStyle = getParagraphStyle(xmlNode.parent());
+
+	// Run properties: paragraph style <- character style <- direct formatting (paragraph mark
+	// properties are not applied to runs)
+	auto elementNode  = xmlNode.child("w:rPr");
+	RunStyle runStyle = paragraphStyle.m_run;
+	const char* styleId = elementNode.child("w:rStyle").attribute("w:val").value();
+	if (*styleId) {
+		auto style = m_styleMap.find(styleId);
+		if (style != m_styleMap.end())
+			mergeRunStyle(style->second.m_run, runStyle);
+	}
+	readRunStyle(elementNode, runStyle);
 
 	// Add text style tags such as b/i/u/...
-	if (hasStyle(elementNode, "w:b"))
+	if (runStyle.m_isBold == 1)
 		addTextStyle(htmlNode, "b");
-	if (hasStyle(elementNode, "w:i"))
+	if (runStyle.m_isItalic == 1)
 		addTextStyle(htmlNode, "i");
-	if (hasStyle(elementNode, "w:u"))
+	if (runStyle.m_isUnderlined == 1)
 		addTextStyle(htmlNode, "u");
-	if (hasStyle(elementNode, "w:strike") || hasStyle(elementNode, "w:dstrike"))
+	if (runStyle.m_isStruckOut == 1)
 		addTextStyle(htmlNode, "s");
-
-	value = getStyleValue(elementNode, "w:vertAlign", "w:val");
-	if (value == "subscript")
+	if (runStyle.m_vertAlign == 1)
 		addTextStyle(htmlNode, "sub");
-	else if (value == "superscript")
+	else if (runStyle.m_vertAlign == 2)
 		addTextStyle(htmlNode, "sup");
 
-	// Get style for "style" attribute
-	value = getStyleValue(parentNode, "w:jc", "w:val");
-	if (!value.empty())
-		parentStyleMap["text-align"] = HORZ_ALIGN.at(value);
+	// Add parent style (once for each parent)
+	const std::string& style = paragraphStyle.m_css;
+	if (!style.empty()) {
+		auto styleAttr = node.attribute("style");
+		if (!styleAttr) {
+			node.append_attribute("style") = style.c_str();
+		}
+		else {
+			const char* value = styleAttr.value();
+			size_t size = strlen(value);
+			if (size < style.size() || style.compare(value + size - style.size()) != 0)
+				styleAttr.set_value((value + style).c_str());
+		}
+	}
 
-	value = getStyleValue(parentNode, "w:spacing", "w:before");
-	if (!value.empty() && value != "auto")
-		parentStyleMap["padding-left"] = std::to_string(stoi(value)/20) +"px";
+	// Add element style. Identical runs of paragraph share CSS string
+	if (!m_hasRunStyle || !isSameRunStyle(runStyle, m_runStyle)) {
+		m_runStyle    = runStyle;
+		m_hasRunStyle = true;
+		m_runCss.clear();
+		// Paragraph CSS is inherited by runs
+		getRunCss(runStyle, getParagraphRunStyle(paragraphStyle), m_runCss);
+	}
+	if (!m_runCss.empty()) {
+		htmlNode = htmlNode.append_child("span");
+		htmlNode.append_attribute("style") = m_runCss.c_str();
+	}
+}
 
-	value = getStyleValue(parentNode, "w:spacing", "w:after");
-	if (!value.empty() && value != "auto")
-		parentStyleMap["padding-right"] = std::to_string(stoi(value)/20) +"px";
+const Style& Docx::getParagraphStyle(const pugi::xml_node& node) {
+	if (node == m_paragraphNode)
+		return m_paragraphStyle;
+	m_paragraphNode = node;
+	m_hasRunStyle   = false;
 
-	addGeneralStyle(parentNode.child("w:rPr"), parentStyleMap);
-	addGeneralStyle(elementNode, elementStyleMap);
+	// Paragraph without style uses default one
+	auto pPr = node.child("w:pPr");
+	const char* styleId = pPr.child("w:pStyle").attribute("w:val").value();
+	if (!*styleId && strcmp(node.name(), "w:p") == 0)
+		styleId = m_defaultStyleId.c_str();
 
-	parentNode = parentNode.child("w:pBdr");
-	for (const auto& border : BORDER_LIST) {
-		std::string type  = getStyleValue(parentNode, "w:"+border, "w:val");
-		std::string color = getStyleValue(parentNode, "w:"+border, "w:color");
-		if (!type.empty()) {
-			parentStyleMap["border-"+border] = std::to_string(BORDER_SIZE.at(type)) +"px "+
-											   BORDER_TYPE.at(type) +" #"+
-											   ((color.empty() || color == "auto") ? "000" : color);
-		}
-	}
+	auto style = m_styleMap.find(styleId);
+	if (style != m_styleMap.end())
+		m_paragraphStyle = style->second;
+	else
+		m_paragraphStyle = Style();
 
-	// Add parent style
-	std::string style;
-	for (const auto& sm : parentStyleMap)
-		style += sm.first + ":" + sm.second + "; ";
-	std::string styleAttr = htmlNode.attribute("style").value();
-	if (!style.empty() &&
-		styleAttr.substr(std::max(0, (int)(styleAttr.size()-style.size()))) != style
-	) {
-		if (styleAttr.empty())
-			node.append_attribute("style") = style.c_str();
-		else
-			node.attribute("style").set_value((styleAttr + style).c_str());
+	// Direct formatting
+	if (readParagraphStyle(pPr, m_paragraphStyle)) {
+		m_paragraphStyle.m_css.clear();
+		getParagraphCss(m_paragraphStyle, m_paragraphStyle.m_css);
 	}
+	return m_paragraphStyle;
+}
 
-	// Add element style
-	style.clear();
-	for (const auto& sm : elementStyleMap) {
-		if (sm.second != parentStyleMap[sm.first])
-			style += sm.first + ":" + sm.second + "; ";
-	}
-	if (!style.empty()) {
-		htmlNode = htmlNode.append_child("span");
-		htmlNode.append_attribute("style") = style.c_str();
+bool Docx::readParagraphStyle(const pugi::xml_node& node, Style& style) {
+	bool isChanged = false;
+	for (const auto& child : node) {
+		const char* name = child.name();
+		if (strcmp(name, "w:jc") == 0) {
+			auto align = HORZ_ALIGN.find(child.attribute("w:val").value());
+			if (align != HORZ_ALIGN.end()) {
+				style.m_textAlign = align->second;
+				isChanged = true;
+			}
+		}
+		else if (strcmp(name, "w:spacing") == 0) {
+			auto before = child.attribute("w:before");
+			if (before && strcmp(before.value(), "auto") != 0) {
+				style.m_paddingLeft = before.as_int() / 20;
+				isChanged = true;
+			}
+			auto after = child.attribute("w:after");
+			if (after && strcmp(after.value(), "auto") != 0) {
+				style.m_paddingRight = after.as_int() / 20;
+				isChanged = true;
+			}
+		}
+		else if (strcmp(name, "w:pBdr") == 0) {
+			for (const auto& border : child) {
+				const char* borderName = border.name();
+				if (strncmp(borderName, "w:", 2) != 0)
+					continue;
+				auto position = find(BORDER_LIST.begin(), BORDER_LIST.end(), borderName + 2);
+				if (position == BORDER_LIST.end())
+					continue;
+
+				std::string& value = style.m_borderList[position - BORDER_LIST.begin()];
+				std::string type   = border.attribute("w:val").value();
+				std::string color  = border.attribute("w:color").value();
+				if (BORDER_SIZE.find(type) != BORDER_SIZE.end() && !type.empty()) {
+					value = std::to_string(BORDER_SIZE.at(type)) +"px "+ BORDER_TYPE.at(type) +" #"+
+							((color.empty() || color == "auto") ? "000" : color);
+				}
+				else if (type == "nil" || type == "none") {
+					value = "none";
+				}
+				else {
+					continue;
+				}
+				isChanged = true;
+			}
+		}
+		else if (strcmp(name, "w:rPr") == 0) {
+			isChanged |= readRunStyle(child, style.m_mark);
+		}
 	}
+	return isChanged;
 }
 
-void Docx::addGeneralStyle(const pugi::xml_node& node,
-						   std::unordered_map<std::string, std::string>& styleMap) const
-{
-	std::string value;
-	value = getStyleValue(node, "w:rFonts", "w:ascii");
-	if (!value.empty())
-		styleMap["font-family"] = "'"+ value +"'";
+bool Docx::readRunStyle(const pugi::xml_node& node, RunStyle& style) {
+	// Toggle property is on unless it has `false` value
+	auto getToggle = [](const pugi::xml_node& child) -> signed char {
+		const char* value = child.attribute("w:val").value();
+		return !(strcmp(value, "false") == 0 || strcmp(value, "0") == 0 ||
+				 strcmp(value, "off") == 0 || strcmp(value, "none") == 0);
+	};
+
+	bool isChanged = false;
+	for (const auto& child : node) {
+		const char* name = child.name();
+		if (strncmp(name, "w:", 2) != 0)
+			continue;
+		name += 2;
 
-	value = getStyleValue(node, "w:sz", "w:val");
-	if (!value.empty())
-		styleMap["font-size"] = std::to_string(stoi(value)/2) +"px";
+		if (strcmp(name, "b") == 0) {
+			style.m_isBold = getToggle(child);
+		}
+		else if (strcmp(name, "i") == 0) {
+			style.m_isItalic = getToggle(child);
+		}
+		else if (strcmp(name, "u") == 0) {
+			style.m_isUnderlined = getToggle(child);
+		}
+		else if (strcmp(name, "strike") == 0) {
+			style.m_isStruckOut = getToggle(child);
+		}
+		else if (strcmp(name, "dstrike") == 0) {
+			if (getToggle(child))
+				style.m_isStruckOut = 1;
+		}
+		else if (strcmp(name, "vertAlign") == 0) {
+			const char* value = child.attribute("w:val").value();
+			if (strcmp(value, "subscript") == 0)
+				style.m_vertAlign = 1;
+			else if (strcmp(value, "superscript") == 0)
+				style.m_vertAlign = 2;
+			else
+				style.m_vertAlign = 0;
+		}
+		else if (strcmp(name, "rFonts") == 0) {
+			const char* value = child.attribute("w:ascii").value();
+			if (*value)
+				style.m_fontFamily = value;
+		}
+		else if (strcmp(name, "sz") == 0) {
+			auto value = child.attribute("w:val");
+			if (*value.value())
+				style.m_fontSize = value.as_int() / 2;
+		}
+		else if (strcmp(name, "color") == 0) {
+			const char* value = child.attribute("w:val").value();
+			if (*value && strcmp(value, "auto") != 0)
+				style.m_color = value;
+		}
+		else if (strcmp(name, "shd") == 0) {
+			const char* value = child.attribute("w:fill").value();
+			if (*value && strcmp(value, "auto") != 0)
+				style.m_background = value;
+		}
+		else if (strcmp(name, "vanish") == 0) {
+			style.m_isHidden = getToggle(child);
+		}
+		else if (strcmp(name, "rtl") == 0) {
+			style.m_isRtl = getToggle(child);
+		}
+		else {
+			continue;
+		}
+		isChanged = true;
+	}
+	return isChanged;
+}
 
-	value = getStyleValue(node, "w:color", "w:val");
-	if (!value.empty() && value != "auto")
-		styleMap["color"] = "#"+ value;
+void Docx::mergeRunStyle(const RunStyle& source, RunStyle& target) {
+	if (!source.m_fontFamily.empty())
+		target.m_fontFamily = source.m_fontFamily;
+	if (source.m_fontSize != -1)
+		target.m_fontSize = source.m_fontSize;
+	if (!source.m_color.empty())
+		target.m_color = source.m_color;
+	if (!source.m_background.empty())
+		target.m_background = source.m_background;
+	if (source.m_isBold != -1)
+		target.m_isBold = source.m_isBold;
+	if (source.m_isItalic != -1)
+		target.m_isItalic = source.m_isItalic;
+	if (source.m_isUnderlined != -1)
+		target.m_isUnderlined = source.m_isUnderlined;
+	if (source.m_isStruckOut != -1)
+		target.m_isStruckOut = source.m_isStruckOut;
+	if (source.m_vertAlign != -1)
+		target.m_vertAlign = source.m_vertAlign;
+	if (source.m_isHidden != -1)
+		target.m_isHidden = source.m_isHidden;
+	if (source.m_isRtl != -1)
+		target.m_isRtl = source.m_isRtl;
+}
 
-	value = getStyleValue(node, "w:shd", "w:fill");
-	if (!value.empty() && value != "auto")
-		styleMap["background"] = "#"+ value;
+bool Docx::isSameRunStyle(const RunStyle& first, const RunStyle& second) {
+	return first.m_fontSize     == second.m_fontSize     &&
+		   first.m_isBold       == second.m_isBold       &&
+		   first.m_isItalic     == second.m_isItalic     &&
+		   first.m_isUnderlined == second.m_isUnderlined &&
+		   first.m_isStruckOut  == second.m_isStruckOut  &&
+		   first.m_vertAlign    == second.m_vertAlign    &&
+		   first.m_isHidden     == second.m_isHidden     &&
+		   first.m_isRtl        == second.m_isRtl        &&
+		   first.m_fontFamily   == second.m_fontFamily   &&
+		   first.m_color        == second.m_color        &&
+		   first.m_background   == second.m_background;
+}
 
-	if (hasStyle(node, "vanish"))
-		styleMap["display"] = "none";
+RunStyle Docx::getParagraphRunStyle(const Style& style) {
+	RunStyle runStyle = style.m_run;
+	mergeRunStyle(style.m_mark, runStyle);
+	runStyle.m_isHidden = style.m_run.m_isHidden;
+	return runStyle;
+}
+
+void Docx::getParagraphCss(const Style& style, std::string& css) {
+	if (!style.m_textAlign.empty())
+		css += "text-align:"+ style.m_textAlign +"; ";
+	if (style.m_paddingLeft != -1)
+		css += "padding-left:"+ std::to_string(style.m_paddingLeft) +"px; ";
+	if (style.m_paddingRight != -1)
+		css += "padding-right:"+ std::to_string(style.m_paddingRight) +"px; ";
+	for (size_t i = 0; i < BORDER_LIST.size(); ++i) {
+		if (!style.m_borderList[i].empty())
+			css += "border-"+ BORDER_LIST[i] +":"+ style.m_borderList[i] +"; ";
+	}
+	getRunCss(getParagraphRunStyle(style), RunStyle(), css);
+}
 
-	if (hasStyle(node, "rtl"))
-		styleMap["direction"] = "rtl";
+void Docx::getRunCss(const RunStyle& style, const RunStyle& parent, std::string& css) {
+	if (!style.m_fontFamily.empty() && style.m_fontFamily != parent.m_fontFamily)
+		css += "font-family:'"+ style.m_fontFamily +"'; ";
+	if (style.m_fontSize != -1 && style.m_fontSize != parent.m_fontSize)
+		css += "font-size:"+ std::to_string(style.m_fontSize) +"px; ";
+	if (!style.m_color.empty() && style.m_color != parent.m_color)
+		css += "color:#"+ style.m_color +"; ";
+	if (!style.m_background.empty() && style.m_background != parent.m_background)
+		css += "background:#"+ style.m_background +"; ";
+	if (style.m_isHidden == 1 && parent.m_isHidden != 1)
+		css += "display:none; ";
+	if (style.m_isRtl == 1 && parent.m_isRtl != 1)
+		css += "direction:rtl; ";
 }
 
 void Docx::addTableStyle(const pugi::xml_node& xmlNode) {
@@ -846,8 +1211,7 @@ void Docx::addCellStyle(const pugi::xml_node& xmlNode, pugi::xml_node& htmlNode)
 	std::string style;
 	for (const auto& sm : styleMap)
 		style += sm.first + ":" + sm.second + "; ";
-	if (!style.empty())
-		htmlNode.append_attribute("style") = style.c_str();
+	m_styleTable.addStyle(htmlNode, style);
 }
 
 }  // End namespace
\ No newline at end of file
@@ -4,7 +4,7 @@
  * @file      docx.hpp
  * @author    dmryutov (dmryutov@gmail.com)
  * @copyright PolicyStat (https://github.com/PolicyStat/docx2html)
- * @version   1.1
+ * @version   1.2
  * @date      12.07.2016 -- 18.10.2017
  */
 #pragma once
@@ -25,6 +25,87 @@
  */
 namespace docx {
 
+/**
+ * @struct RunStyle
+ * @brief
+ *     Compiled run (character) properties
+ * @details
+ *     Empty string or -1 means that property is not set and is inherited from parent style
+ */
+struct RunStyle {
+	/** Font family */
+	std::string m_fontFamily;
+	/** Font size (`w:sz` / 2) */
+	int m_fontSize = -1;
+	/** Text color (hex) */
+	std::string m_color;
+	/** Background color (hex) */
+	std::string m_background;
+	/** Bold text (0: off, 1: on) */
+	signed char m_isBold = -1;
+	/** Italic text (0: off, 1: on) */
+	signed char m_isItalic = -1;
+	/** Underlined text (0: off, 1: on) */
+	signed char m_isUnderlined = -1;
+	/** Struck out text (0: off, 1: on) */
+	signed char m_isStruckOut = -1;
+	/** Vertical align (0: baseline, 1: subscript, 2: superscript) */
+	signed char m_vertAlign = -1;
+	/** Hidden text (0: off, 1: on) */
+	signed char m_isHidden = -1;
+	/** Right-to-left text (0: off, 1: on) */
+	signed char m_isRtl = -1;
+};
+
+/**
+ * @struct Style
+ * @brief
+ *     Compiled paragraph properties
+ * @details
+ *     Styles from `word/styles.xml` are compiled once with fully resolved `basedOn` chain
+ */
+struct Style {
+	/** Header tag (h1, h2, ...) */
+	std::string m_header;
+	/** Text align */
+	std::string m_textAlign;
+	/** Left padding (`w:spacing w:before` / 20) */
+	int m_paddingLeft = -1;
+	/** Right padding (`w:spacing w:after` / 20) */
+	int m_paddingRight = -1;
+	/** Border values (top, left, right, bottom) */
+	std::string m_borderList[4];
+	/** Run properties of style (`w:style/w:rPr`, inherited by runs) */
+	RunStyle m_run;
+	/** Paragraph mark run properties (`w:pPr/w:rPr`, used only for paragraph CSS) */
+	RunStyle m_mark;
+	/** Precomputed CSS of all properties */
+	std::string m_css;
+};
+
+/**
+ * @struct ParagraphInfo
+ * @brief
+ *     Numbering and header properties of body element
+ * @details
+ *     Properties are read once from direct children of `w:pPr` and cached per XML-node,
+ *     so list look-aheads don't parse the same paragraph again
+ */
+struct ParagraphInfo {
+	/** Numbering id (`w:numPr/w:numId`) */
+	std::string m_numId;
+	/** Indentation level (`w:numPr/w:ilvl`, -1 if not set) */
+	int m_ilvl = -1;
+	/** `H` tag if element is header */
+	std::string m_header;
+	/** True if element is top level upper roman list item */
+	bool m_isTopLevel = false;
+	/** True if element is `li` */
+	bool m_isLi = false;
+	/** True if element was already converted */
+	bool m_isVisited = false;
+};
+
 /**
  * @class Docx
  * @brief
@@ -55,9 +136,83 @@ public:
 	 */
 	void convert(bool addStyle = true, bool extractImages = false, char mergingMode = 0) override;
 
+protected:
+	/**
+	 * @brief
+	 *     Convert `word/document.xml` block by block and write result directly to output
+	 *     (streaming mode)
+	 * @details
+	 *     Document is inflated incrementally, every top-level body element (`w:p`, `w:tbl`) is
+	 *     parsed and converted separately and written to output. Consecutive list items are
+	 *     converted together. Images are not extracted in this mode.
+	 * @param[out] output
+	 *     Output stream
+	 * @since 1.2
+	 */
+	void streamHtml(std::ostream& output) override;
+
 private:
 	/// @name General
 	/// @{
+	/**
+	 * @brief
+	 *     Convert children of `w:body` element
+	 * @param[in] bodyNode
+	 *     XML `w:body` node
+	 * @param[out] mainNode
+	 *     HTML `body` node
+	 * @since 1.2
+	 */
+	void convertBody(const pugi::xml_node& bodyNode, pugi::xml_node& mainNode);
+
+	/**
+	 * @brief
+	 *     Split `word/document.xml` into top-level body elements and convert them
+	 * @param[out] output
+	 *     Output stream
+	 * @since 1.2
+	 */
+	void streamBody(std::ostream& output);
+
+	/**
+	 * @brief
+	 *     Convert top-level body elements and write result to output (streaming mode)
+	 * @param[in] parentNode
+	 *     Parent of elements
+	 * @param[out] output
+	 *     Output stream
+	 * @since 1.2
+	 */
+	void writeBlocks(const pugi::xml_node& parentNode, std::ostream& output);
+
+	/**
+	 * @brief
+	 *     Find end of XML markup (tag, comment, CDATA section, ...)
+	 * @param[in] data
+	 *     XML-text
+	 * @param[in] start
+	 *     Position of `<`
+	 * @return
+	 *     Position after markup end (npos if markup is incomplete)
+	 * @since 1.2
+	 */
+	static size_t findTagEnd(const std::string& data, size_t start);
+
+	/**
+	 * @brief
+	 *     Check name of tag
+	 * @param[in] data
+	 *     XML-text
+	 * @param[in] start
+	 *     Position of tag name
+	 * @param[in] name
+	 *     Expected name
+	 * @return
+	 *     True if tag has given name
+	 * @since 1.2
+	 */
+	static bool isTagName(const std::string& data, size_t start, const char* name);
+
 	/**
 	 * @brief
 	 *     Get `word/numbering.xml` content
@@ -72,6 +227,9 @@ private:
 	/**
 	 * @brief
 	 *     Get `word/styles.xml` content
+	 * @details
+	 *     Every style is compiled once: properties of its `basedOn` chain are applied from base
+	 *     to derived style and CSS is precomputed.
 	 * @note
 	 *     Some things that considered lists are actually supposed
 	 *     to be `H` tags (h1, h2, ...). These can be denoted by their styleId.
@@ -91,50 +249,30 @@ private:
 
 	/**
 	 * @brief
-	 *     Check if element is header
+	 *     Get numbering and header properties of element
+	 * @details
+	 *     numId on `li` tag maps to the numbering map along side ilvl to determine what list
+	 *     should look like (unordered, digits, ...). ilvl tells at what level of indentation
+	 *     this tag is. Only real distinction between `li` and `p` tags is that `li` has
+	 *     `numPr` which holds list id and ilvl.
 	 * @param[in] node
 	 *     XML-node
 	 * @return
-	 *     `H` tag if element is header
-	 * @since 1.0
+	 *     Cached element properties
+	 * @since 1.2
 	 */
-	std::string isHeader(const pugi::xml_node& node) const;
+	ParagraphInfo& getParagraphInfo(const pugi::xml_node& node);
 
 	/**
 	 * @brief
 	 *     Check if element is natural header
-	 * @param[in] node
-	 *     XML-node
+	 * @param[in] styleId
+	 *     Paragraph style id
 	 * @return
 	 *     `H` tag if element is header
 	 * @since 1.0
 	 */
-	std::string isNaturalHeader(const pugi::xml_node& node) const;
-
-	/**
-	 * @brief
-	 *     Get numbering id
-	 * @details
-	 *     numId on `li` tag maps to the numbering map along side ilvl
-	 *     to determine what list should look like (unordered, digits, ...).
-	 * @param[in] node
-	 *     XML-node
-	 * @return
-	 *     Numbering id
-	 * @since 1.0
-	 */
-	std::string getNumberingId(const pugi::xml_node& node) const;
-
-	/**
-	 * @brief
-	 *     If element has indentation level
-	 * @param[in] node
-	 *     XML-node
-	 * @return
-	 *     True if has indentation level
-	 * @since 1.0
-	 */
-	bool hasIndentationLevel(const pugi::xml_node& node) const;
+	std::string isNaturalHeader(const char* styleId) const;
 	/// @}
 
 	/// @name Paragraph
@@ -291,35 +429,7 @@ private:
 	 *     Consecutive `li` tags list
 	 * @since 1.0
 	 */
-	void getListNodes(const pugi::xml_node& node, std::vector<pugi::xml_node>& liNodes) const;
-
-	/**
-	 * @brief
-	 *     Get indentation level
-	 * @details
-	 *     ilvl on `li` tag tells the `li` tag at what level of indentation
-	 *     this tag. This is used to determine if `li` tag nested or not.
-	 * @param[in] node
-	 *     XML-node
-	 * @return
-	 *     Indentation level
-	 * @since 1.0
-	 */
-	int getIndentationLevel(const pugi::xml_node& node) const;
-
-	/**
-	 * @brief
-	 *     Check if elent is `li`
-	 * @details
-	 *     Only real distinction between `li` and `p` tags is that `li` has
-	 *     attribute `numPr` which holds list id and ilvl (indentation level).
-	 * @param[in] node
-	 *     XML-node
-	 * @return
-	 *     If element is `li`
-	 * @since 1.0
-	 */
-	bool isLi(const pugi::xml_node& node) const;
+	void getListNodes(const pugi::xml_node& node, std::vector<pugi::xml_node>& liNodes);
 
 	/**
 	 * @brief
@@ -327,13 +437,15 @@ private:
 	 * @details
 	 *     If this list is not in the root document (indentation == 0), then it cannot be
 	 *     a top level upper roman list.
-	 * @param[in] node
-	 *     XML-node
+	 * @param[in] numId
+	 *     Numbering id
+	 * @param[in] ilvl
+	 *     Indentation level
 	 * @return
 	 *     True if list in the root document
 	 * @since 1.0
 	 */
-	bool isTopLevel(const pugi::xml_node& node) const;
+	bool isTopLevel(const std::string& numId, int ilvl) const;
 
 	/**
 	 * @brief
@@ -348,7 +460,7 @@ private:
 	 *     True if `li` is last list item
 	 * @since 1.0
 	 */
-	bool isLastLi(const pugi::xml_node& node, const std::string& currentNumId) const;
+	bool isLastLi(const pugi::xml_node& node, const std::string& currentNumId);
 
 	/**
 	 * @brief
@@ -364,19 +476,6 @@ private:
 
 	/// @name Style
 	/// @{
-	/**
-	 * @brief
-	 *     Check if `r` tag passed in is considered bold/italicized/underlined/...
-	 * @param[in] node
-	 *     XML-node
-	 * @param[in] style
-	 *     Style tag name
-	 * @return
-	 *     True if element has specified style
-	 * @since 1.0
-	 */
-	bool hasStyle(const pugi::xml_node& node, const std::string& style) const;
-
 	/**
 	 * @brief
 	 *     Get style tag attribute value
@@ -407,25 +506,115 @@ private:
 	/**
 	 * @brief
 	 *     Add style to element
+	 * @details
+	 *     Paragraph style is added to parent HTML-node, run properties which differ from
+	 *     paragraph ones are added to `span` tag
 	 * @param[in] xmlNode
 	 *     XML-node
 	 * @param[out] htmlNode
 	 *     Parent HTML-node
 	 * @since 1.0
 	 */
-	void addStyle(const pugi::xml_node& xmlNode, pugi::xml_node& htmlNode) const;
+	void addStyle(const pugi::xml_node& xmlNode, pugi::xml_node& htmlNode);
+
+	/**
+	 * @brief
+	 *     Get compiled style of paragraph (cached for last paragraph)
+	 * @param[in] node
+	 *     Paragraph XML-node
+	 * @return
+	 *     Paragraph style
+	 * @since 1.2
+	 */
+	const Style& getParagraphStyle(const pugi::xml_node& node);
 
 	/**
 	 * @brief
-	 *     Add general parent and element style
+	 *     Read paragraph properties (`w:pPr`) over existing ones
 	 * @param[in] node
 	 *     XML-node
-	 * @param[out] styleMap
-	 *     Reference to style map
-	 * @since 1.0
+	 * @param[in,out] style
+	 *     Paragraph style
+	 * @return
+	 *     True if any property was read
+	 * @since 1.2
+	 */
+	static bool readParagraphStyle(const pugi::xml_node& node, Style& style);
+
+	/**
+	 * @brief
+	 *     Read run properties (`w:rPr`) over existing ones
+	 * @param[in] node
+	 *     XML-node
+	 * @param[in,out] style
+	 *     Run style
+	 * @return
+	 *     True if any property was read
+	 * @since 1.2
+	 */
+	static bool readRunStyle(const pugi::xml_node& node, RunStyle& style);
+
+	/**
+	 * @brief
+	 *     Copy properties which are set in source style
+	 * @param[in] source
+	 *     Source style
+	 * @param[in,out] target
+	 *     Target style
+	 * @since 1.2
+	 */
+	static void mergeRunStyle(const RunStyle& source, RunStyle& target);
+
+	/**
+	 * @brief
+	 *     Compare run styles
+	 * @param[in] first
+	 *     First style
+	 * @param[in] second
+	 *     Second style
+	 * @return
+	 *     True if all properties are equal
+	 * @since 1.2
+	 */
+	static bool isSameRunStyle(const RunStyle& first, const RunStyle& second);
+
+	/**
+	 * @brief
+	 *     Get run properties of paragraph CSS
+	 * @details
+	 *     Style run properties are combined with paragraph mark ones. Hidden paragraph mark
+	 *     hides only the mark, so it is skipped
+	 * @param[in] style
+	 *     Paragraph style
+	 * @return
+	 *     Run properties
+	 * @since 1.2
+	 */
+	static RunStyle getParagraphRunStyle(const Style& style);
+
+	/**
+	 * @brief
+	 *     Get CSS of paragraph style
+	 * @param[in] style
+	 *     Paragraph style
+	 * @param[out] css
+	 *     CSS string
+	 * @since 1.2
+	 */
+	static void getParagraphCss(const Style& style, std::string& css);
+
+	/**
+	 * @brief
+	 *     Get CSS of run properties which differ from parent ones
+	 * @param[in] style
+	 *     Run style
+	 * @param[in] parent
+	 *     Parent (paragraph) run style
+	 * @param[out] css
+	 *     CSS string
+	 * @since 1.2
 	 */
-	void addGeneralStyle(const pugi::xml_node& node,
-						 std::unordered_map<std::string, std::string>& styleMap) const;
+	static void getRunCss(const RunStyle& style, const RunStyle& parent, std::string& css);
 
 	/**
 	 * @brief
@@ -461,14 +650,26 @@ private:
 
 	/** Stores how lists should look (unordered, digits, ...) */
 	std::unordered_map<std::string, std::vector<std::string>> m_numberingMap;
-	/** Some document style information */
-	std::unordered_map<std::string, std::unordered_map<std::string, std::string>> m_styleMap;
+	/** Compiled styles from `word/styles.xml` */
+	std::unordered_map<std::string, Style> m_styleMap;
+	/** Default paragraph style id */
+	std::string m_defaultStyleId;
+	/** Last paragraph XML-node (which style is cached) */
+	pugi::xml_node m_paragraphNode;
+	/** Style of last paragraph */
+	Style m_paragraphStyle;
+	/** Last run style of current paragraph */
+	RunStyle m_runStyle;
+	/** CSS of last run style (shared by identical runs) */
+	std::string m_runCss;
+	/** True if last run style is cached */
+	bool m_hasRunStyle = false;
 	/** Stores targets to links as well as targets for images */
 	std::unordered_map<std::string, std::string> m_relationshipMap;
 	/** Stores sizes of images */
 	std::unordered_map<std::string, std::pair<int, int>> m_imageSizeMap;
-	/** List of visited elements */
-	std::vector<pugi::xml_node> m_visitedNodeList;
+	/** Cached properties of body elements (key is XML-node hash) */
+	std::unordered_map<size_t, ParagraphInfo> m_paragraphInfoMap;
 	/** Stores table border style */
 	std::unordered_map<std::string, std::string> m_borderMap;
 };
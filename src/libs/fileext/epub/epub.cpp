@@ -5,9 +5,13 @@
  * @author    dmryutov (dmryutov@gmail.com)
  * @date      14.08.2017 -- 18.10.2017
  */
-#include <fstream>
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+#include <thread>
 #include <unordered_map>
 
+#include "../../arena/arena.hpp"
 #include "../../tools.hpp"
 
 #include "epub.hpp"
@@ -16,6 +20,8 @@
 namespace epub {
 
 const std::string ID_PREFIX = "file-";
+/** Default package file path (if container has no root file) */
+const std::string PACKAGE_PATH = "book.opf";
 
 // public:
 Epub::Epub(const std::string& fileName)
@@ -26,87 +32,275 @@ void Epub::convert(bool addStyle, bool extractImages, char mergingMode) {
 	m_extractImages = extractImages;
 	m_mergingMode   = mergingMode;
 
+	m_archive.reset(new ooxml::Archive(m_fileName));
+	std::string style = readPackage();
+
+	// Streaming mode (chapters are converted in `saveHtml()`)
+	if (m_streamMode) {
+		m_extractImages = false;
+		m_streamStyle   = std::move(style);
+		return;
+	}
+
 	auto htmlTag = m_htmlTree.append_child("html");
 	auto headTag = htmlTag.append_child("head");
 	auto bodyTag = htmlTag.append_child("body");
+	if (!style.empty())
+		headTag.append_child("style").append_child(pugi::node_pcdata).set_value(style.c_str());
+
+	// Only inflating runs concurrently. Chapters are parsed one by one right into result tree:
+	// parsing them into separate trees in parallel needs a deep copy into result tree, which is
+	// slower than parsing itself. Whole chapters are converted concurrently only in `streamHtml()`
+	std::vector<std::string> dataList(m_chapterList.size());
+	tools::parallelFor(m_chapterList.size(), [&](size_t i) {
+		m_archive->extractFile(m_chapterList[i].first, dataList[i]);
+	});
+
+	for (size_t i = 0; i < m_chapterList.size(); ++i) {
+		auto fileDiv = bodyTag.append_child("div");
+		fileDiv.append_attribute("id") = (ID_PREFIX + m_chapterList[i].second).c_str();
+
+		// Parse chapter right into result tree (without XML declaration and doctype, which
+		// are allowed only at document level) and unwrap its `body` tag
+		const std::string& data = dataList[i];
+		size_t start = findRootElement(data);
+		fileDiv.append_buffer(data.data() + start, data.size() - start);
+		std::string().swap(dataList[i]);
+		auto chapterNode = fileDiv.child("html");
+		auto chapterBody = chapterNode.child("body");
+		while (chapterBody.first_child())
+			fileDiv.insert_move_before(chapterBody.first_child(), chapterNode);
+		fileDiv.remove_child(chapterNode);
+
+		std::vector<pugi::xml_node> linkList;
+		std::vector<pugi::xml_node> imageList;
+		collectNodes(fileDiv, linkList, imageList);
+		updateLinks(linkList, m_chapterList[i].first);
+		if (m_extractImages)
+			updateImages(imageList, m_chapterList[i].first);
+		else
+			removeImages(imageList);
+	}
+}
+
+
+// protected:
+void Epub::streamHtml(std::ostream& output) {
+	if (!m_archive)
+		return;
+
+	// Chapters are converted in batches to keep only a few of them in memory
+	size_t batchSize = 2 * std::max(1u, std::thread::hardware_concurrency());
+	for (size_t start = 0; start < m_chapterList.size(); start += batchSize) {
+		size_t count = std::min(batchSize, m_chapterList.size() - start);
+		std::vector<std::string> htmlList(count);
+		tools::parallelFor(count, [&](size_t i) {
+			htmlList[i] = convertChapter(start + i);
+		});
+		for (const auto& html : htmlList)
+			output << html;
+	}
+}
+
+
+// private:
+std::string Epub::readPackage() {
+	std::string packagePath = getPackagePath();
 
 	pugi::xml_document tree;
-	Ooxml::extractFile(m_fileName, "book.opf", tree);
+	m_archive->extractFile(packagePath, tree);
+	auto packageNode = tree.child("package");
 
-	for (const auto& node : tree.child("package").child("manifest")) {
-		std::string fileName = node.attribute("href").value();
+	std::string style;
+	std::unordered_map<std::string, std::string> chapterMap;
+	std::vector<std::pair<std::string, std::string>> manifestChapterList;
+	for (const auto& node : packageNode.child("manifest")) {
+		// Manifest paths are relative to package file
+		std::string fileName = resolvePath(packagePath, node.attribute("href").value());
 		std::string fileId   = node.attribute("id").value();
 		std::string fileType = node.attribute("media-type").value();
 		// HTML content
 		if (fileType == "application/xhtml+xml") {
-			pugi::xml_document tree2;
-			Ooxml::extractFile(m_fileName, fileName, tree2);
-
-			auto fileDiv = bodyTag.append_child("div");
-			fileDiv.append_attribute("id") = (ID_PREFIX + fileId).c_str();
-			for (const auto& child : tree2.child("html").child("body"))
-				fileDiv.append_copy(child);
+			chapterMap[fileId] = fileName;
+			manifestChapterList.emplace_back(fileName, fileId);
 		}
 		// CSS styles
 		else if (fileType == "text/css" && m_addStyle) {
-			std::string style;
-			Ooxml::extractFile(m_fileName, fileName, style);
-
-			headTag.append_child("style").append_child(pugi::node_pcdata).set_value(style.c_str());
+			std::string data;
+			m_archive->extractFile(fileName, data);
+			style += data;
 		}
 
 		// Save id of files (new divs)
 		m_fileList[fileName] = fileId;
 	}
 
-	updateLinks();
-	updateImages();
+	// Chapters are read in spine order (manifest order if there is no spine)
+	for (const auto& node : packageNode.child("spine").children("itemref")) {
+		auto chapter = chapterMap.find(node.attribute("idref").value());
+		if (chapter != chapterMap.end())
+			m_chapterList.emplace_back(chapter->second, chapter->first);
+	}
+	if (m_chapterList.empty())
+		m_chapterList = std::move(manifestChapterList);
+
+	return style;
 }
 
+std::string Epub::getPackagePath() const {
+	pugi::xml_document tree;
+	if (m_archive->extractFile("META-INF/container.xml", tree)) {
+		auto rootNode = tree.child("container").child("rootfiles").child("rootfile");
+		std::string path = rootNode.attribute("full-path").value();
+		if (!path.empty())
+			return path;
+	}
+	return PACKAGE_PATH;
+}
 
-// private:
-void Epub::updateLinks() {
-	for (auto& linkNode : m_htmlTree.select_nodes("//a")) {
-		auto node = linkNode.node();
-		std::string link = node.attribute("href").value();
-		for (const auto& file : m_fileList) {
-			std::string path = file.first;
-			if (tools::endsWith(path, link)) {
-				node.attribute("href").set_value(("#" + ID_PREFIX + m_fileList[path]).c_str());
-				break;
-			}
-		}
+std::string Epub::convertChapter(size_t index) const {
+	std::string data;
+	m_archive->extractFile(m_chapterList[index].first, data);
+
+	// Chapter tree is freed right after it is printed (not with conversion arena)
+	arena::Arena memory;
+	arena::Scope memoryScope(memory);
+	pugi::xml_document tree;
+	tree.load_buffer_inplace(&data[0], data.size());
+	auto bodyNode = tree.child("html").child("body");
+	std::vector<pugi::xml_node> linkList;
+	std::vector<pugi::xml_node> imageList;
+	collectNodes(bodyNode, linkList, imageList);
+	updateLinks(linkList, m_chapterList[index].first);
+	removeImages(imageList);
+
+	std::ostringstream output;
+	output << "<div id=\"" << ID_PREFIX << m_chapterList[index].second << "\">";
+	for (const auto& child : bodyNode)
+		child.print(output, "", pugi::format_raw | pugi::format_no_empty_element_tags);
+	output << "</div>\n";
+	return output.str();
+}
+
+size_t Epub::findRootElement(const std::string& data) {
+	size_t pos = (data.compare(0, 3, "\xEF\xBB\xBF") == 0) ? 3 : 0;
+	while ((pos = data.find('<', pos)) != std::string::npos) {
+		const char* terminator;
+		if (data.compare(pos, 4, "<!--") == 0)
+			terminator = "-->";
+		else if (data.compare(pos, 2, "<?") == 0)
+			terminator = "?>";
+		else if (data.compare(pos, 2, "<!") == 0)
+			terminator = ">";
+		else
+			return pos;
+
+		pos = data.find(terminator, pos);
+		if (pos == std::string::npos)
+			break;
 	}
+	return data.size();
 }
 
-void Epub::updateImages() {
-	if (!m_extractImages) {
-		for (auto& imageNode : m_htmlTree.select_nodes("//img"))
-			imageNode.node().parent().remove_child(imageNode.node());
-		return;
+std::string Epub::resolvePath(const std::string& basePath, const std::string& link) {
+	// Fragment-only and external links do not refer to archive files
+	size_t end = link.find_first_of("#?");
+	if (end == std::string::npos)
+		end = link.size();
+	if (end == 0 || link.find(':') < end)
+		return "";
+
+	std::string path;
+	if (link[0] == '/') {
+		path = link.substr(1, end - 1);
+	}
+	else {
+		size_t pos = basePath.find_last_of('/');
+		if (pos != std::string::npos)
+			path = basePath.substr(0, pos + 1);
+		path.append(link, 0, end);
 	}
 
-	int imageCount = 0;
-	for (auto& imageNode : m_htmlTree.select_nodes("//img")) {
-		auto node = imageNode.node();
-		std::string link = node.attribute("src").value();
-		for (const auto& file : m_fileList) {
-			std::string path = file.first;
-			if (tools::endsWith(path, link)) {
-				// Load image
-				std::string ext = path.substr(path.find_last_of('.') + 1);
-				std::string imageData;
-				Ooxml::extractFile(m_fileName, path, imageData);
-				m_imageList.emplace_back(std::make_pair(std::move(imageData), ext));
-
-				// Update attributes
-				node.remove_attribute("src");
-				node.append_attribute("data-tag") = imageCount;
-				++imageCount;
-				break;
-			}
+	// Remove `.` and `..` segments
+	std::string result;
+	size_t start = 0;
+	while (start <= path.size()) {
+		size_t pos = path.find('/', start);
+		if (pos == std::string::npos)
+			pos = path.size();
+		size_t length = pos - start;
+		if (length == 2 && path.compare(start, 2, "..") == 0) {
+			size_t last = result.find_last_of('/');
+			result.erase(last == std::string::npos ? 0 : last);
+		}
+		else if (length != 0 && !(length == 1 && path[start] == '.')) {
+			if (!result.empty())
+				result += '/';
+			result.append(path, start, length);
 		}
+		start = pos + 1;
 	}
+	return result;
+}
+
+void Epub::collectNodes(const pugi::xml_node& root, std::vector<pugi::xml_node>& linkList,
+						std::vector<pugi::xml_node>& imageList)
+{
+	auto node = root.first_child();
+	while (node) {
+		if (node.type() == pugi::node_element) {
+			if (strcmp(node.name(), "a") == 0)
+				linkList.push_back(node);
+			else if (strcmp(node.name(), "img") == 0)
+				imageList.push_back(node);
+		}
+
+		// Depth-first traversal inside `root` subtree
+		if (node.first_child()) {
+			node = node.first_child();
+			continue;
+		}
+		while (node != root && !node.next_sibling())
+			node = node.parent();
+		if (node == root)
+			break;
+		node = node.next_sibling();
+	}
+}
+
+void Epub::updateLinks(const std::vector<pugi::xml_node>& linkList,
+					   const std::string& chapterPath) const
+{
+	for (auto node : linkList) {
+		auto file = m_fileList.find(resolvePath(chapterPath, node.attribute("href").value()));
+		if (file != m_fileList.end())
+			node.attribute("href").set_value(("#" + ID_PREFIX + file->second).c_str());
+	}
+}
+
+void Epub::updateImages(const std::vector<pugi::xml_node>& imageList,
+						const std::string& chapterPath)
+{
+	for (auto node : imageList) {
+		std::string path = resolvePath(chapterPath, node.attribute("src").value());
+		if (m_fileList.find(path) == m_fileList.end())
+			continue;
+
+		// Load image
+		std::string ext = path.substr(path.find_last_of('.') + 1);
+		std::string imageData;
+		m_archive->extractFile(path, imageData);
+
+		// Update attributes
+		node.remove_attribute("src");
+		node.append_attribute("data-tag") = static_cast<int>(m_imageList.size());
+		m_imageList.emplace_back(std::make_pair(std::move(imageData), ext));
+	}
+}
+
+void Epub::removeImages(const std::vector<pugi::xml_node>& imageList) {
+	for (auto node : imageList)
+		node.parent().remove_child(node);
 }
 
-}  // End namespace
\ No newline at end of file
+}  // End namespace
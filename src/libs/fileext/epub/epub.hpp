@@ -3,11 +3,12 @@
  * @package   epub
  * @file      epub.hpp
  * @author    dmryutov (dmryutov@gmail.com)
- * @version   1.0
+ * @version   1.1
  * @date      14.08.2017 -- 18.10.2017
  */
 #pragma once
 
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -53,23 +54,126 @@ public:
 	 */
 	void convert(bool addStyle = true, bool extractImages = false, char mergingMode = 0) override;
 
+protected:
+	/**
+	 * @brief
+	 *     Write chapters directly to output (streaming mode)
+	 * @details
+	 *     Chapters are extracted, parsed and converted to HTML strings concurrently (in batches),
+	 *     strings are written in spine order
+	 * @param[out] output
+	 *     Output stream
+	 * @since 1.1
+	 */
+	void streamHtml(std::ostream& output) override;
+
 private:
+	/**
+	 * @brief
+	 *     Read package file: chapter list (in spine order), file ids and styles
+	 * @return
+	 *     Content of CSS files
+	 * @since 1.1
+	 */
+	std::string readPackage();
+
+	/**
+	 * @brief
+	 *     Get package file path from `META-INF/container.xml`
+	 * @return
+	 *     Package file path
+	 * @since 1.1
+	 */
+	std::string getPackagePath() const;
+
+	/**
+	 * @brief
+	 *     Convert chapter to HTML string
+	 * @param[in] index
+	 *     Chapter index
+	 * @return
+	 *     HTML of chapter `div` tag
+	 * @since 1.1
+	 */
+	std::string convertChapter(size_t index) const;
+
+	/**
+	 * @brief
+	 *     Find beginning of root element (skip XML declaration, doctype and comments)
+	 * @param[in] data
+	 *     XML data
+	 * @return
+	 *     Root element position
+	 * @since 1.1
+	 */
+	static size_t findRootElement(const std::string& data);
+
+	/**
+	 * @brief
+	 *     Get normalized archive path of file which link refers to
+	 * @param[in] basePath
+	 *     Path of file which contains link
+	 * @param[in] link
+	 *     Link value (fragment is ignored)
+	 * @return
+	 *     Archive path (empty string for external and fragment-only links)
+	 * @since 1.1
+	 */
+	static std::string resolvePath(const std::string& basePath, const std::string& link);
+
+	/**
+	 * @brief
+	 *     Collect links and images of subtree
+	 * @param[in] root
+	 *     Root node of subtree
+	 * @param[out] linkList
+	 *     List of `a` tags
+	 * @param[out] imageList
+	 *     List of `img` tags
+	 * @since 1.1
+	 */
+	static void collectNodes(const pugi::xml_node& root, std::vector<pugi::xml_node>& linkList,
+							 std::vector<pugi::xml_node>& imageList);
+
 	/**
 	 * @brief
 	 *     Update links to files
+	 * @param[in] linkList
+	 *     List of `a` tags
+	 * @param[in] chapterPath
+	 *     Path of chapter which contains links
 	 * @since 1.0
 	 */
-	void updateLinks();
+	void updateLinks(const std::vector<pugi::xml_node>& linkList,
+					 const std::string& chapterPath) const;
 
 	/**
 	 * @brief
 	 *     Update links to images
+	 * @param[in] imageList
+	 *     List of `img` tags
+	 * @param[in] chapterPath
+	 *     Path of chapter which contains images
 	 * @since 1.0
 	 */
-	void updateImages();
+	void updateImages(const std::vector<pugi::xml_node>& imageList,
+					  const std::string& chapterPath);
+
+	/**
+	 * @brief
+	 *     Remove images
+	 * @param[in] imageList
+	 *     List of `img` tags
+	 * @since 1.1
+	 */
+	static void removeImages(const std::vector<pugi::xml_node>& imageList);
 
-	/** Used id of files */
+	/** Opened archive (all files are read from it) */
+	std::unique_ptr<ooxml::Archive> m_archive;
+	/** Chapter list in reading order (file path, file id) */
+	std::vector<std::pair<std::string, std::string>> m_chapterList;
+	/** Id of files (by normalized archive path) */
 	std::unordered_map<std::string, std::string> m_fileList;
 };
 
-}  // End namespace
\ No newline at end of file
+}  // End namespace
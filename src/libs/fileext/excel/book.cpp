@@ -86,17 +86,16 @@ const std::unordered_map<int, std::string> BIFF_TEXT {
 
 // Book public:
 Book::Book(const std::string& fileName, pugi::xml_node& htmlTree, bool addStyle, bool extractImages,
-		   char mergingMode, std::vector<std::pair<std::string, std::string>>& imageList)
+		   char mergingMode, std::vector<std::pair<std::string, std::string>>& imageList,
+		   fileext::StyleTable& styleTable)
 : Cfb(fileName), m_htmlTree(htmlTree), m_addStyle(addStyle), m_extractImages(extractImages),
-  m_mergingMode(mergingMode), m_imageList(imageList) {}
+  m_mergingMode(mergingMode), m_imageList(imageList), m_styleTable(styleTable) {}
 
 void Book::openWorkbookXls() {
 	// Read CFB part
 	Cfb::parse();
-	m_workBook = getStream("Workbook");
-	if (m_workBook.empty())
+	if (!openStream("Workbook", m_workBook) || m_workBook.empty())
 		return;
-	Cfb::clear();
 
 	m_biffVersion = getBiffVersion(XL_WORKBOOK_GLOBALS);
 	if (!m_biffVersion)
@@ -119,16 +118,20 @@ void Book::openWorkbookXls() {
 		m_sheetList.clear();
 		size_t sheetCount = m_sheetNames.size();
 		for (size_t i = 0; i < sheetCount; ++i)
-			getSheet(i);
+			prepareSheet(i);
+		// Every sheet has its own stream cursor and HTML tree, so they can be read in parallel
+		tools::parallelFor(sheetCount, [this](size_t i) {
+			m_sheetList[i].read();
+		});
 	}
+	joinSheetTrees();
 	m_sheetCount = m_sheetList.size();
 
 	// Release resources
 	m_workBook.clear();
 	m_sharedStrings.clear();
 	m_richtextRunlistMap.clear();
-	m_workBook.shrink_to_fit();
-	m_sharedStrings.shrink_to_fit();
+	Cfb::clear();
 }
 
 void Book::handleWriteAccess(const std::string& data) {
@@ -149,19 +152,53 @@ void Book::handleWriteAccess(const std::string& data) {
 void Book::getRecordParts(unsigned short& code, unsigned short& length,
 						  std::string& data, int condition)
 {
-	int pos = m_position;
-	code    = readByte<unsigned short>(m_workBook, pos,   2);
-	length  = readByte<unsigned short>(m_workBook, pos+2, 2);
+	getRecordParts(m_position, code, length, data, condition);
+}
+
+void Book::getRecordParts(int& position, unsigned short& code, unsigned short& length,
+						  std::string& data, int condition) const
+{
+	int pos = position;
+	m_workBook.read(pos, 4, data);
+	code    = readByte<unsigned short>(data, 0, 2);
+	length  = readByte<unsigned short>(data, 2, 2);
 
 	if (condition != -1 && code != condition) {
-		data   = "";
+		data.clear();
 		code   = 0;
 		length = 0;
 		return;
 	}
 	pos += 4;
-	data = m_workBook.substr(pos, length);
-	m_position = pos + length;
+	// Copy into existing buffer (reuses its capacity)
+	m_workBook.read(pos, length, data);
+	position = pos + length;
+}
+
+void Book::getRecord(int& position, unsigned short& code, unsigned short& length,
+					 const char*& data, size_t& dataSize, std::string& buffer) const
+{
+	size_t headerSize  = 4;
+	const char* header = m_workBook.view(position, headerSize, buffer);
+	code   = readByte<unsigned short>(header, headerSize, 0, 2);
+	length = readByte<unsigned short>(header, headerSize, 2, 2);
+
+	dataSize = length;
+	data     = m_workBook.view(position + 4, dataSize, buffer);
+	position += 4 + length;
+}
+
+pugi::xml_node Book::addSheetTree(size_t sheetIndex) {
+	m_sheetTreeList.emplace_back(new pugi::xml_document());
+	auto div = m_sheetTreeList.back()->append_child("div");
+	div.append_attribute("id") = ("tabC"+ std::to_string(sheetIndex + 1)).c_str();
+	return div.append_child("table");
+}
+
+void Book::joinSheetTrees() {
+	for (const auto& tree : m_sheetTreeList)
+		m_htmlTree.append_copy(tree->first_child());
+	m_sheetTreeList.clear();
 }
 
 void Book::getEncoding() {
@@ -288,8 +325,10 @@ std::string Book::unpackUnicodeUpdatePos(const std::string& data, int& pos,
 
 // Book private:
 int Book::getBiffVersion(int streamSign) {
-	unsigned short signature = readByte<unsigned short>(m_workBook, m_position, 2);
-	unsigned short length    = readByte<unsigned short>(m_workBook, m_position + 2, 2);
+	std::string data;
+	m_workBook.read(m_position, 4, data);
+	unsigned short signature = readByte<unsigned short>(data, 0, 2);
+	unsigned short length    = readByte<unsigned short>(data, 2, 2);
 	//int savpos  = m_position;
 	m_position += 4;
 
@@ -302,7 +341,7 @@ int Book::getBiffVersion(int streamSign) {
 		);
 
 	std::string padding(std::max(0, BOF_LENGTH.at(signature) - length), '\0');
-	std::string data = m_workBook.substr(m_position, length);
+	m_workBook.read(m_position, length, data);
 	if (data.size() < length)
 		throw std::invalid_argument("Unsupported format, or corrupt file: Incomplete BOF record[2]");
 
@@ -362,15 +401,9 @@ void Book::getFakeGlobalsSheet() {
 	Formatting formatting(this);
 	formatting.initializeBook();
 
-	// Add sheet information
-	auto div = m_htmlTree.append_child("div");
-	div.append_attribute("id") = "tabC1";
-	auto table = div.append_child("table");
-
 	m_sheetNames       = {"Sheet 1"};
 	m_sheetAbsolutePos = {0};
 	m_sheetVisibility  = {0};  // One sheet, visible
-	m_sheetList.emplace_back(Sheet(this, m_position, "Sheet 1", 0, table));
 	size_t sheetCount = m_sheetNames.size();
 	for (size_t i = 0; i < sheetCount; ++i)
 		getSheet(i);
@@ -381,10 +414,11 @@ void Book::parseGlobals() {
 	Formatting formatting(this);
 	formatting.initializeBook();
 
+	// Record buffer is reused, so reading records doesn't allocate memory
+	unsigned short code;
+	unsigned short length;
+	std::string    data;
 	while (true) {
-		unsigned short code;
-		unsigned short length;
-		std::string    data;
 		getRecordParts(code, length, data);
 
 		if (code == XL_SST)
@@ -439,17 +473,18 @@ void Book::parseGlobals() {
 }
 
 void Book::getSheet(size_t sheetId, bool shouldUpdatePos) {
+	prepareSheet(sheetId, shouldUpdatePos);
+	m_sheetList.back().read();
+}
+
+void Book::prepareSheet(size_t sheetId, bool shouldUpdatePos) {
 	if (shouldUpdatePos)
 		m_position = m_sheetAbsolutePos[sheetId];
 	getBiffVersion(XL_WORKSHEET);
 
 	// Add sheet information
-	auto div = m_htmlTree.append_child("div");
-	div.append_attribute("id") = ("tabC"+ std::to_string(sheetId+1)).c_str();
-	auto table = div.append_child("table");
-
+	auto table = addSheetTree(sheetId);
 	m_sheetList.emplace_back(Sheet(this, m_position, m_sheetNames[sheetId], sheetId, table));
-	m_sheetList.back().read();
 }
 
 void Book::handleSst(const std::string& data) {
@@ -462,7 +497,7 @@ void Book::handleSst(const std::string& data) {
 
 		if (!code)
 			break;
-		stringList.emplace_back(data);
+		stringList.emplace_back(std::move(data));
 	}
 	unpackSst(stringList, readByte<int>(data, 4, 4));
 }
@@ -662,30 +697,33 @@ void Book::initializeFormatInfo() {
 }
 
 void Book::unpackSst(const std::vector<std::string>& dataTable, int stringCount) {
-	std::string data  = dataTable[0];
+	const std::string* data = &dataTable[0];
 	int dataIndex     = 0;
 	size_t dataSize   = dataTable.size();
-	size_t dataLength = data.size();
+	size_t dataLength = data->size();
 	int pos           = 8;
+	size_t totalSize  = 0;
+	for (const auto& record : dataTable)
+		totalSize += record.size();
 	m_sharedStrings.clear();
+	m_sharedStrings.reserve(stringCount, totalSize);
 	if (m_addStyle)
 		m_richtextRunlistMap.clear();
 
 	for (int i = 0; i < stringCount; ++i) {
-		unsigned short charCount = readByte<unsigned short>(data, pos, 2);
-		char options       = data[pos + 2];
+		unsigned short charCount = readByte<unsigned short>(*data, pos, 2);
+		char options       = (*data)[pos + 2];
 		int  richTextCount = 0;
 		int  phoneticSize  = 0;
 		pos += 3;
 		if (options & 0x08) {  // Richtext
-			richTextCount = readByte<unsigned short>(data, pos, 2);
+			richTextCount = readByte<unsigned short>(*data, pos, 2);
 			pos += 2;
 		}
 		if (options & 0x04) {  // Phonetic
-			phoneticSize = readByte<int>(data, pos, 4);
+			phoneticSize = readByte<int>(*data, pos, 4);
 			pos += 4;
 		}
-		std::string result;
 		int gotChars = 0;
 		while (true) {
 			int charsNeed = charCount - gotChars;
@@ -693,24 +731,22 @@ void Book::unpackSst(const std::vector<std::string>& dataTable, int stringCount)
 			if (options & 0x01) {
 				// Uncompressed UTF-16
 				charsAvailable = std::min(((int)dataLength - pos) >> 1, charsNeed);
-				result += data.substr(pos, 2*charsAvailable);
-				result  = encoding::decode(result, "UTF-16LE");
-				pos    += 2*charsAvailable;
+				m_sharedStrings.appendUtf16(data->data() + pos, charsAvailable);
+				pos += 2*charsAvailable;
 			}
 			else {
 				// Note: this is COMPRESSED (not ASCII!) encoding!!!
 				charsAvailable = std::min((int)dataLength - pos, charsNeed);
-				result += data.substr(pos, charsAvailable);
-				result  = encoding::decode(result, "ISO-8859-1");
-				pos    += charsAvailable;
+				m_sharedStrings.appendLatin1(data->data() + pos, charsAvailable);
+				pos += charsAvailable;
 			}
 			gotChars += charsAvailable;
 			if (gotChars == charCount)
 				break;
 			dataIndex += 1;
-			data = dataTable[dataIndex];
-			dataLength = data.size();
-			options = data[0];
+			data = &dataTable.at(dataIndex);
+			dataLength = data->size();
+			options = (*data)[0];
 			pos = 1;
 		}
 
@@ -720,11 +756,11 @@ void Book::unpackSst(const std::vector<std::string>& dataTable, int stringCount)
 				if (pos == static_cast<int>(dataLength)) {
 					pos        = 0;
 					dataIndex += 1;
-					data       = dataTable[dataIndex];
-					dataLength = data.size();
+					data       = &dataTable.at(dataIndex);
+					dataLength = data->size();
 				}
-				runs.emplace_back(readByte<unsigned short>(data, pos,   2),
-								  readByte<unsigned short>(data, pos+2, 2));
+				runs.emplace_back(readByte<unsigned short>(*data, pos,   2),
+								  readByte<unsigned short>(*data, pos+2, 2));
 				pos += 4;
 			}
 			if (m_addStyle)
@@ -737,11 +773,11 @@ void Book::unpackSst(const std::vector<std::string>& dataTable, int stringCount)
 			pos -= static_cast<int>(dataLength);
 			dataIndex++;
 			if (dataIndex < static_cast<int>(dataSize)) {
-				data       = dataTable[dataIndex];
-				dataLength = data.size();
+				data       = &dataTable[dataIndex];
+				dataLength = data->size();
 			}
 		}
-		m_sharedStrings.push_back(result);
+		m_sharedStrings.finish();
 	}
 }
 
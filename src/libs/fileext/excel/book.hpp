@@ -9,14 +9,17 @@
 #pragma once
 
 #include <map>
+#include <memory>
 #include <string>
 #include <vector>
 #include <unordered_map>
 
 #include "../../pugixml/pugixml.hpp"
 #include "../cfb/cfb.hpp"
+#include "../fileext.hpp"
 
 #include "formula.hpp"
+#include "sharedstrings.hpp"
 #include "sheet.hpp"
 #include "frmt.hpp"
 
@@ -47,10 +50,13 @@ public:
 	 *     Should read and add styles to HTML-tree
 	 * @param mergingMode
 	 *     Colspan/rowspan processing mode
+	 * @param styleTable
+	 *     Shared cell style table
 	 * @since 1.0
 	 */
 	Book(const std::string& fileName, pugi::xml_node& htmlTree, bool addStyle, bool extractImages,
-		 char mergingMode, std::vector<std::pair<std::string, std::string>>& imageList);
+		 char mergingMode, std::vector<std::pair<std::string, std::string>>& imageList,
+		 fileext::StyleTable& styleTable);
 
 	/**
 	 * @brief
@@ -86,6 +92,68 @@ public:
 	void getRecordParts(unsigned short& code, unsigned short& length,
 						std::string& data, int condition = -1);
 
+	/**
+	 * @brief
+	 *     Read records parts starting from given position
+	 * @param[in,out] position
+	 *     Record start position (moved to the next record)
+	 * @param[out] code
+	 *     Record type
+	 * @param[out] length
+	 *     Record length
+	 * @param[out] data
+	 *     Record content
+	 * @param[in] condition
+	 *     Reading condition (return empty record)
+	 * @since 1.2
+	 */
+	void getRecordParts(int& position, unsigned short& code, unsigned short& length,
+						std::string& data, int condition = -1) const;
+
+	/**
+	 * @brief
+	 *     Read record starting from given position without copying its content
+	 * @details
+	 *     Content points to workbook stream data. It is copied to #buffer only if record
+	 *     spans sectors which are not adjacent in file
+	 * @param[in,out] position
+	 *     Record start position (moved to the next record)
+	 * @param[out] code
+	 *     Record type
+	 * @param[out] length
+	 *     Record length
+	 * @param[out] data
+	 *     Record content (valid until #buffer is changed)
+	 * @param[out] dataSize
+	 *     Record content size (shorter than #length at the end of stream)
+	 * @param[out] buffer
+	 *     Buffer for records which are not stored contiguously
+	 * @since 1.2
+	 */
+	void getRecord(int& position, unsigned short& code, unsigned short& length,
+				   const char*& data, size_t& dataSize, std::string& buffer) const;
+
+	/**
+	 * @brief
+	 *     Create separate HTML tree for sheet
+	 * @details
+	 *     Sheets are filled independently (possibly in parallel) and joined to the result
+	 *     HTML tree in the original order by joinSheetTrees()
+	 * @param[in] sheetIndex
+	 *     Sheet index
+	 * @return
+	 *     Sheet table node
+	 * @since 1.2
+	 */
+	pugi::xml_node addSheetTree(size_t sheetIndex);
+
+	/**
+	 * @brief
+	 *     Append all sheet trees to result HTML tree and free them
+	 * @since 1.2
+	 */
+	void joinSheetTrees();
+
 	/**
 	 * @brief
 	 *     Get encoding from stream data
@@ -169,7 +237,9 @@ public:
 	const char m_mergingMode;
 	/** List of images (binary data and extension) */
 	std::vector<std::pair<std::string, std::string>>& m_imageList;
-	/** Current position in the stream  */
+	/** Shared cell style table */
+	fileext::StyleTable& m_styleTable;
+	/** Current position in the stream (workbook globals) */
 	int m_position = 0;
 	/**
 	 * Version of BIFF (Binary Interchange File Format). Used to create the file.
@@ -179,9 +249,11 @@ public:
 	/** The number of worksheets in workbook */
 	size_t m_sheetCount;
 	/** All strings in workbook */
-	std::vector<std::string> m_sharedStrings;
+	SharedStrings m_sharedStrings;
 	/** Sheet list */
 	std::vector<Sheet> m_sheetList;
+	/** Separate HTML trees of sheets (joined to result tree in order) */
+	std::vector<std::unique_ptr<pugi::xml_document>> m_sheetTreeList;
 	/** Sheets names list */
 	std::vector<std::string> m_sheetNames;
 	/** Sheet visibility. From BOUNDSHEET record */
@@ -343,6 +415,17 @@ private:
 	 */
 	void getSheet(size_t sheetId, bool shouldUpdatePos = true);
 
+	/**
+	 * @brief
+	 *     Check sheet BOF record and create Sheet object without reading it
+	 * @param[in] sheetId
+	 *     Sheet id
+	 * @param[in] shouldUpdatePos
+	 *     Should update stream position
+	 * @since 1.2
+	 */
+	void prepareSheet(size_t sheetId, bool shouldUpdatePos = true);
+
 	/**
 	 * @brief
 	 *     Read SST (Shared Strings Table) data
@@ -433,8 +516,8 @@ private:
 	 */
 	void namesEpilogue();
 
-	/** Workbook stream content */
-	std::string m_workBook;
+	/** Workbook stream (records are read on demand from CFB sectors) */
+	cfb::Stream m_workBook;
 	/** Stream start position */
 	int m_base = 0;
 	/** Sheets absolute position in the stream */
@@ -67,7 +67,8 @@ void Excel::convert(bool addStyle, bool extractImages, char mergingMode) {
 	FileExtension::loadStyle(headTag, STYLE);
 
 	// Convert file
-	Book* book = new Book(m_fileName, mainNode, m_addStyle, m_extractImages, m_mergingMode, m_imageList);
+	Book* book = new Book(m_fileName, mainNode, m_addStyle, m_extractImages, m_mergingMode,
+						  m_imageList, m_styleTable);
 	if (m_extension == "xlsx") {
 		Xlsx xlsx(book);
 		xlsx.openWorkbookXlsx();
@@ -6,7 +6,6 @@
  * @copyright python-excel (https://github.com/python-excel/xlrd)
  * @date      02.12.2016 -- 28.01.2018
  */
-#include <regex>
 
 #include "biffh.hpp"
 
@@ -72,15 +71,6 @@ const std::unordered_map<int, std::string> STD_FORMAT_STRINGS {
 	{0x30, "##0.0E+0"},
 	{0x31, "@"}
 };
-/** Non date formats */
-const std::unordered_map<std::string, int> NON_DATE_FORMATS {
-	{"0.00E+00", 1},
-	{"##0.0E+0", 1},
-	{"General",  1},
-	{"GENERAL",  1},  // OOo Calc 1.1.4 does this
-	{"general",  1},  // pyExcelerator 0.6.3 does this
-	{"@",        1}
-};
 /** Built-in style name list */
 const std::vector<std::string> BUILIT_STYLE_NAMES {
 	"Normal",
@@ -94,21 +84,6 @@ const std::vector<std::string> BUILIT_STYLE_NAMES {
 	"Hyperlink",
 	"Followed Hyperlink"
 };
-/** Skip charecters dictionary */
-const std::unordered_map<char, int> SKIP_CHAR_DICT {
-	{' ', 1}, {'$', 1}, {')', 1}, {'(', 1},
-	{'+', 1}, {'-', 1}, {'/', 1}, {':', 1}
-};
-/** Date charecters dictionary */
-const std::unordered_map<char, int> DATE_CHAR_DICT {
-	{'y', 5}, {'Y', 5}, {'m', 5}, {'M', 5},
-	{'d', 5}, {'D', 5}, {'h', 5}, {'H', 5},
-	{'s', 5}, {'S', 5}
-};
-/** Number charecters dictionary */
-const std::unordered_map<char, int> NUMBER_CHAR_DICT = {
-	{'0', 5}, {'#', 5}, {'?', 5}
-};
 /** BIFF 5 default palette */
 const std::vector<std::vector<unsigned char>> DEFAULT_PALETTE_B5 {
 	{  0,   0,   0}, {255, 255, 255}, {255,   0,   0}, {  0, 255,   0},
@@ -157,8 +132,6 @@ const std::unordered_map<int, std::vector<std::vector<unsigned char>>> DEFAULT_P
 	{21, DEFAULT_PALETTE_B2},
 	{20, DEFAULT_PALETTE_B2}
 };
-/** Format bracketed text regex */
-const std::regex FORMAT_BRACKETED_TEXT("\\[[^\\]]*\\]");
 
 // Formatting public:
 Formatting::Formatting(Book* book)
@@ -287,8 +260,9 @@ void Formatting::handleFormat(const std::string& data, int recordType) {
 	else
 		unistrg = m_book->unpackString(data, position, 1);
 
-	int type = isDateFormattedString(unistrg) ? FDT : FGE;
-	Format format(formatKey, type, unistrg);
+	Format format(formatKey, FGE, unistrg);
+	if (format.m_numberFormat.isDate())
+		format.m_type = FDT;
 
 	m_book->m_formatMap.emplace(formatKey, format);
 	m_book->m_formatList.push_back(format);
@@ -308,17 +282,8 @@ void Formatting::handleXf(const std::string& data) {
 	xf.m_border.m_diagLineStyle     = 0;  // No line
 
 	// Fill in known standard formats, i.e. do this once before process first XF record
-	if (m_book->m_biffVersion >= 50 && !m_book->m_xfCount) {
-		for (const auto& x : STD_FORMAT_CODE_TYPES) {
-			if (m_book->m_formatMap.find(x.first) == m_book->m_formatMap.end()) {
-				// Note: many standard format codes (mostly CJK date formats) have format strings that
-				// vary by locale. Type (date or numeric) is recorded but formatString will be `None`
-				const int& type = STD_FORMAT_CODE_TYPES.at(x.first);
-				m_book->m_formatMap.emplace(x.first, Format(x.first, type,
-															STD_FORMAT_STRINGS.at(x.first)));
-			}
-		}
-	}
+	if (m_book->m_biffVersion >= 50 && !m_book->m_xfCount)
+		addStandardFormats();
 	if (m_book->m_biffVersion >= 80) {
 		xf.m_fontIndex               = m_book->readByte<unsigned short>(data, 0, 2);
 		xf.m_formatKey               = m_book->readByte<unsigned short>(data, 2, 2);
@@ -618,6 +583,20 @@ void Formatting::handleStyle(const std::string& data) {
 	m_book->m_styleNameMap[name] = {builtIn, xfIndex};
 }
 
+void Formatting::addStandardFormats() {
+	for (const auto& x : STD_FORMAT_CODE_TYPES) {
+		if (m_book->m_formatMap.find(x.first) == m_book->m_formatMap.end()) {
+			// Note: many standard format codes (mostly CJK date formats) have format strings that
+			// vary by locale. Type (date or numeric) is recorded and US English date or General
+			// format string is used instead
+			auto formatString = STD_FORMAT_STRINGS.find(x.first);
+			if (formatString == STD_FORMAT_STRINGS.end())
+				formatString = STD_FORMAT_STRINGS.find(x.second == FDT ? 0x0e : 0x00);
+			m_book->m_formatMap.emplace(x.first, Format(x.first, x.second, formatString->second));
+		}
+	}
+}
+
 void Formatting::xfEpilogue() {
 	if (!m_book->m_addStyle)
 		return;
@@ -653,51 +632,7 @@ void Formatting::paletteEpilogue() {
 }
 
 bool Formatting::isDateFormattedString(const std::string& format) {
-	int state = 0;
-	std::string str;
-	std::string ch = "\\_*";
-
-	for (const auto& c : format) {
-		if (state == 0) {
-			if (c == '"')
-				state = 1;
-			else if (find(ch.begin(), ch.end(), c) == ch.end())
-				state = 2;
-			else if (SKIP_CHAR_DICT.find(c) == SKIP_CHAR_DICT.end())
-				str += c;
-		}
-		else if (state == 1) {
-			if (c == '"')
-				state = 0;
-		}
-		// Ignore char after backslash, underscore or asterisk
-		else if (state == 2) {
-			state = 0;
-		}
-	}
-
-	str = std::regex_replace(str, FORMAT_BRACKETED_TEXT, "");
-	if (NON_DATE_FORMATS.find(str) != NON_DATE_FORMATS.end())
-		return false;
-
-	state = 0;
-	//int gotSep  = 0;
-	int dateCount = 0;
-	int numCount  = 0;
-	for (const auto& c : str) {
-		if (DATE_CHAR_DICT.find(c) == DATE_CHAR_DICT.end())
-			dateCount += DATE_CHAR_DICT.at(c);
-		else if (NUMBER_CHAR_DICT.find(c) == NUMBER_CHAR_DICT.end())
-			numCount += NUMBER_CHAR_DICT.at(c);
-		//else if (c == ';')
-		//	got_sep = 1;
-	}
-
-	if (dateCount && !numCount)
-		return true;
-	if (numCount && !dateCount)
-		return false;
-	return (dateCount > numCount);
+	return NumberFormat(format).isDate();
 }
 
 int Formatting::getNearestColorIndex(std::unordered_map<int, std::vector<unsigned char>>& colorMap,
@@ -724,6 +659,7 @@ int Formatting::getNearestColorIndex(std::unordered_map<int, std::vector<unsigne
 
 // Format public:
 Format::Format(unsigned short formatKey, unsigned char type, std::string formatString)
-: m_formatKey(formatKey), m_type(type), m_formatString(formatString) {}
+: m_formatKey(formatKey), m_type(type), m_formatString(formatString),
+  m_numberFormat(m_formatString) {}
 
 }  // End namespace
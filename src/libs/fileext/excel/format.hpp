@@ -92,6 +92,13 @@ public:
 	 */
 	void handleStyle(const std::string& data);
 
+	/**
+	 * @brief
+	 *     Add standard format codes which are not defined in workbook
+	 * @since 1.2
+	 */
+	void addStandardFormats();
+
 	/**
 	 * @brief
 	 *     Finalize XF records
@@ -110,8 +117,8 @@ public:
 	 * @brief
 	 *     Check if formatted string is date
 	 * @details
-	 *     Heuristics. Handle backslashed-escaped chars properly (`hh\hmm\mss\s` -> `23h59m59s`).
-	 *     Date formats have one or more of ymdhs (caseless) in them. Numeric formats have # and 0.
+	 *     Format is date if its first section has date or time parts (ymdhs, AM/PM, elapsed time)
+	 *     outside of quoted, escaped and bracketed text.
 	 * @param[in] format
 	 *     Formatted string
 	 * @return
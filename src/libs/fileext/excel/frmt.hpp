@@ -10,6 +10,8 @@
 
 #include <string>
 
+#include "numberformat.hpp"
+
 
 namespace excel {
 
@@ -49,6 +51,8 @@ public:
 	unsigned char m_type = FUN;
 	/** Format string */
 	std::string m_formatString;
+	/** Compiled format string */
+	NumberFormat m_numberFormat;
 };
 
 }  // End namespace
\ No newline at end of file
@@ -0,0 +1,640 @@
+/**
+ * @brief     Excel files (xls/xlsx) into HTML сonverter
+ * @package   excel
+ * @file      numberformat.cpp
+ * @author    dmryutov (dmryutov@gmail.com)
+ * @date      18.10.2026 -- 18.10.2026
+ */
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cctype>
+#include <cstring>
+
+#include "numberformat.hpp"
+
+
+namespace excel {
+
+/** Powers of 10 which fit into 64-bit unsigned integer */
+const unsigned long long POWERS_OF_10[] = {
+	1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL, 100000000ULL,
+	1000000000ULL, 10000000000ULL, 100000000000ULL, 1000000000000ULL, 10000000000000ULL,
+	100000000000000ULL, 1000000000000000ULL, 10000000000000000ULL, 100000000000000000ULL,
+	1000000000000000000ULL, 10000000000000000000ULL
+};
+/** Max scaled value which is rounded with integer arithmetic (Excel keeps 15 digits) */
+const double MAX_EXACT_VALUE = 1e15;
+/** Relative error of binary representation which is compensated while rounding (1.005 -> 1.01) */
+const double ROUNDING_EPSILON = 4e-16;
+/** Max number of decimal digits */
+const int MAX_DECIMALS = 30;
+/** Max number of fractional second digits */
+const int MAX_SUBSECOND_DIGITS = 3;
+/** Number of significant digits in General format */
+const int GENERAL_DIGITS = 15;
+/** Days from 01.01.1970 to 30.12.1899 (day 0 of 1900 date system without 29.02.1900) */
+const long long EPOCH_1900 = -25569;
+/** Days from 01.01.1970 to 01.01.1904 (day 0 of 1904 date system) */
+const long long EPOCH_1904 = -24107;
+/** First serial number which is out of date range (01.01.10000) */
+const double MAX_DATE_SERIAL = 2958466;
+/** Month names */
+const char* const MONTH_NAMES[] = {
+	"January", "February", "March", "April", "May", "June",
+	"July", "August", "September", "October", "November", "December"
+};
+/** Day of week names */
+const char* const DAY_NAMES[] = {
+	"Sunday", "Monday", "Tuesday", "Wednesday", "Thursday", "Friday", "Saturday"
+};
+
+/**
+ * @brief
+ *     Round non-negative scaled value to integer
+ * @param[in] scaled
+ *     Value multiplied by power of 10
+ * @return
+ *     Rounded value
+ */
+unsigned long long roundScaled(double scaled) {
+	auto result = static_cast<unsigned long long>(scaled);
+	if (scaled - result >= 0.5 - scaled * ROUNDING_EPSILON)
+		++result;
+	return result;
+}
+
+/**
+ * @brief
+ *     Append integer padded with zeros
+ * @param[in] value
+ *     Integer
+ * @param[in] width
+ *     Minimum number of digits
+ * @param[out] output
+ *     Output string
+ */
+void appendInteger(unsigned long long value, int width, std::string& output) {
+	char buffer[20];
+	int length = 0;
+	do {
+		buffer[length++] = static_cast<char>('0' + value % 10);
+		value /= 10;
+	} while (value);
+	if (width > length)
+		output.append(width - length, '0');
+	while (length)
+		output += buffer[--length];
+}
+
+/**
+ * @brief
+ *     Append integer digits padded with zeros and separated by thousands
+ * @param[in] digits
+ *     Integer digits (without leading zeros)
+ * @param[in] length
+ *     Number of digits
+ * @param[in] width
+ *     Minimum number of digits
+ * @param[in] hasThousands
+ *     True if thousands should be separated
+ * @param[out] output
+ *     Output string
+ */
+void appendDigits(const char* digits, int length, int width, bool hasThousands,
+				  std::string& output)
+{
+	int total   = std::max(length, width);
+	int padding = total - length;
+	for (int i = 0; i < total; ++i) {
+		if (hasThousands && i && (total - i) % 3 == 0)
+			output += ',';
+		output += (i < padding) ? '0' : digits[i - padding];
+	}
+}
+
+/**
+ * @brief
+ *     Append prefix of name
+ * @param[in] name
+ *     Month or day name
+ * @param[in] width
+ *     Number of letters in format (3: short name, 5: first letter, otherwise full name)
+ * @param[out] output
+ *     Output string
+ */
+void appendName(const char* name, int width, std::string& output) {
+	if (width == 3)
+		output.append(name, 3);
+	else if (width == 5)
+		output += name[0];
+	else
+		output += name;
+}
+
+
+// public:
+NumberFormat::NumberFormat(const std::string& formatString) {
+	if (formatString.empty())
+		return;
+
+	size_t start = 0;
+	bool isQuoted = false;
+	size_t length = formatString.size();
+	for (size_t i = 0; i <= length; ++i) {
+		if (i == length || (formatString[i] == ';' && !isQuoted)) {
+			m_sectionList.emplace_back();
+			compileSection(formatString, start, i, m_sectionList.back());
+			start = i + 1;
+			// Only positive, negative, zero and text sections are allowed
+			if (m_sectionList.size() == 4)
+				break;
+		}
+		else if (formatString[i] == '"')
+			isQuoted = !isQuoted;
+		else if (formatString[i] == '\\' && !isQuoted)
+			++i;
+	}
+}
+
+bool NumberFormat::isDate() const {
+	return !m_sectionList.empty() && m_sectionList[0].m_isDate;
+}
+
+void NumberFormat::render(double value, int dateMode, std::string& output) const {
+	if (m_sectionList.empty() || std::isnan(value) || std::isinf(value)) {
+		renderGeneral(value, output);
+		return;
+	}
+
+	// Negative values use second section (without sign), zero uses third one
+	const Section* section = &m_sectionList[0];
+	bool addMinus = value < 0;
+	if (value < 0 && m_sectionList.size() >= 2) {
+		section  = &m_sectionList[1];
+		addMinus = false;
+	}
+	else if (value == 0 && m_sectionList.size() >= 3) {
+		section = &m_sectionList[2];
+	}
+
+	if (section->m_isGeneral) {
+		renderGeneral(value, output);
+		return;
+	}
+	if (section->m_isDate) {
+		if (!renderDate(*section, value, dateMode, output))
+			renderGeneral(value, output);
+		return;
+	}
+
+	double absValue = std::fabs(value);
+	size_t start = output.size();
+	for (const auto& token : section->m_tokenList) {
+		if (token.m_type == LITERAL)
+			output += token.m_text;
+		else if (token.m_type == NUMBER)
+			renderNumber(*section, absValue, output);
+		else if (token.m_type == GENERAL)
+			renderGeneral(absValue, output);
+	}
+	// Value which is rounded to zero is shown without sign
+	if (addMinus && std::find_if(output.begin() + start, output.end(), [](char c) {
+			return c >= '1' && c <= '9';
+		}) != output.end()
+	)
+		output.insert(start, 1, '-');
+}
+
+void NumberFormat::renderGeneral(double value, std::string& output) {
+	if (value == 0) {
+		output += '0';
+		return;
+	}
+	double absValue = std::fabs(value);
+	if (absValue < 1e-4 || absValue >= MAX_EXACT_VALUE || std::isnan(value)) {
+		char buffer[32];
+		int length = snprintf(buffer, sizeof(buffer), "%.*G", GENERAL_DIGITS, value);
+		output.append(buffer, length);
+		return;
+	}
+
+	if (value < 0)
+		output += '-';
+	if (absValue == std::floor(absValue)) {
+		appendInteger(static_cast<unsigned long long>(absValue), 1, output);
+		return;
+	}
+
+	// Keep 15 significant digits: 0.1 + 0.2 -> 0.3
+	int integerDigits = static_cast<int>(std::floor(std::log10(absValue))) + 1;
+	int decimals      = GENERAL_DIGITS - integerDigits;
+	auto rounded      = static_cast<unsigned long long>(absValue * POWERS_OF_10[decimals] + 0.5);
+	appendInteger(rounded / POWERS_OF_10[decimals], 1, output);
+
+	unsigned long long fraction = rounded % POWERS_OF_10[decimals];
+	if (!fraction)
+		return;
+	while (fraction % 10 == 0) {
+		fraction /= 10;
+		--decimals;
+	}
+	output += '.';
+	appendInteger(fraction, decimals, output);
+}
+
+
+// private:
+void NumberFormat::compileSection(const std::string& format, size_t start, size_t end,
+								  Section& section)
+{
+	auto& tokenList = section.m_tokenList;
+	auto addLiteral = [&tokenList](const char* text, size_t length) {
+		if (!tokenList.empty() && tokenList.back().m_type == LITERAL)
+			tokenList.back().m_text.append(text, length);
+		else
+			tokenList.push_back({LITERAL, 0, std::string(text, length)});
+	};
+	auto isPlaceholder = [&format, end](size_t i) {
+		return i < end && (format[i] == '0' || format[i] == '#' || format[i] == '?');
+	};
+
+	bool hasDigits   = false;
+	bool hasDecimal  = false;
+	bool hasExponent = false;
+	size_t i = start;
+	while (i < end) {
+		char c     = format[i];
+		char lower = static_cast<char>(tolower(c));
+
+		// Quoted and escaped text
+		if (c == '"') {
+			size_t close = format.find('"', i + 1);
+			if (close == std::string::npos || close > end)
+				close = end;
+			addLiteral(&format[i + 1], close - i - 1);
+			i = close + 1;
+		}
+		else if (c == '\\' || c == '!') {
+			if (i + 1 < end)
+				addLiteral(&format[i + 1], 1);
+			i += 2;
+		}
+		// Space with width of next char and repeated fill char
+		else if (c == '_' || c == '*') {
+			if (c == '_')
+				addLiteral(" ", 1);
+			i += 2;
+		}
+		// Color, condition, locale/currency or elapsed time
+		else if (c == '[') {
+			size_t close = format.find(']', i + 1);
+			if (close == std::string::npos || close > end)
+				close = end;
+			if (i + 1 < close && format[i + 1] == '$') {
+				size_t dash = format.find('-', i + 2);
+				addLiteral(&format[i + 2], std::min(dash, close) - i - 2);
+			}
+			else if (i + 1 < close) {
+				char letter = static_cast<char>(tolower(format[i + 1]));
+				size_t width = close - i - 1;
+				bool isElapsed = (letter == 'h' || letter == 'm' || letter == 's');
+				for (size_t j = i + 1; j < close && isElapsed; ++j)
+					isElapsed = (tolower(format[j]) == letter);
+				if (isElapsed) {
+					TokenType type = (letter == 'h') ? ELAPSED_HOURS :
+									 (letter == 'm') ? ELAPSED_MINUTES : ELAPSED_SECONDS;
+					tokenList.push_back({type, static_cast<unsigned char>(std::min<size_t>(width, 255)), ""});
+					section.m_isDate = true;
+				}
+			}
+			i = close + 1;
+		}
+		else if (lower == 'g' && end - i >= 7 && hasPrefix(format, i, "general")) {
+			tokenList.push_back({GENERAL, 0, ""});
+			i += 7;
+		}
+		else if (c == '@') {
+			tokenList.push_back({GENERAL, 0, ""});
+			++i;
+		}
+		else if (lower == 'a' && end - i >= 5 && hasPrefix(format, i, "am/pm")) {
+			tokenList.push_back({AM_PM, 0, format.substr(i, 5)});
+			section.m_hasAmPm = section.m_isDate = true;
+			i += 5;
+		}
+		else if (lower == 'a' && end - i >= 3 && hasPrefix(format, i, "a/p")) {
+			tokenList.push_back({AM_PM, 0, format.substr(i, 3)});
+			section.m_hasAmPm = section.m_isDate = true;
+			i += 3;
+		}
+		// Date and time parts
+		else if (lower == 'y' || lower == 'm' || lower == 'd' || lower == 'h' || lower == 's') {
+			size_t width = 1;
+			while (i + width < end && tolower(format[i + width]) == lower)
+				++width;
+			TokenType type = (lower == 'y') ? YEAR : (lower == 'm') ? MONTH :
+							 (lower == 'd') ? DAY  : (lower == 'h') ? HOUR : SECOND;
+			tokenList.push_back({type, static_cast<unsigned char>(std::min<size_t>(width, 255)), ""});
+			section.m_isDate = true;
+			i += width;
+		}
+		// Fractional seconds: `ss.00`
+		else if (c == '.' && section.m_isDate && isPlaceholder(i + 1) && !tokenList.empty() &&
+				 (tokenList.back().m_type == SECOND || tokenList.back().m_type == ELAPSED_SECONDS))
+		{
+			size_t width = 0;
+			while (i + 1 + width < end && format[i + 1 + width] == '0')
+				++width;
+			width = std::min<size_t>(width, MAX_SUBSECOND_DIGITS);
+			tokenList.push_back({SUBSECOND, static_cast<unsigned char>(width), ""});
+			section.m_subsecondDigits = static_cast<int>(width);
+			i += 1 + width;
+			while (isPlaceholder(i))
+				++i;
+		}
+		// Digit placeholders
+		else if (c == '0' || c == '#' || c == '?') {
+			if (hasExponent) {
+				section.m_exponentDigits++;
+			}
+			else if (hasDecimal) {
+				section.m_maxDecimals++;
+				if (c == '0')
+					section.m_minDecimals = section.m_maxDecimals;
+			}
+			else {
+				if (!hasDigits)
+					tokenList.push_back({NUMBER, 0, ""});
+				section.m_integerPlaceholders++;
+				if (c == '0')
+					section.m_integerDigits++;
+			}
+			hasDigits = true;
+			++i;
+		}
+		else if (c == '.' && !hasDecimal && !hasExponent && (hasDigits || isPlaceholder(i + 1))) {
+			if (!hasDigits)
+				tokenList.push_back({NUMBER, 0, ""});
+			hasDigits  = true;
+			hasDecimal = true;
+			section.m_hasDecimalPoint = true;
+			++i;
+		}
+		// Thousands separator between placeholders or scaling by 1000 after them
+		else if (c == ',' && hasDigits && !hasExponent) {
+			if (!isPlaceholder(i + 1))
+				section.m_scaleCount++;
+			else if (!hasDecimal)
+				section.m_hasThousands = true;
+			++i;
+		}
+		else if (c == '%') {
+			section.m_percentCount++;
+			addLiteral("%", 1);
+			++i;
+		}
+		else if (lower == 'e' && hasDigits && !hasExponent && i + 1 < end &&
+				 (format[i + 1] == '+' || format[i + 1] == '-'))
+		{
+			hasExponent = true;
+			section.m_exponentDigits  = 0;
+			section.m_hasExponentPlus = (format[i + 1] == '+');
+			i += 2;
+		}
+		// Fractions are not supported
+		else if (c == '/' && hasDigits && !section.m_isDate) {
+			section.m_isGeneral = true;
+			++i;
+		}
+		else {
+			addLiteral(&format[i], 1);
+			++i;
+		}
+	}
+	section.m_maxDecimals = std::min(section.m_maxDecimals, MAX_DECIMALS);
+	section.m_minDecimals = std::min(section.m_minDecimals, MAX_DECIMALS);
+	resolveMinutes(section);
+}
+
+bool NumberFormat::hasPrefix(const std::string& format, size_t offset, const char* prefix) {
+	for (; *prefix; ++prefix, ++offset) {
+		if (offset >= format.size() ||
+			tolower(static_cast<unsigned char>(format[offset])) != *prefix
+		)
+			return false;
+	}
+	return true;
+}
+
+void NumberFormat::resolveMinutes(Section& section) {
+	auto& tokenList = section.m_tokenList;
+	int count = static_cast<int>(tokenList.size());
+	for (int i = 0; i < count; ++i) {
+		if (tokenList[i].m_type != MONTH || tokenList[i].m_width > 2)
+			continue;
+
+		int previous = i - 1;
+		while (previous >= 0 && tokenList[previous].m_type == LITERAL)
+			--previous;
+		int next = i + 1;
+		while (next < count && tokenList[next].m_type == LITERAL)
+			++next;
+
+		if ((previous >= 0 && (tokenList[previous].m_type == HOUR ||
+							   tokenList[previous].m_type == ELAPSED_HOURS)) ||
+			(next < count && (tokenList[next].m_type == SECOND ||
+							  tokenList[next].m_type == ELAPSED_SECONDS))
+		)
+			tokenList[i].m_type = MINUTE;
+	}
+}
+
+void NumberFormat::renderNumber(const Section& section, double value, std::string& output) {
+	for (int i = 0; i < section.m_percentCount; ++i)
+		value *= 100;
+	for (int i = 0; i < section.m_scaleCount; ++i)
+		value /= 1000;
+
+	int decimals = section.m_maxDecimals;
+	int exponent = 0;
+	if (section.m_exponentDigits >= 0 && value != 0) {
+		// Engineering notation (`##0.0E+0`) keeps exponent multiple of placeholders count
+		int step = (section.m_integerPlaceholders > section.m_integerDigits) ?
+				   std::max(section.m_integerPlaceholders, 1) : 1;
+		exponent  = static_cast<int>(std::floor(std::log10(value)));
+		exponent -= ((exponent % step) + step) % step;
+		value    /= std::pow(10.0, exponent);
+
+		// Rounding can add one more digit (9.99 -> 10.0)
+		if (decimals + step <= 19 &&
+			roundScaled(value * POWERS_OF_10[decimals]) >= POWERS_OF_10[decimals + step])
+		{
+			value    /= POWERS_OF_10[step];
+			exponent += step;
+		}
+	}
+
+	// Write integer and fraction digits into buffer
+	char digits[400];
+	int length;
+	if (decimals <= 15 && value * POWERS_OF_10[decimals] < MAX_EXACT_VALUE) {
+		unsigned long long rounded = roundScaled(value * POWERS_OF_10[decimals]);
+		char reversed[24];
+		length = 0;
+		do {
+			reversed[length++] = static_cast<char>('0' + rounded % 10);
+			rounded /= 10;
+		} while (rounded || length <= decimals);
+		for (int i = 0; i < length; ++i)
+			digits[i] = reversed[length - 1 - i];
+	}
+	else {
+		length = snprintf(digits, sizeof(digits), "%.*f", decimals, value);
+		if (decimals) {
+			// Remove decimal point
+			std::memmove(digits + length - decimals - 1, digits + length - decimals, decimals);
+			--length;
+		}
+	}
+
+	const char* fraction = digits + length - decimals;
+	int integerLength    = length - decimals;
+	// Zero integer part is shown only with `0` placeholder
+	if (integerLength == 1 && digits[0] == '0')
+		integerLength = 0;
+	appendDigits(fraction - integerLength, integerLength, section.m_integerDigits,
+				 section.m_hasThousands, output);
+
+	if (section.m_hasDecimalPoint)
+		output += '.';
+	int fractionLength = decimals;
+	while (fractionLength > section.m_minDecimals && fraction[fractionLength - 1] == '0')
+		--fractionLength;
+	output.append(fraction, fractionLength);
+
+	if (section.m_exponentDigits >= 0) {
+		output += 'E';
+		if (exponent < 0)
+			output += '-';
+		else if (section.m_hasExponentPlus)
+			output += '+';
+		appendInteger(static_cast<unsigned long long>(std::abs(exponent)),
+					  section.m_exponentDigits, output);
+	}
+}
+
+bool NumberFormat::renderDate(const Section& section, double value, int dateMode,
+							  std::string& output)
+{
+	if (value < 0 || value >= MAX_DATE_SERIAL)
+		return false;
+
+	// Time is rounded to shown precision
+	auto days = static_cast<long long>(value);
+	unsigned long long unitsPerSecond = POWERS_OF_10[section.m_subsecondDigits];
+	unsigned long long unitsPerDay    = 86400 * unitsPerSecond;
+	unsigned long long units = roundScaled((value - days) * unitsPerDay);
+	if (units >= unitsPerDay) {
+		++days;
+		units -= unitsPerDay;
+	}
+	unsigned long long seconds = units / unitsPerSecond;
+	unsigned long long elapsed = days * 86400 + seconds;
+	int hour   = static_cast<int>(seconds / 3600);
+	int minute = static_cast<int>(seconds / 60 % 60);
+	int second = static_cast<int>(seconds % 60);
+
+	// Civil date from days (Excel treats 1900 as leap year, so 29.02.1900 exists)
+	int year, month, day, weekday;
+	if (dateMode == 0 && days == 60) {
+		year    = 1900;
+		month   = 2;
+		day     = 29;
+		weekday = 3;
+	}
+	else {
+		long long z = (dateMode == 0) ? EPOCH_1900 + days + (days < 60) : EPOCH_1904 + days;
+		weekday = static_cast<int>(((z + 4) % 7 + 7) % 7);
+		if (dateMode == 0 && days < 60)
+			weekday = static_cast<int>((days + 6) % 7);
+
+		z += 719468;
+		long long era = (z >= 0 ? z : z - 146096) / 146097;
+		long long doe = z - era * 146097;
+		long long yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+		long long doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+		long long mp  = (5 * doy + 2) / 153;
+		day   = static_cast<int>(doy - (153 * mp + 2) / 5 + 1);
+		month = static_cast<int>(mp < 10 ? mp + 3 : mp - 9);
+		year  = static_cast<int>(yoe + era * 400 + (month <= 2));
+	}
+
+	for (const auto& token : section.m_tokenList) {
+		int width = token.m_width;
+		switch (token.m_type) {
+			case LITERAL:
+				output += token.m_text;
+				break;
+			case YEAR:
+				if (width <= 2)
+					appendInteger(year % 100, 2, output);
+				else
+					appendInteger(year, 4, output);
+				break;
+			case MONTH:
+				if (width <= 2)
+					appendInteger(month, width, output);
+				else
+					appendName(MONTH_NAMES[month - 1], width, output);
+				break;
+			case DAY:
+				if (width <= 2)
+					appendInteger(day, width, output);
+				else
+					appendName(DAY_NAMES[weekday], width, output);
+				break;
+			case HOUR:
+				if (section.m_hasAmPm)
+					appendInteger((hour % 12) ? hour % 12 : 12, std::min(width, 2), output);
+				else
+					appendInteger(hour, std::min(width, 2), output);
+				break;
+			case MINUTE:
+				appendInteger(minute, std::min(width, 2), output);
+				break;
+			case SECOND:
+				appendInteger(second, std::min(width, 2), output);
+				break;
+			case SUBSECOND:
+				output += '.';
+				appendInteger(units % unitsPerSecond, width, output);
+				break;
+			case ELAPSED_HOURS:
+				appendInteger(elapsed / 3600, width, output);
+				break;
+			case ELAPSED_MINUTES:
+				appendInteger(elapsed / 60, width, output);
+				break;
+			case ELAPSED_SECONDS:
+				appendInteger(elapsed, width, output);
+				break;
+			case AM_PM: {
+				size_t slash = token.m_text.find('/');
+				if (hour < 12)
+					output.append(token.m_text, 0, slash);
+				else
+					output.append(token.m_text, slash + 1, std::string::npos);
+				break;
+			}
+			case GENERAL:
+				renderGeneral(value, output);
+				break;
+			case NUMBER:
+				break;
+		}
+	}
+	return true;
+}
+
+}  // End namespace
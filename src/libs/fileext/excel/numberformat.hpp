@@ -0,0 +1,224 @@
+/**
+ * @brief     Excel files (xls/xlsx) into HTML сonverter
+ * @package   excel
+ * @file      numberformat.hpp
+ * @author    dmryutov (dmryutov@gmail.com)
+ * @version   1.0
+ * @date      18.10.2026 -- 18.10.2026
+ */
+#pragma once
+
+#include <string>
+#include <vector>
+
+
+namespace excel {
+
+/**
+ * @class NumberFormat
+ * @brief
+ *     Compiled number format string (like `#,##0.00_);[Red](#,##0.00)` or `d-mmm-yy h:mm`)
+ * @details
+ *     Format string is parsed once into sections of tokens. Rendering of a cell value only walks
+ *     tokens and writes digits into output string, so it does not allocate memory when output
+ *     string has enough capacity. Supported: General, `@`, literals (quoted, escaped, `_x`, `*x`),
+ *     `[$€-407]` currency, `0 # ?` placeholders, thousands separator and scaling commas,
+ *     percent, exponent, date and time parts, elapsed `[h] [m] [s]` time, AM/PM.
+ *     Colors and conditions are ignored, fractions are rendered as General.
+ */
+class NumberFormat {
+public:
+	/**
+	 * @brief
+	 *     Create General format
+	 * @since 1.0
+	 */
+	NumberFormat() = default;
+
+	/**
+	 * @param[in] formatString
+	 *     Format string
+	 * @since 1.0
+	 */
+	NumberFormat(const std::string& formatString);
+
+	/**
+	 * @brief
+	 *     Check if format displays date or time
+	 * @return
+	 *     True if first section contains date or time parts
+	 * @since 1.0
+	 */
+	bool isDate() const;
+
+	/**
+	 * @brief
+	 *     Render number and append it to output
+	 * @param[in] value
+	 *     Cell value (date serial number for date formats)
+	 * @param[in] dateMode
+	 *     Date mode of workbook (0: 1900-based, 1: 1904-based)
+	 * @param[out] output
+	 *     Output string
+	 * @since 1.0
+	 */
+	void render(double value, int dateMode, std::string& output) const;
+
+	/**
+	 * @brief
+	 *     Render number in General format (up to 15 significant digits)
+	 * @param[in] value
+	 *     Cell value
+	 * @param[out] output
+	 *     Output string
+	 * @since 1.0
+	 */
+	static void renderGeneral(double value, std::string& output);
+
+private:
+	/** Token types */
+	enum TokenType : unsigned char {
+		LITERAL,
+		NUMBER,
+		GENERAL,
+		YEAR,
+		MONTH,
+		DAY,
+		HOUR,
+		MINUTE,
+		SECOND,
+		SUBSECOND,
+		ELAPSED_HOURS,
+		ELAPSED_MINUTES,
+		ELAPSED_SECONDS,
+		AM_PM
+	};
+
+	/**
+	 * @struct Token
+	 * @brief
+	 *     Single format instruction
+	 */
+	struct Token {
+		/** Token type */
+		TokenType m_type;
+		/** Number of repeated letters (`mmm` -> 3) */
+		unsigned char m_width;
+		/** Literal text (or AM/PM designators separated by `/`) */
+		std::string m_text;
+	};
+
+	/**
+	 * @struct Section
+	 * @brief
+	 *     Format section (positive, negative, zero or text)
+	 */
+	struct Section {
+		/** Instruction list */
+		std::vector<Token> m_tokenList;
+		/** True if section contains date or time parts */
+		bool m_isDate = false;
+		/** True if section contains AM/PM part */
+		bool m_hasAmPm = false;
+		/** True if section can't be rendered exactly and uses General format */
+		bool m_isGeneral = false;
+		/** Minimum number of integer digits (`0` placeholders) */
+		int m_integerDigits = 0;
+		/** Number of all integer placeholders */
+		int m_integerPlaceholders = 0;
+		/** Minimum number of decimal digits (`0` placeholders) */
+		int m_minDecimals = 0;
+		/** Maximum number of decimal digits */
+		int m_maxDecimals = 0;
+		/** True if decimal point should be shown */
+		bool m_hasDecimalPoint = false;
+		/** True if thousands should be separated */
+		bool m_hasThousands = false;
+		/** Number of `%` signs (value is multiplied by 100 for each) */
+		int m_percentCount = 0;
+		/** Number of scaling commas (value is divided by 1000 for each) */
+		int m_scaleCount = 0;
+		/** Minimum number of exponent digits (-1 if format is not scientific) */
+		int m_exponentDigits = -1;
+		/** True if exponent sign is always shown (`E+`) */
+		bool m_hasExponentPlus = false;
+		/** Number of fractional second digits (`ss.00`) */
+		int m_subsecondDigits = 0;
+	};
+
+	/**
+	 * @brief
+	 *     Parse one section of format string
+	 * @param[in] format
+	 *     Format string
+	 * @param[in] start
+	 *     Section start position
+	 * @param[in] end
+	 *     Section end position
+	 * @param[out] section
+	 *     Compiled section
+	 * @since 1.0
+	 */
+	static void compileSection(const std::string& format, size_t start, size_t end,
+							   Section& section);
+
+	/**
+	 * @brief
+	 *     Check if format contains lowercase prefix at position (case-insensitive)
+	 * @param[in] format
+	 *     Format string
+	 * @param[in] offset
+	 *     Prefix position
+	 * @param[in] prefix
+	 *     Lowercase prefix
+	 * @return
+	 *     True if format contains prefix
+	 * @since 1.0
+	 */
+	static bool hasPrefix(const std::string& format, size_t offset, const char* prefix);
+
+	/**
+	 * @brief
+	 *     Replace ambiguous `m` and `mm` month parts with minutes if they are next to hour or second
+	 * @param[in,out] section
+	 *     Compiled section
+	 * @since 1.0
+	 */
+	static void resolveMinutes(Section& section);
+
+	/**
+	 * @brief
+	 *     Render non-negative number with numeric section options
+	 * @param[in] section
+	 *     Section
+	 * @param[in] value
+	 *     Non-negative value
+	 * @param[out] output
+	 *     Output string
+	 * @since 1.0
+	 */
+	static void renderNumber(const Section& section, double value, std::string& output);
+
+	/**
+	 * @brief
+	 *     Render date serial number with date section tokens
+	 * @param[in] section
+	 *     Section
+	 * @param[in] value
+	 *     Date serial number
+	 * @param[in] dateMode
+	 *     Date mode of workbook (0: 1900-based, 1: 1904-based)
+	 * @param[out] output
+	 *     Output string
+	 * @return
+	 *     False if value can't be shown as date
+	 * @since 1.0
+	 */
+	static bool renderDate(const Section& section, double value, int dateMode,
+						   std::string& output);
+
+	/** Format sections */
+	std::vector<Section> m_sectionList;
+};
+
+}  // End namespace
@@ -0,0 +1,94 @@
+/**
+ * @brief     Excel files (xls/xlsx) into HTML сonverter
+ * @package   excel
+ * @file      sharedstrings.cpp
+ * @author    dmryutov (dmryutov@gmail.com)
+ * @date      18.10.2026 -- 18.10.2026
+ */
+#include "../../encoding/encoding.hpp"
+
+#include "sharedstrings.hpp"
+
+
+namespace excel {
+
+/** Unicode replacement character (for unpaired surrogates) */
+const unsigned int REPLACEMENT_CHARACTER = 0xFFFD;
+
+// public:
+void SharedStrings::clear() {
+	std::string().swap(m_data);
+	std::vector<size_t>().swap(m_offsetList);
+	m_start         = 0;
+	m_highSurrogate = 0;
+}
+
+void SharedStrings::reserve(size_t count, size_t size) {
+	m_offsetList.reserve(count);
+	m_data.reserve(size + count);
+}
+
+void SharedStrings::add(const std::string& value) {
+	m_data += value;
+	finish();
+}
+
+void SharedStrings::appendLatin1(const char* data, size_t count) {
+	for (size_t i = 0; i < count; ++i) {
+		if (static_cast<signed char>(data[i]) >= 0)
+			m_data += data[i];
+		else
+			encoding::appendUtf8(m_data, static_cast<unsigned char>(data[i]));
+	}
+}
+
+void SharedStrings::appendUtf16(const char* data, size_t count) {
+	auto bytes = reinterpret_cast<const unsigned char*>(data);
+	for (size_t i = 0; i < count; ++i) {
+		unsigned int code = bytes[2*i] | (bytes[2*i + 1] << 8);
+		if (code >= 0xD800 && code <= 0xDBFF) {
+			if (m_highSurrogate)
+				encoding::appendUtf8(m_data, REPLACEMENT_CHARACTER);
+			m_highSurrogate = code;
+			continue;
+		}
+		if (code >= 0xDC00 && code <= 0xDFFF) {
+			if (m_highSurrogate)
+				code = 0x10000 + ((m_highSurrogate - 0xD800) << 10) + (code - 0xDC00);
+			else
+				code = REPLACEMENT_CHARACTER;
+			m_highSurrogate = 0;
+		}
+		else if (m_highSurrogate) {
+			encoding::appendUtf8(m_data, REPLACEMENT_CHARACTER);
+			m_highSurrogate = 0;
+		}
+
+		if (code < 0x80)
+			m_data += static_cast<char>(code);
+		else
+			encoding::appendUtf8(m_data, code);
+	}
+}
+
+void SharedStrings::finish() {
+	if (m_highSurrogate) {
+		encoding::appendUtf8(m_data, REPLACEMENT_CHARACTER);
+		m_highSurrogate = 0;
+	}
+	m_offsetList.push_back(m_start);
+	m_data += '\0';
+	m_start = m_data.size();
+}
+
+size_t SharedStrings::size() const {
+	return m_offsetList.size();
+}
+
+const char* SharedStrings::operator[](size_t index) const {
+	if (index >= m_offsetList.size())
+		return "";
+	return m_data.c_str() + m_offsetList[index];
+}
+
+}  // End namespace
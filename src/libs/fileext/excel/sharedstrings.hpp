@@ -0,0 +1,117 @@
+/**
+ * @brief     Excel files (xls/xlsx) into HTML сonverter
+ * @package   excel
+ * @file      sharedstrings.hpp
+ * @author    dmryutov (dmryutov@gmail.com)
+ * @version   1.0
+ * @date      18.10.2026 -- 18.10.2026
+ */
+#pragma once
+
+#include <string>
+#include <vector>
+
+
+namespace excel {
+
+/**
+ * @class SharedStrings
+ * @brief
+ *     Shared strings table (SST) stored in one contiguous UTF-8 buffer
+ * @details
+ *     Strings are kept one after another and separated by null character, table stores only
+ *     start offset of each string. String is built by appending decoded chunks (it may be split
+ *     between CONTINUE records) and is closed by @ref finish.
+ */
+class SharedStrings {
+public:
+	/**
+	 * @brief
+	 *     Remove all strings and release memory
+	 * @since 1.0
+	 */
+	void clear();
+
+	/**
+	 * @brief
+	 *     Reserve memory for strings
+	 * @param[in] count
+	 *     Expected string count
+	 * @param[in] size
+	 *     Expected size of all strings in bytes
+	 * @since 1.0
+	 */
+	void reserve(size_t count, size_t size);
+
+	/**
+	 * @brief
+	 *     Add UTF-8 string to table
+	 * @param[in] value
+	 *     String value
+	 * @since 1.0
+	 */
+	void add(const std::string& value);
+
+	/**
+	 * @brief
+	 *     Append compressed (ISO-8859-1) characters to current string
+	 * @param[in] data
+	 *     Characters
+	 * @param[in] count
+	 *     Character count
+	 * @since 1.0
+	 */
+	void appendLatin1(const char* data, size_t count);
+
+	/**
+	 * @brief
+	 *     Append UTF-16LE characters to current string
+	 * @details
+	 *     Surrogate pair may be split between calls
+	 * @param[in] data
+	 *     Characters
+	 * @param[in] count
+	 *     Character count (number of 16-bit units)
+	 * @since 1.0
+	 */
+	void appendUtf16(const char* data, size_t count);
+
+	/**
+	 * @brief
+	 *     Add current string to table
+	 * @since 1.0
+	 */
+	void finish();
+
+	/**
+	 * @brief
+	 *     Get string count
+	 * @return
+	 *     Number of strings
+	 * @since 1.0
+	 */
+	size_t size() const;
+
+	/**
+	 * @brief
+	 *     Get string by index
+	 * @param[in] index
+	 *     String index
+	 * @return
+	 *     Null-terminated UTF-8 string (empty if index is out of range)
+	 * @since 1.0
+	 */
+	const char* operator[](size_t index) const;
+
+private:
+	/** Strings separated by null character */
+	std::string m_data;
+	/** Start offsets of strings */
+	std::vector<size_t> m_offsetList;
+	/** Start offset of current string */
+	size_t m_start = 0;
+	/** High surrogate waiting for its pair */
+	unsigned int m_highSurrogate = 0;
+};
+
+}  // End namespace
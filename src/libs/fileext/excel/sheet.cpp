@@ -135,7 +135,8 @@ const std::unordered_map<int, std::vector<std::string>> TABLE_COLOR {
 
 
 // public:
-Sheet::Sheet(Book* book, int position, const std::string& name, size_t number, pugi::xml_node& table)
+Sheet::Sheet(Book* book, int position, const std::string& name, size_t number,
+			 const pugi::xml_node& table)
 : m_book(book), m_table(table), m_name(name), m_number(number),
   m_maxRowCount((m_book->m_biffVersion >= 80) ? 65536 : 16384), m_position(position) {}
 
@@ -145,33 +146,40 @@ void Sheet::read() {
 	std::unordered_map<unsigned short, MSTxo> msTxos;
 	bool eofFound = false;
 	int savedObjectId;
-	int oldPosition = m_book->m_position;
-	m_book->m_position = m_position;
+	// Cell records are decoded in place. Other records are copied into reused buffer
+	unsigned short code;
+	unsigned short size;
+	const char*    record;
+	size_t         recordSize;
+	std::string    data;
 	while (true) {
-		unsigned short code;
-		unsigned short size;
-		std::string    data;
-		m_book->getRecordParts(code, size, data);
+		m_book->getRecord(m_position, code, size, record, recordSize, data);
+		if (record != data.data() && code != XL_NUMBER && code != XL_LABELSST &&
+			code != XL_RK && code != XL_MULRK && code != XL_ROW && code != XL_BLANK &&
+			code != XL_MULBLANK && code != XL_BOOLERR)
+		{
+			data.assign(record, recordSize);
+		}
 		if (code == XL_NUMBER) {
 			// [:14] in following stmt ignores extraneous rubbish at end of record
-			unsigned short rowIndex = m_book->readByte<unsigned short>(data, 0, 2);
-			unsigned short colIndex = m_book->readByte<unsigned short>(data, 2, 2);
-			unsigned short xfIndex  = m_book->readByte<unsigned short>(data, 4, 2);
-			double d = m_book->readByte<double>(data, 6, 8);
+			unsigned short rowIndex = m_book->readByte<unsigned short>(record, recordSize, 0, 2);
+			unsigned short colIndex = m_book->readByte<unsigned short>(record, recordSize, 2, 2);
+			unsigned short xfIndex  = m_book->readByte<unsigned short>(record, recordSize, 4, 2);
+			double d = m_book->readByte<double>(record, recordSize, 6, 8);
 
-			putCell(rowIndex, colIndex, std::to_string(d), xfIndex);
+			putNumber(rowIndex, colIndex, d, xfIndex);
 		}
 		else if (code == XL_LABELSST) {
-			unsigned short rowIndex = m_book->readByte<unsigned short>(data, 0, 2);
-			unsigned short colIndex = m_book->readByte<unsigned short>(data, 2, 2);
-			unsigned short xfIndex  = m_book->readByte<unsigned short>(data, 4, 2);
-			int sstIndex = m_book->readByte<int>(data, 6, 4);
+			unsigned short rowIndex = m_book->readByte<unsigned short>(record, recordSize, 0, 2);
+			unsigned short colIndex = m_book->readByte<unsigned short>(record, recordSize, 2, 2);
+			unsigned short xfIndex  = m_book->readByte<unsigned short>(record, recordSize, 4, 2);
+			int sstIndex = m_book->readByte<int>(record, recordSize, 6, 4);
 
 			putCell(rowIndex, colIndex, m_book->m_sharedStrings[sstIndex], xfIndex);
 			if (isSstRichtext) {
-				auto& runlist = m_book->m_richtextRunlistMap[sstIndex];
-				if (!runlist.empty())
-					m_richtextRunlistMap[{rowIndex, colIndex}] = runlist;
+				auto runlist = m_book->m_richtextRunlistMap.find(sstIndex);
+				if (runlist != m_book->m_richtextRunlistMap.end() && !runlist->second.empty())
+					m_richtextRunlistMap[{rowIndex, colIndex}] = runlist->second;
 			}
 		}
 		else if (code == XL_LABEL) {
@@ -222,34 +230,35 @@ void Sheet::read() {
 			m_richtextRunlistMap[{rowIndex, colIndex}] = runlist;
 		}
 		else if (code == XL_RK) {
-			unsigned short rowIndex = m_book->readByte<unsigned short>(data, 0, 2);
-			unsigned short colIndex = m_book->readByte<unsigned short>(data, 2, 2);
-			unsigned short xfIndex  = m_book->readByte<unsigned short>(data, 4, 2);
-			double d = unpackRK(data.substr(6, 4));
+			unsigned short rowIndex = m_book->readByte<unsigned short>(record, recordSize, 0, 2);
+			unsigned short colIndex = m_book->readByte<unsigned short>(record, recordSize, 2, 2);
+			unsigned short xfIndex  = m_book->readByte<unsigned short>(record, recordSize, 4, 2);
+			double d = unpackRK(record, recordSize, 6);
 
-			putCell(rowIndex, colIndex, std::to_string(d), xfIndex);
+			putNumber(rowIndex, colIndex, d, xfIndex);
 		}
 		else if (code == XL_MULRK) {
-			unsigned short rowIndex = m_book->readByte<unsigned short>(data, 0, 2);
-			unsigned short firstCol = m_book->readByte<unsigned short>(data, 2, 2);
-			unsigned short lastCol  = m_book->readByte<unsigned short>(data, (int)data.size()-2, 2);
+			unsigned short rowIndex = m_book->readByte<unsigned short>(record, recordSize, 0, 2);
+			unsigned short firstCol = m_book->readByte<unsigned short>(record, recordSize, 2, 2);
+			unsigned short lastCol  = m_book->readByte<unsigned short>(record, recordSize,
+																	   recordSize - 2, 2);
 			int pos = 4;
 
 			for (int i = firstCol; i <= lastCol; ++i) {
-				unsigned short xfIndex = m_book->readByte<unsigned short>(data, pos, 2);
-				double d = unpackRK(data.substr(pos+2, 4));
+				unsigned short xfIndex = m_book->readByte<unsigned short>(record, recordSize, pos, 2);
+				double d = unpackRK(record, recordSize, pos + 2);
 				pos += 6;
 
-				putCell(rowIndex, i, std::to_string(d), xfIndex);
+				putNumber(rowIndex, i, d, xfIndex);
 			}
 		}
 		else if (code == XL_ROW) {
 			if (!m_book->m_addStyle)
 				continue;
 
-			unsigned short rowIndex = m_book->readByte<unsigned short>(data, 0, 2);
-			unsigned short flag1    = m_book->readByte<unsigned short>(data, 6, 2);
-			int flag2 = m_book->readByte<int>(data, 12, 4);
+			unsigned short rowIndex = m_book->readByte<unsigned short>(record, recordSize, 0, 2);
+			unsigned short flag1    = m_book->readByte<unsigned short>(record, recordSize, 6, 2);
+			int flag2 = m_book->readByte<int>(record, recordSize, 12, 4);
 			if (!(0 <= rowIndex && rowIndex < m_maxRowCount))
 				continue;
 
@@ -317,7 +326,7 @@ void Sheet::read() {
 					unsigned short size2;
 					std::string    data2;
 
-					m_book->getRecordParts(code2, size2, data2);
+					m_book->getRecordParts(m_position, code2, size2, data2);
 					if (code2 == XL_STRING || code2 == XL_STRING_B2)
 						gotString = true;
 					else if (find(XL_SHRFMLA_ETC.begin(), XL_SHRFMLA_ETC.end(), code2) == XL_SHRFMLA_ETC.end())
@@ -328,7 +337,7 @@ void Sheet::read() {
 
 					// Now for the STRING record
 					if (!gotString) {
-						m_book->getRecordParts(code2, size2, data2);
+						m_book->getRecordParts(m_position, code2, size2, data2);
 						if (code2 != XL_STRING && code2 != XL_STRING_B2)
 							throw std::logic_error(
 								"Expected STRING record; found " +
@@ -360,15 +369,15 @@ void Sheet::read() {
 			// It is a number
 			else {
 				double d = m_book->readByte<double>(result, 0, 8);
-				putCell(rowIndex, colIndex, std::to_string(d), xfIndex);
+				putNumber(rowIndex, colIndex, d, xfIndex);
 			}
 		}
 		else if (code == XL_BOOLERR) {
-			unsigned short rowIndex = m_book->readByte<unsigned short>(data, 0, 2);
-			unsigned short colIndex = m_book->readByte<unsigned short>(data, 2, 2);
-			unsigned short xfIndex  = m_book->readByte<unsigned short>(data, 4, 2);
-			unsigned char value     = m_book->readByte<unsigned char>(data, 6, 1);
-			//unsigned char hasError  = m_book->readByte<unsigned char>(data, 7, 1);
+			unsigned short rowIndex = m_book->readByte<unsigned short>(record, recordSize, 0, 2);
+			unsigned short colIndex = m_book->readByte<unsigned short>(record, recordSize, 2, 2);
+			unsigned short xfIndex  = m_book->readByte<unsigned short>(record, recordSize, 4, 2);
+			unsigned char value     = m_book->readByte<unsigned char>(record, recordSize, 6, 1);
+			//unsigned char hasError  = m_book->readByte<unsigned char>(record, recordSize, 7, 1);
 			// Note: OOo Calc 2.0 writes 9-byte BOOLERR records. OOo docs say 8. Excel writes 8
 			//int cellType = hasError ? XL_CELL_ERROR : XL_CELL_BOOLEAN;
 			putCell(rowIndex, colIndex, std::string(1, value), xfIndex);
@@ -428,9 +437,9 @@ void Sheet::read() {
 			if (!m_book->m_addStyle)
 				continue;
 
-			unsigned short rowIndex = m_book->readByte<unsigned short>(data, 0, 2);
-			unsigned short colIndex = m_book->readByte<unsigned short>(data, 2, 2);
-			unsigned short xfIndex  = m_book->readByte<unsigned short>(data, 4, 2);
+			unsigned short rowIndex = m_book->readByte<unsigned short>(record, recordSize, 0, 2);
+			unsigned short colIndex = m_book->readByte<unsigned short>(record, recordSize, 2, 2);
+			unsigned short xfIndex  = m_book->readByte<unsigned short>(record, recordSize, 4, 2);
 
 			putCell(rowIndex, colIndex, "", xfIndex);
 		}
@@ -440,7 +449,7 @@ void Sheet::read() {
 
 			std::vector<unsigned short> result;
 			for (int i = 0; i < (size >> 1); ++i)
-				result.emplace_back(m_book->readByte<unsigned short>(data, 0 + i*2, 2));
+				result.emplace_back(m_book->readByte<unsigned short>(record, recordSize, 0 + i*2, 2));
 
 			auto mul_last = result.back();
 			int pos = 2;
@@ -511,13 +520,13 @@ void Sheet::read() {
 			unsigned short code2;
 
 			while (true) {
-				m_book->getRecordParts(code2, size, data);
+				m_book->getRecordParts(m_position, code2, size, data);
 				if (code2 == XL_EOF)
 					break;
 			}
 		}
-		else if (code == XL_COUNTRY) {
-			// Handle country
+		else if (code == XL_COUNTRY && m_book->m_biffVersion <= 45) {
+			// Handle country (sheets are read in parallel since BIFF 5, so book is not changed)
 			m_book->m_countries = {
 				m_book->readByte<unsigned short>(data, 0, 2),
 				m_book->readByte<unsigned short>(data, 2, 2)
@@ -761,7 +770,7 @@ void Sheet::read() {
 				std::string cellAttributes = m_book->readByte<std::string>(data, 4, 3);
 				double d = m_book->readByte<unsigned short>(data, 7, 4);
 
-				putCell(rowIndex, colIndex, std::to_string(d), fixedXfIndexB2(cellAttributes));
+				putNumber(rowIndex, colIndex, d, fixedXfIndexB2(cellAttributes));
 			}
 			else if (code == XL_INTEGER) {
 				unsigned short rowIndex    = m_book->readByte<unsigned short>(data, 0, 2);
@@ -769,7 +778,7 @@ void Sheet::read() {
 				std::string cellAttributes = m_book->readByte<std::string>(data, 4, 3);
 				float d = m_book->readByte<unsigned short>(data, 7, 2);
 
-				putCell(rowIndex, colIndex, std::to_string(d), fixedXfIndexB2(cellAttributes));
+				putNumber(rowIndex, colIndex, d, fixedXfIndexB2(cellAttributes));
 			}
 			else if (code == XL_LABEL_B2) {
 				unsigned short rowIndex    = m_book->readByte<unsigned short>(data, 0, 2);
@@ -912,10 +921,13 @@ void Sheet::read() {
 							   " ("+ m_name + ") missing EOF record");
 	tidyDimensions();
 	updateCookedFactors();
-	m_book->m_position = oldPosition;
 }
 
 void Sheet::putCell(int rowIndex, int colIndex, const std::string& value, int xfIndex) {
+	putCell(rowIndex, colIndex, value.c_str(), xfIndex);
+}
+
+void Sheet::putCell(int rowIndex, int colIndex, const char* value, int xfIndex) {
 	int rowCount = rowIndex + 1;
 	int colCount = colIndex + 1;
 	if (colCount > m_colCount) {
@@ -966,7 +978,23 @@ void Sheet::putCell(int rowIndex, int colIndex, const std::string& value, int xf
 			node = node.append_child("sub");
 	}
 
-	node.append_child(pugi::node_pcdata).set_value(value.c_str());
+	node.append_child(pugi::node_pcdata).set_value(value);
+}
+
+void Sheet::putNumber(int rowIndex, int colIndex, double value, int xfIndex) {
+	m_numberBuffer.clear();
+	const NumberFormat* numberFormat = nullptr;
+	if (m_book->m_addStyle && xfIndex >= 0 && xfIndex < static_cast<int>(m_book->m_xfList.size())) {
+		auto format = m_book->m_formatMap.find(m_book->m_xfList[xfIndex].m_formatKey);
+		if (format != m_book->m_formatMap.end())
+			numberFormat = &format->second.m_numberFormat;
+	}
+
+	if (numberFormat)
+		numberFormat->render(value, m_book->m_dateMode, m_numberBuffer);
+	else
+		NumberFormat::renderGeneral(value, m_numberBuffer);
+	putCell(rowIndex, colIndex, m_numberBuffer, xfIndex);
 }
 
 void Sheet::tidyDimensions() {
@@ -1074,7 +1102,7 @@ std::string Sheet::stringRecordContent(const std::string& data) {
 		unsigned short code;
 		unsigned short unusedLength;
 		std::string    data;
-		m_book->getRecordParts(code, unusedLength, data);
+		m_book->getRecordParts(m_position, code, unusedLength, data);
 		if (code != XL_CONTINUE)
 			throw std::logic_error("Expected CONTINUE record; found record-type "+ std::to_string(code));
 		offset = 0;
@@ -1360,7 +1388,7 @@ void Sheet::handleMSTxo(const std::string& data, MSTxo& msTxo) {
 		unsigned short code2;
 		unsigned short size2;
 		std::string    data2;
-		m_book->getRecordParts(code2, size2, data2);
+		m_book->getRecordParts(m_position, code2, size2, data2);
 
 		char nb = data2[0];  // 0 means latin1, 1 means utf_16_le
 		int charCount = size2 - 1;
@@ -1377,7 +1405,7 @@ void Sheet::handleMSTxo(const std::string& data, MSTxo& msTxo) {
 		unsigned short code2;
 		unsigned short size2;
 		std::string    data2;
-		m_book->getRecordParts(code2, size2, data2);
+		m_book->getRecordParts(m_position, code2, size2, data2);
 
 		for (int pos = 0; pos < size2; pos += 8) {
 			msTxo.m_richtextRunlist.emplace_back(m_book->readByte<unsigned short>(data2, pos,   2),
@@ -1409,7 +1437,7 @@ void Sheet::handleNote(const std::string& data, std::unordered_map<unsigned shor
 			unsigned short code2;
 			unsigned short size2;
 			std::string    data2;
-			m_book->getRecordParts(code2, size2, data2);
+			m_book->getRecordParts(m_position, code2, size2, data2);
 
 			nb = m_book->readByte<unsigned short>(data2, 4, 2);
 			note.m_text += data2.substr(6);
@@ -1498,22 +1526,23 @@ void Sheet::unpackCellRangeAddressListUpdatePos(std::vector<std::vector<int>>& o
 	}
 }
 
-double Sheet::unpackRK(const std::string& data) const {
-	char flags = data[0];
+double Sheet::unpackRK(const char* data, size_t dataSize, size_t offset) const {
+	int value  = m_book->readByte<int>(data, dataSize, offset, 4);
+	char flags = data[offset];
 	// There's a SIGNED 30-bit integer in there
 	if (flags & 2) {
-		int i = m_book->readByte<int>(data, 0, 4);
-		i >>= 2;  // Div by 4 to drop the 2 flag bits
+		int i = value >> 2;  // Div by 4 to drop the 2 flag bits
 		if (flags & 1)
 			return i / 100.0;
 		return i;
 	}
 	// It's the most significant 30 bits of IEEE 754 64-bit FP number
 	else {
-		double d = m_book->readByte<double>(
-			std::string(4, '\0') + (char)(flags & 252) + data.substr(1, 3),
-			0, 8
-		);
+		char bytes[8] = {};
+		bytes[4] = static_cast<char>(flags & 252);
+		std::copy(data + offset + 1, data + offset + std::min<size_t>(dataSize - offset, 4),
+				  bytes + 5);
+		double d = m_book->readByte<double>(bytes, sizeof(bytes), 0, 8);
 		if (flags & 1)
 			return d / 100.0;
 		return d;
@@ -1598,12 +1627,13 @@ void Sheet::addCellStyle(pugi::xml_node& node, const XF& xf, int rowIndex, int c
 		if (!sm.second.empty())
 			style += sm.first + ":" + sm.second + "; ";
 	}
-	if (!style.empty()) {
-		if (node.attribute("style"))
-			node.attribute("style").set_value((style + node.attribute("style").value()).c_str());
-		else
-			node.append_attribute("style") = style.c_str();
+	// Join with column style
+	auto colStyle = node.attribute("style");
+	if (colStyle) {
+		style += colStyle.value();
+		node.remove_attribute(colStyle);
 	}
+	m_book->m_styleTable.addStyle(node, style);
 }
 
 void Sheet::addRowStyle(pugi::xml_node& node, int rowIndex) {
@@ -1646,9 +1676,10 @@ std::string Sheet::getColor(const XFColor& color) const {
 		result = color.m_rgb;
 	}
 	else {
-		result = m_book->m_colorMap[color.m_index];
-		if (result.empty())
+		auto it = m_book->m_colorMap.find(color.m_index);
+		if (it == m_book->m_colorMap.end() || it->second.empty())
 			return "";
+		result = it->second;
 	}
 
 	if (color.m_tint < 0) {
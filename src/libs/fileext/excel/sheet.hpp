@@ -145,7 +145,7 @@ public:
 	 * @since 1.0
 	 */
 	Sheet(Book* book, int position, const std::string& name,
-		  size_t number, pugi::xml_node& table);
+		  size_t number, const pugi::xml_node& table);
 
 	/**
 	 * @brief
@@ -169,6 +169,36 @@ public:
 	 */
 	void putCell(int rowIndex, int colIndex, const std::string& value, int xfIndex);
 
+	/**
+	 * @brief
+	 *     Add cell data to table
+	 * @param[in] rowIndex
+	 *     Row index
+	 * @param[in] colIndex
+	 *     Column index
+	 * @param[in] value
+	 *     Null-terminated cell value (like string from shared strings table)
+	 * @param[in] xfIndex
+	 *     XF index
+	 * @since 1.2
+	 */
+	void putCell(int rowIndex, int colIndex, const char* value, int xfIndex);
+
+	/**
+	 * @brief
+	 *     Format number with cell number format and add it to table
+	 * @param[in] rowIndex
+	 *     Row index
+	 * @param[in] colIndex
+	 *     Column index
+	 * @param[in] value
+	 *     Cell value
+	 * @param[in] xfIndex
+	 *     XF index
+	 * @since 1.2
+	 */
+	void putNumber(int rowIndex, int colIndex, double value, int xfIndex);
+
 	/**
 	 * @brief
 	 *     Add missing cells to table
@@ -179,7 +209,7 @@ public:
 	/** Pointer to parent BOOK object */
 	Book* m_book;
 	/** Result HTML table */
-	pugi::xml_node& m_table;
+	pugi::xml_node m_table;
 	/** Sheet name */
 	std::string m_name;
 	/** Sheet number */
@@ -547,11 +577,15 @@ private:
 	 *     Unpack RK record data
 	 * @param[in] data
 	 *     Binary data
+	 * @param[in] dataSize
+	 *     Size of #data
+	 * @param[in] offset
+	 *     Start position of RK value in #data
 	 * @return
 	 *     RD data
 	 * @since 1.0
 	 */
-	double unpackRK(const std::string& data) const;
+	double unpackRK(const char* data, size_t dataSize, size_t offset) const;
 
 	/**
 	 * @brief
@@ -614,7 +648,7 @@ private:
 	 */
 	void getTableColor(std::string& style, const std::vector<std::string>& colorMap, int colorIndex) const;
 
-	/** Sheet record start position */
+	/** Current position of sheet in the stream (own cursor, independent from Book) */
 	int m_position;
 	//** Highest rowIndex containing a non-empty cell */
 	//int m_maxDataRowIndex = -1;
@@ -622,6 +656,8 @@ private:
 	//int m_maxDataColIndex = -1;
 	/** Maps cell attributes to XF index. BIFF2.0 only */
 	std::unordered_map<std::string, int> m_cellAttributesToXfIndex;
+	/** Reusable buffer for formatted numbers */
+	std::string m_numberBuffer;
 };
 
 
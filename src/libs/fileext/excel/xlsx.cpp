@@ -6,6 +6,10 @@
  * @copyright python-excel (https://github.com/python-excel/xlrd)
  * @date      02.12.2016 -- 28.01.2018
  */
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+
 #include "../../tools.hpp"
 
 #include "sheet.hpp"
@@ -19,14 +23,6 @@ namespace excel {
 const long int X12_MAX_ROWS = 1048576; // 2^20
 /** XLSX max column count */
 const int X12_MAX_COLS      = 16384;   // 2^14
-/** Uppercase relations index */
-const std::unordered_map<char, int> UPPERCASE_REL_INDEX {
-	{'1', 0},  {'3', 0},  {'2', 0},  {'5', 0},  {'4', 0},  {'7', 0},  {'6', 0},
-	{'9', 0},  {'8', 0},  {'A', 1},  {'C', 3},  {'B', 2},  {'E', 5},  {'D', 4},
-	{'G', 7},  {'F', 6},  {'I', 9},  {'H', 8},  {'K', 11}, {'J', 10}, {'M', 13},
-	{'L', 12}, {'O', 15}, {'N', 14}, {'Q', 17}, {'P', 16}, {'S', 19}, {'R', 18},
-	{'U', 21}, {'T', 20}, {'W', 23}, {'V', 22}, {'Y', 25}, {'X', 24}, {'Z', 26}
-};
 /** Horizontal aligment types */
 const std::unordered_map<std::string, int> XLSX_HORZ_ALIGN {
 	{"",                 0},
@@ -151,8 +147,10 @@ void X12Book::handleSst() {
 	pugi::xml_document tree;
 	Ooxml::extractFile(m_book->m_fileName, "xl/sharedstrings.xml", tree);
 
+	auto sst = tree.child("sst");
+	m_book->m_sharedStrings.reserve(sst.attribute("uniqueCount").as_uint(), 0);
 	for (const auto& node : tree.select_nodes("//si"))
-		m_book->m_sharedStrings.emplace_back(getTextFromSiIs(node.node()));
+		m_book->m_sharedStrings.add(getTextFromSiIs(node.node()));
 }
 
 void X12Book::handleRelations() {
@@ -211,6 +209,24 @@ void X12Book::handleStream() {
 	for (const auto& node : tree.select_nodes("//sheet")) {
 		handleSheet(node.node());
 	}
+
+	// Sheets have separate HTML trees, so their data can be read in parallel
+	size_t sheetCount = m_book->m_sheetList.size();
+	tools::parallelFor(sheetCount, [this](size_t i) {
+		readSheet(i);
+	});
+	m_book->joinSheetTrees();
+
+	// Images are added to shared list, so they are read in sheets order
+	if (m_book->m_extractImages) {
+		for (size_t i = 0; i < sheetCount; ++i) {
+			std::string id = "tabC"+ std::to_string(i + 1);
+			auto div = m_book->m_htmlTree.find_child_by_attribute("div", "id", id.c_str());
+			X12Sheet x12sheet(m_book, m_book->m_sheetList[i]);
+			x12sheet.getDrawingRelationshipMap(static_cast<int>(i));
+			x12sheet.handleImages(static_cast<int>(i), div);
+		}
+	}
 }
 
 // X12Book private:
@@ -255,10 +271,7 @@ void X12Book::handleSheet(const pugi::xml_node& node) {
 		m_book->m_sheetVisibility.push_back(0);
 
 	// Add sheet information
-	auto div = m_book->m_htmlTree.append_child("div");
-	div.append_attribute("id") = ("tabC"+ std::to_string(sheetIndex + 1)).c_str();
-	auto table = div.append_child("table");
-
+	auto table = m_book->addSheetTree(sheetIndex);
 	m_book->m_sheetList.emplace_back(m_book, -1, name, sheetIndex, table);
 	m_book->m_sheetNames.push_back(name);
 	m_book->m_sheetCount += 1;
@@ -268,7 +281,11 @@ void X12Book::handleSheet(const pugi::xml_node& node) {
 	Sheet& sheet = m_book->m_sheetList[m_book->m_sheetList.size() - 1];
 	sheet.m_maxRowCount = X12_MAX_ROWS;
 	sheet.m_maxColCount = X12_MAX_COLS;
+}
 
+void X12Book::readSheet(size_t sheetIndex) {
+	Sheet& sheet = m_book->m_sheetList[sheetIndex];
+	const std::string& target = m_sheetTargets[sheetIndex];
 	size_t found = target.find_last_of("/");
 	std::string relFileName = "xl/worksheets/_rels/"+ target.substr(found + 1) +".rels";
 
@@ -284,11 +301,6 @@ void X12Book::handleSheet(const pugi::xml_node& node) {
 		}
 	}
 
-	if (m_book->m_extractImages) {
-		x12sheet.getDrawingRelationshipMap(static_cast<int>(sheetIndex));
-		x12sheet.handleImages(static_cast<int>(sheetIndex), div);
-	}
-
 	sheet.tidyDimensions();
 }
 
@@ -415,6 +427,42 @@ void X12Sheet::handleImages(int sheetIndex, pugi::xml_node& htmlNode) {
 	}
 }
 
+const char* X12Sheet::readColumnIndex(const char* cellName, int& colIndex) {
+	colIndex = 0;
+	const char* c = cellName;
+	for (; *c; ++c) {
+		if (*c == '$')
+			continue;
+		if (*c >= 'A' && *c <= 'Z') {
+			colIndex = colIndex * 26 + (*c - 'A' + 1);
+			if (colIndex > X12_MAX_COLS)
+				throw std::logic_error("Column is out of range in cell name "+ std::string(cellName));
+		}
+		// Start of row number can't be '0'
+		else if (*c >= '1' && *c <= '9')
+			break;
+		else
+			throw std::logic_error(
+				"Unexpected character "+ std::string(1, *c) +" in cell name "+ std::string(cellName)
+			);
+	}
+	colIndex -= 1;
+	return c;
+}
+
+const char* X12Sheet::readNumber(const char* str, int& value) {
+	value = 0;
+	const char* c = str;
+	for (; *c >= '0' && *c <= '9'; ++c) {
+		int digit = *c - '0';
+		if (value > (std::numeric_limits<int>::max() - digit) / 10)
+			return nullptr;
+		value = value * 10 + digit;
+	}
+	return c;
+}
+
+
 // X12Sheet private:
 void X12Sheet::handleCol(const pugi::xml_node& node) {
 	if (!m_book->m_addStyle)
@@ -464,138 +512,121 @@ void X12Sheet::handleRow(const pugi::xml_node& node) {
 	// Read cell data
 	int colIndex = -1;
 	for (const auto& cellNode: node) {
-		std::string cellName = cellNode.attribute("r").value();
+		const char* cellName = cellNode.attribute("r").value();
 		// Yes, it's optional
-		if (cellName.empty()) {
+		if (!*cellName) {
 			colIndex += 1;
 		}
 		else {
 			// Extract column index from cell name (`A<row number>` => `0`, `Z` =>`25`, `AA` => `26`)
-			colIndex = 0;
-			char charIndex = -1;
-			for (const auto& c : cellName) {
-				charIndex += 1;
-				if (c == '$')
-					continue;
-				if (UPPERCASE_REL_INDEX.find(c) == UPPERCASE_REL_INDEX.end())
+			const char* rowPart = readColumnIndex(cellName, colIndex);
+			if (explicitRowNumber) {
+				int cellRowNumber;
+				const char* end = readNumber(rowPart, cellRowNumber);
+				if (!end || *end || cellRowNumber != rowNumber)
 					throw std::logic_error(
-						"Unexpected character "+ std::string(1, c) +" in cell name "+ cellName
+						"Cell name "+ std::string(cellName) +" but row number is "+
+						std::to_string(rowNumber)
 					);
-
-				int lv = UPPERCASE_REL_INDEX.at(c);
-				if (lv) {
-					colIndex = colIndex * 26 + lv;
-				}
-				// Start of row number can't be '\0'
-				else {
-					colIndex--;
-					break;
-				}
 			}
-
-			if (explicitRowNumber && cellName.substr(charIndex) != std::to_string(rowNumber))
-				throw std::logic_error(
-					"Cell name "+ cellName +" but row number is "+ std::to_string(rowNumber)
-				);
 		}
 
 		int xfIndex = cellNode.attribute("s").as_int()+1;
-		std::string cellType = cellNode.attribute("t").value();
-		std::string value;
-		std::string formula;
+		const char* cellType = cellNode.attribute("t").value();
 		// n = number. Most frequent type. <v> child contains plain text which can go straight
 		// into float() OR there's no text in which case it's a BLANK cell
-		if (cellType.empty()) {
+		if (!*cellType) {
+			const char* value = "";
 			for (const auto& child : cellNode) {
-				std::string childName = child.name();
-				if (childName == "v")
+				const char* childName = child.name();
+				if (strcmp(childName, "v") == 0)
 					value = child.child_value();
-				else if (childName == "f")
-					formula = getNodeText(child);
-				else
-					throw std::logic_error("Unexpected tag " + childName);
+				// Formula text is not converted
+				else if (strcmp(childName, "f") != 0)
+					throw std::logic_error("Unexpected tag "+ std::string(childName));
 			}
-			if (value.empty()) {
+			if (!*value) {
 				if (m_book->m_addStyle)
 					m_sheet.putCell(m_rowIndex, colIndex, "", xfIndex);
 			}
 			else {
-				m_sheet.putCell(m_rowIndex, colIndex, value, xfIndex);
+				m_sheet.putNumber(m_rowIndex, colIndex, std::strtod(value, nullptr), xfIndex);
 			}
+			continue;
 		}
+
+		std::string value;
 		// s = index into shared string table. 2nd most frequent type <v> child contains plain
 		// text which can go straight into int()
-		else if (cellType == "s") {
+		if (strcmp(cellType, "s") == 0) {
+			const char* sstIndex = "";
 			for (const auto& child : cellNode) {
-				std::string childName = child.name();
-				if (childName == "v")
-					value = child.child_value();
+				const char* childName = child.name();
+				if (strcmp(childName, "v") == 0)
+					sstIndex = child.child_value();
 				// Formula not expected here, but gnumeric does it
-				else if (childName == "f")
-					formula = child.child_value();
-				else
+				else if (strcmp(childName, "f") != 0)
 					throw std::logic_error(
-						"Cell type "+ cellType +" has unexpected child <"+ childName +"> at rowx="+
-						std::to_string(m_rowIndex) +" colx="+ std::to_string(colIndex)
+						"Cell type "+ std::string(cellType) +" has unexpected child <"+ childName +
+						"> at rowx="+ std::to_string(m_rowIndex) +" colx="+ std::to_string(colIndex)
 					);
 			}
 			// <c r="A1" t="s"/>
-			if (value.empty()) {
+			if (!*sstIndex) {
 				if (m_book->m_addStyle)
 					m_sheet.putCell(m_rowIndex, colIndex, "", xfIndex);
 			}
 			else {
-				m_sheet.putCell(
-					m_rowIndex, colIndex, m_book->m_sharedStrings[stoi(value)], xfIndex
-				);
+				int index;
+				const char* end = readNumber(sstIndex, index);
+				if (!end || end == sstIndex || *end)
+					throw std::logic_error(
+						"Invalid shared string index "+ std::string(sstIndex) +" at rowx="+
+						std::to_string(m_rowIndex) +" colx="+ std::to_string(colIndex)
+					);
+				m_sheet.putCell(m_rowIndex, colIndex, m_book->m_sharedStrings[index], xfIndex);
 			}
 		}
 		// str = string result from formula. Should have <f> (formula) child; however in one file,
 		// all text cells are str with no formula. <v> child can contain escapes
-		else if (cellType == "str") {
+		else if (strcmp(cellType, "str") == 0) {
 			for (const auto& child : cellNode) {
-				std::string childName = child.name();
-				if (childName == "v")
+				const char* childName = child.name();
+				if (strcmp(childName, "v") == 0)
 					value = getNodeText(child);
-				else if (childName == "f")
-					formula = getNodeText(child);
-				else
+				else if (strcmp(childName, "f") != 0)
 					throw std::logic_error(
-						"Cell type "+ cellType +" has unexpected child <"+ childName +"> at rowx="+
-						std::to_string(m_rowIndex) +" colx="+ std::to_string(colIndex)
+						"Cell type "+ std::string(cellType) +" has unexpected child <"+ childName +
+						"> at rowx="+ std::to_string(m_rowIndex) +" colx="+ std::to_string(colIndex)
 					);
 			}
 			m_sheet.putCell(m_rowIndex, colIndex, value, xfIndex);
 		}
 		// b = boolean. <v> child contains "0" or "1". Maybe data should be converted with
 		// cnv_xsd_boolean; ECMA standard is silent; Excel 2007 writes 0 or 1
-		else if (cellType == "b") {
+		else if (strcmp(cellType, "b") == 0) {
 			for (const auto& child : cellNode) {
-				std::string childName = child.name();
-				if (childName == "v")
+				const char* childName = child.name();
+				if (strcmp(childName, "v") == 0)
 					value = child.child_value();
-				else if (childName == "f")
-					formula = getNodeText(child);
-				else
+				else if (strcmp(childName, "f") != 0)
 					throw std::logic_error(
-						"Cell type "+ cellType +" has unexpected child <"+ childName +"> at rowx="+
-						std::to_string(m_rowIndex) +" colx="+ std::to_string(colIndex)
+						"Cell type "+ std::string(cellType) +" has unexpected child <"+ childName +
+						"> at rowx="+ std::to_string(m_rowIndex) +" colx="+ std::to_string(colIndex)
 					);
 			}
 			m_sheet.putCell(m_rowIndex, colIndex, value, xfIndex);
 		}
 		// e = error. <v> child contains e.g. "#REF!"
-		else if (cellType == "e") {
+		else if (strcmp(cellType, "e") == 0) {
 			for (const auto& child : cellNode) {
-				std::string childName = child.name();
-				if (childName == "v")
+				const char* childName = child.name();
+				if (strcmp(childName, "v") == 0)
 					value = child.child_value();
-				else if (childName == "f")
-					formula = getNodeText(child);
-				else
+				else if (strcmp(childName, "f") != 0)
 					throw std::logic_error(
-						"Cell type "+ cellType +" has unexpected child <"+ childName +"> at rowx="+
-						std::to_string(m_rowIndex) +" colx="+ std::to_string(colIndex)
+						"Cell type "+ std::string(cellType) +" has unexpected child <"+ childName +
+						"> at rowx="+ std::to_string(m_rowIndex) +" colx="+ std::to_string(colIndex)
 					);
 			}
 			m_sheet.putCell(m_rowIndex, colIndex, std::to_string(ERROR_CODE_FROM_TEXT.at(value)),
@@ -603,19 +634,17 @@ void X12Sheet::handleRow(const pugi::xml_node& node) {
 		}
 		// Not expected in files produced by Excel. It's a way of allowing 3rd party s/w to write
 		// text (including rich text) cells without having to build a shared string table (SST)
-		else if (cellType == "inlineStr") {
+		else if (strcmp(cellType, "inlineStr") == 0) {
 			for (const auto& child : cellNode) {
-				std::string childName = child.name();
-				if (childName == "is")
+				const char* childName = child.name();
+				if (strcmp(childName, "is") == 0)
 					value = getTextFromSiIs(child);
-				else if (childName == "v")
+				else if (strcmp(childName, "v") == 0)
 					value = child.child_value();
-				else if (childName == "f")
-					formula = child.child_value();
-				else
+				else if (strcmp(childName, "f") != 0)
 					throw std::logic_error(
-						"Cell type "+ cellType +" has unexpected child <"+ childName +"> at rowx="+
-						std::to_string(m_rowIndex) +" colx="+ std::to_string(colIndex)
+						"Cell type "+ std::string(cellType) +" has unexpected child <"+ childName +
+						"> at rowx="+ std::to_string(m_rowIndex) +" colx="+ std::to_string(colIndex)
 					);
 			}
 			if (value.empty()) {
@@ -628,7 +657,7 @@ void X12Sheet::handleRow(const pugi::xml_node& node) {
 		}
 		else {
 			throw std::logic_error(
-				"Unknown cell type "+ cellType +" in rowx="+ std::to_string(m_rowIndex) +
+				"Unknown cell type "+ std::string(cellType) +" in rowx="+ std::to_string(m_rowIndex) +
 				" colx="+ std::to_string(colIndex)
 			);
 		}
@@ -711,40 +740,20 @@ void X12Sheet::handleTableParts(const pugi::xml_node& node) {
 void X12Sheet::cellNameToIndex(const std::string& cellName, int& rowIndex,
 							   int& colIndex, bool noCol)
 {
-	colIndex = 0;
-	char charIndex = -1;
-
-	for (const auto& c : cellName) {
-		charIndex += 1;
-		if (UPPERCASE_REL_INDEX.find(c) == UPPERCASE_REL_INDEX.end())
-			throw std::logic_error(
-				"Unexpected character "+ std::string(1, c) +" in cell name "+ cellName
-			);
-
-		int lv = UPPERCASE_REL_INDEX.at(c);
-		if (lv) {
-			colIndex = colIndex * 26 + lv;
-		}
-		// Start of row number can't be '\0'
-		else {
-			if (charIndex == 0) {
-				// There was no col marker
-				if (noCol) {
-					colIndex = -1;
-					break;
-				}
-				else {
-					throw std::logic_error("Missing col in cell name "+ cellName);
-				}
-			}
-			else {
-				colIndex--;
-				break;
-			}
-		}
-	}
-
-	rowIndex = stoi(cellName.substr(charIndex)) - 1;
+	const char* rowPart = readColumnIndex(cellName.c_str(), colIndex);
+	// There was no col marker
+	if (colIndex == -1 && !noCol)
+		throw std::logic_error("Missing col in cell name "+ cellName);
+
+	const char* end = readNumber(rowPart, rowIndex);
+	if (!end)
+		throw std::logic_error("Row is out of range in cell name "+ cellName);
+	if (end == rowPart)
+		throw std::logic_error("Missing row in cell name "+ cellName);
+	if (*end)
+		throw std::logic_error("Unexpected character "+ std::string(1, *end) +" in cell name "+
+							   cellName);
+	rowIndex -= 1;
 }
 
 void X12Sheet::getImageSize(const pugi::xml_node& xmlNode, pugi::xml_node& htmlNode) const {
@@ -801,6 +810,8 @@ void X12Styles::handleStream() {
 	int fontIndex = 0;
 	for (const auto& node : tree.select_nodes("//numFmt"))
 		handleNumFormat(node.node());
+	Formatting formatting(m_book);
+	formatting.addStandardFormats();
 	for (const auto& node : tree.select_nodes("//font"))
 		handleFont(node.node(), fontIndex++);
 	for (const auto& node : tree.select_nodes("//border"))
@@ -815,9 +826,11 @@ void X12Styles::handleStream() {
 void X12Styles::handleNumFormat(const pugi::xml_node& node) {
 	std::string formatCode = node.attribute("formatCode").value();
 	int numFormatId = node.attribute("numFmtId").as_int();
-	bool isDate     = Formatting::isDateFormattedString(formatCode);
+	Format format(numFormatId, FUN, formatCode);
+	bool isDate     = format.m_numberFormat.isDate();
+	format.m_type   = isDate + 2;
 	m_isDateFormat[numFormatId] = isDate;
-	m_book->m_formatMap.emplace(numFormatId, Format(numFormatId, isDate + 2, formatCode));
+	m_book->m_formatMap.emplace(numFormatId, std::move(format));
 }
 
 void X12Styles::handleFont(const pugi::xml_node& node, int fontIndex) {
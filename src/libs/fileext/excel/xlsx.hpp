@@ -155,13 +155,24 @@ private:
 
 	/**
 	 * @brief
-	 *     Read sheet data
+	 *     Register sheet and create its HTML tree
 	 * @param[in] node
 	 *     Node in XML-tree
 	 * @since 1.0
 	 */
 	void handleSheet(const pugi::xml_node& node);
 
+	/**
+	 * @brief
+	 *     Read sheet data (relations, cells and comments)
+	 * @details
+	 *     Touches only sheet's own objects, so several sheets can be read at the same time
+	 * @param[in] sheetIndex
+	 *     Sheet index
+	 * @since 1.2
+	 */
+	void readSheet(size_t sheetIndex);
+
 	/**
 	 * @brief
 	 *     Create name map
@@ -243,6 +254,41 @@ public:
 	 */
 	void handleImages(int sheetIndex, pugi::xml_node& htmlNode);
 
+	/**
+	 * @brief
+	 *     Read column part of cell name
+	 * @details
+	 *     Example:
+	 *     @code `A1` => `0`, `$Z$1` => `25`, `AA` => `26` @endcode
+	 * @param[in] cellName
+	 *     Cell name
+	 * @param[out] colIndex
+	 *     Column index (-1 if there is no column part)
+	 * @return
+	 *     Pointer to row part of cell name
+	 * @throw std::logic_error
+	 *     Unexpected character in cell name
+	 * @since 1.2
+	 */
+	static const char* readColumnIndex(const char* cellName, int& colIndex);
+
+	/**
+	 * @brief
+	 *     Read non-negative decimal integer
+	 * @details
+	 *     Reading stops at first non-digit character, so caller should check that it is the end
+	 *     of string
+	 * @param[in] str
+	 *     Input string
+	 * @param[out] value
+	 *     Number value
+	 * @return
+	 *     Pointer to first character after number (equals to `str` if there are no digits,
+	 *     `nullptr` if number does not fit in `int`)
+	 * @since 1.2
+	 */
+	static const char* readNumber(const char* str, int& value);
+
 	/** Map relation id to path */
 	std::unordered_map<std::string, std::string> m_relIdToPath;
 	/** Map relation id to type */
@@ -17,12 +17,71 @@ namespace fileext {
 /** Config script file path */
 const std::string LIB_PATH = tools::PROGRAM_PATH + "/files/libs";
 const std::string SCRIPT_FILE = LIB_PATH + "/xpathconfig.min.js";
+/** Basic element styles */
+const std::string BASE_STYLE = "p{margin:0;} td{border:1px solid #efefff;} " \
+							   "table{border-collapse: collapse;} " \
+							   "body *:not(tr, td){display:block !important;}";
 
-// public:
+/** Prefix of interned style class names */
+const std::string STYLE_CLASS_PREFIX = "st";
+
+// StyleTable public:
+void StyleTable::addStyle(pugi::xml_node& node, const std::string& style) {
+	if (style.empty())
+		return;
+	std::string className = getClassName(style);
+	auto attribute = node.attribute("class");
+	if (attribute)
+		attribute.set_value((std::string(attribute.value()) +" "+ className).c_str());
+	else
+		node.append_attribute("class") = className.c_str();
+}
+
+std::string StyleTable::getClassName(const std::string& style) {
+	tools::LOCK lock(m_mutex);
+	auto result = m_indexMap.emplace(style, m_styleList.size());
+	if (result.second)
+		m_styleList.push_back(&result.first->first);
+	return STYLE_CLASS_PREFIX + std::to_string(result.first->second);
+}
+
+std::string StyleTable::getCss() const {
+	std::string css;
+	for (size_t i = 0; i < m_styleList.size(); ++i)
+		css += "."+ STYLE_CLASS_PREFIX + std::to_string(i) +"{"+ *m_styleList[i] +"}";
+	return css;
+}
+
+bool StyleTable::empty() const {
+	return m_styleList.empty();
+}
+
+
+// FileExtension public:
 FileExtension::FileExtension(const std::string& fileName)
 	: m_fileName(fileName) {}
 
-void FileExtension::saveHtml(std::string dir, const std::string& fileName) const {
+void FileExtension::saveHtml(std::string dir, const std::string& fileName) {
+	// Streaming mode (converter has not built HTML-tree)
+	if (m_streamMode && !m_htmlTree.first_child()) {
+		dir += "/" + fileName;
+		tools::createDir(dir);
+
+		std::ofstream outputFile(dir + "/"+ fileName, std::ios_base::binary);
+		outputFile << "<html><head><meta http-equiv=\"content-type\" "
+					  "content=\"text/html;charset=utf8\"></meta>"
+				   << "<style>" << BASE_STYLE << "</style>";
+		if (!m_streamStyle.empty())
+			outputFile << "<style>" << m_streamStyle << "</style>";
+		outputFile << "</head><body>\n";
+		streamHtml(outputFile);
+		// Styles are interned while body is written, so they are added after it
+		if (!m_styleTable.empty())
+			outputFile << "<style>" << m_styleTable.getCss() << "</style>\n";
+		outputFile << "</body></html>\n";
+		return;
+	}
+
 	auto node = m_htmlTree.child("html").child("head");
 	// Add `head` tag
 	if (!node)
@@ -34,11 +93,10 @@ void FileExtension::saveHtml(std::string dir, const std::string& fileName) const
 	nd.append_attribute("content")    = "text/html;charset=utf8";
 	// Add basic element styles
 	nd = node.append_child("style");
-	nd.append_child(pugi::node_pcdata).set_value(
-		"p{margin:0;} td{border:1px solid #efefff;} " \
-		"table{border-collapse: collapse;} " \
-		"body *:not(tr, td){display:block !important;}"
-	);
+	nd.append_child(pugi::node_pcdata).set_value(BASE_STYLE.c_str());
+	// Add interned styles
+	if (!m_styleTable.empty())
+		loadStyle(node, m_styleTable.getCss());
 
 	// Create dir if not exists
 	dir += "/" + fileName;
@@ -73,4 +131,12 @@ void FileExtension::loadStyle(pugi::xml_node& node, const std::string& style) co
 	node.append_child("style").append_child(pugi::node_pcdata).set_value(style.c_str());
 }
 
+void FileExtension::setStreamMode(bool streamMode) {
+	m_streamMode = streamMode;
+}
+
+
+// protected:
+void FileExtension::streamHtml(std::ostream& /*output*/) {}
+
 }  // End namespace
@@ -3,7 +3,7 @@
  * @package fileext
  * @file    fileext.hpp
  * @author  dmryutov (dmryutov@gmail.com)
- * @version 1.1.1
+ * @version 1.2
  * @date    12.07.2016 -- 10.02.2018
  */
 #pragma once
@@ -11,7 +11,10 @@
 // Uncomment this line to enable downloading images from URL (requires `cUrl` library)
 // #define DOWNLOAD_IMAGES
 
+#include <mutex>
+#include <ostream>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "../pugixml/pugixml.hpp"
@@ -24,6 +27,64 @@
  */
 namespace fileext {
 
+/**
+ * @class StyleTable
+ * @brief
+ *     Table of interned inline styles. Every unique style is emitted once in `head` as CSS class
+ * @note
+ *     Styles can be added from several threads
+ */
+class StyleTable {
+public:
+	/**
+	 * @brief
+	 *     Add style to HTML-node as CSS class
+	 * @param[out] node
+	 *     HTML-node
+	 * @param[in] style
+	 *     Inline style
+	 * @since 1.2
+	 */
+	void addStyle(pugi::xml_node& node, const std::string& style);
+
+	/**
+	 * @brief
+	 *     Get class name of style (style is added to table if it is new)
+	 * @param[in] style
+	 *     Inline style
+	 * @return
+	 *     CSS class name
+	 * @since 1.2
+	 */
+	std::string getClassName(const std::string& style);
+
+	/**
+	 * @brief
+	 *     Get CSS with all interned styles
+	 * @return
+	 *     CSS string
+	 * @since 1.2
+	 */
+	std::string getCss() const;
+
+	/**
+	 * @brief
+	 *     Check if table has no styles
+	 * @return
+	 *     True if table is empty
+	 * @since 1.2
+	 */
+	bool empty() const;
+
+private:
+	/** Style index by style */
+	std::unordered_map<std::string, size_t> m_indexMap;
+	/** Styles in order of adding */
+	std::vector<const std::string*> m_styleList;
+	/** Mutex for adding styles */
+	std::mutex m_mutex;
+};
+
 /**
  * @class FileExtension
  * @brief
@@ -65,7 +126,7 @@ public:
 	 *     If config mode
 	 * @since 1.0
 	 */
-	void saveHtml(std::string dir, const std::string& fileName = "tmp.html") const;
+	void saveHtml(std::string dir, const std::string& fileName = "tmp.html");
 
 	/**
 	 * @brief
@@ -78,10 +139,29 @@ public:
 	 */
 	void loadStyle(pugi::xml_node& node, const std::string& style) const;
 
+	/**
+	 * @brief
+	 *     Enable streaming mode. Converters which support it do not build HTML-tree
+	 *     in `convert()` and write result directly to output file in `saveHtml()`
+	 * @param[in] streamMode
+	 *     True if should stream result (bounded memory usage)
+	 * @since 1.2
+	 */
+	void setStreamMode(bool streamMode);
+
 	/** Result HTML tree */
 	pugi::xml_document m_htmlTree;
 
 protected:
+	/**
+	 * @brief
+	 *     Write content of `body` tag directly to output (streaming mode)
+	 * @param[out] output
+	 *     Output stream
+	 * @since 1.2
+	 */
+	virtual void streamHtml(std::ostream& output);
+
 	/** Name of processing file */
 	const std::string m_fileName;
 	/** Should read and add styles to HTML-tree */
@@ -99,6 +179,12 @@ protected:
 	bool m_extractImages = false;
 	/** List of images (binary data and extension) */
 	std::vector<std::pair<std::string, std::string>> m_imageList;
+	/** True if result should be streamed (if converter supports it) */
+	bool m_streamMode = false;
+	/** Inline style which is added to `head` tag in streaming mode */
+	std::string m_streamStyle;
+	/** Interned styles of HTML-nodes */
+	StyleTable m_styleTable;
 };
 
 }  // End namespace
@@ -6,6 +6,7 @@
  * @date    04.08.2017 -- 10.02.2018
  */
 #include <fstream>
+#include <stdexcept>
 
 #include "../../tools.hpp"
 
@@ -29,6 +30,12 @@ void Json::convert(bool addStyle, bool extractImages, char mergingMode) {
 	m_extractImages = extractImages;
 	m_mergingMode   = mergingMode;
 
+	// Streaming mode (markup is written in `saveHtml()`)
+	if (m_streamMode) {
+		m_streamStyle = STYLE;
+		return;
+	}
+
 	auto htmlTag = m_htmlTree.append_child("html");
 	auto headTag = htmlTag.append_child("head");
 	auto bodyTag = htmlTag.append_child("body");
@@ -43,6 +50,52 @@ void Json::convert(bool addStyle, bool extractImages, char mergingMode) {
 }
 
 
+// protected:
+void Json::streamHtml(std::ostream& output) {
+	std::ifstream documentFile(m_fileName, std::ios::binary);
+	auto buffer = documentFile.rdbuf();
+	std::vector<char> bracketStack;
+
+	int c = skipWhitespace(buffer);
+	if (c == EOF)
+		return;
+	bool isOpened = streamValue(buffer, c, output, bracketStack);
+
+	while (!bracketStack.empty()) {
+		c = skipWhitespace(buffer);
+		if (c == EOF)
+			throw std::logic_error("Unexpected end of JSON file");
+
+		// First element or empty array/object
+		if (isOpened) {
+			if (c != bracketStack.back()) {
+				isOpened = streamElement(buffer, c, output, bracketStack);
+				continue;
+			}
+		}
+		// Next element
+		else if (c == ',') {
+			output << "<span class=\"value-comma\">,</span></div></div>";
+			isOpened = streamElement(buffer, skipWhitespace(buffer), output, bracketStack);
+			continue;
+		}
+		// Last element
+		else if (c == bracketStack.back()) {
+			output << "</div></div>";
+		}
+		else {
+			throw std::logic_error("Unexpected symbol in JSON file");
+		}
+
+		// Close array/object
+		output << "</div><div class=\"bracket\">" << static_cast<char>(c);
+		bracketStack.pop_back();
+		isOpened = false;
+	}
+	output << "</div>\n";
+}
+
+
 // private:
 void Json::objectWalker(const nlohmann::json& object, pugi::xml_node& htmlNode) const {
 	auto contentDiv = htmlNode.append_child("div");
@@ -128,4 +181,135 @@ void Json::addComma(pugi::xml_node& htmlNode) const {
 	commaSpan.append_child(pugi::node_pcdata).set_value(",");
 }
 
+bool Json::streamValue(std::streambuf* buffer, int c, std::ostream& output,
+					   std::vector<char>& bracketStack) const
+{
+	// Array/object
+	if (c == '{' || c == '[') {
+		output << "<div class=\"bracket\">" << static_cast<char>(c)
+			   << "</div><div class=\"content\">";
+		bracketStack.push_back(c == '{' ? '}' : ']');
+		return true;
+	}
+
+	output << "<div class=\"value\"><span class=\"value-data\">";
+	// String
+	if (c == '"') {
+		std::string data = readString(buffer);
+		output << '"';
+		tools::writeHtmlEscaped(output, data.data(), data.size());
+		output << '"';
+	}
+	// Number, `true`, `false`, `null`
+	else {
+		std::string data(1, static_cast<char>(c));
+		while ((c = buffer->sgetc()) != EOF &&
+			   (isalnum(c) || c == '-' || c == '+' || c == '.'))
+			data += static_cast<char>(buffer->sbumpc());
+		if (data != "true" && data != "false" && data != "null" &&
+			!isdigit(data[0]) && data[0] != '-')
+			throw std::logic_error("Invalid JSON value "+ data);
+		output << data;
+	}
+	output << "</span>";
+	return false;
+}
+
+bool Json::streamElement(std::streambuf* buffer, int c, std::ostream& output,
+						 std::vector<char>& bracketStack) const
+{
+	output << "<div class=\"pair\">";
+
+	// Add key (objects only)
+	if (bracketStack.back() == '}') {
+		if (c != '"')
+			throw std::logic_error("Expected key in JSON object");
+		std::string key = readString(buffer);
+		if (skipWhitespace(buffer) != ':')
+			throw std::logic_error("Expected `:` in JSON object");
+
+		output << "<div class=\"key\"><span class=\"key-data\">\"";
+		tools::writeHtmlEscaped(output, key.data(), key.size());
+		output << "\"</span><span class=\"key-spacer\">:</span></div>";
+		c = skipWhitespace(buffer);
+	}
+	if (c == EOF)
+		throw std::logic_error("Unexpected end of JSON file");
+
+	return streamValue(buffer, c, output, bracketStack);
+}
+
+std::string Json::readString(std::streambuf* buffer) const {
+	std::string result;
+	int c;
+	while ((c = buffer->sbumpc()) != '"') {
+		if (c == EOF)
+			throw std::logic_error("Unterminated JSON string");
+		if (c != '\\') {
+			result += static_cast<char>(c);
+			continue;
+		}
+
+		// Escape sequence
+		switch (c = buffer->sbumpc()) {
+			case 'b': result += '\b'; break;
+			case 'f': result += '\f'; break;
+			case 'n': result += '\n'; break;
+			case 'r': result += '\r'; break;
+			case 't': result += '\t'; break;
+			case 'u': {
+				unsigned long code = 0;
+				for (int i = 0; i < 4; ++i) {
+					int hex = tools::hexCharToDec(static_cast<char>(toupper(buffer->sbumpc())));
+					if (hex < 0 || hex > 15)
+						throw std::logic_error("Invalid JSON unicode escape");
+					code = (code << 4) | hex;
+				}
+				// Surrogate pair
+				if (code >= 0xD800 && code <= 0xDBFF && buffer->sgetc() == '\\') {
+					buffer->sbumpc();
+					if (buffer->sbumpc() != 'u')
+						throw std::logic_error("Invalid JSON unicode escape");
+					unsigned long low = 0;
+					for (int i = 0; i < 4; ++i)
+						low = (low << 4) | tools::hexCharToDec(static_cast<char>(toupper(buffer->sbumpc())));
+					code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+				}
+
+				// Encode to UTF-8
+				if (code < 0x80) {
+					result += static_cast<char>(code);
+				}
+				else if (code < 0x800) {
+					result += static_cast<char>(0xC0 | (code >> 6));
+					result += static_cast<char>(0x80 | (code & 0x3F));
+				}
+				else if (code < 0x10000) {
+					result += static_cast<char>(0xE0 | (code >> 12));
+					result += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+					result += static_cast<char>(0x80 | (code & 0x3F));
+				}
+				else {
+					result += static_cast<char>(0xF0 | (code >> 18));
+					result += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+					result += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+					result += static_cast<char>(0x80 | (code & 0x3F));
+				}
+				break;
+			}
+			case EOF:
+				throw std::logic_error("Unterminated JSON string");
+			default:
+				result += static_cast<char>(c);
+		}
+	}
+	return result;
+}
+
+int Json::skipWhitespace(std::streambuf* buffer) const {
+	int c;
+	while ((c = buffer->sbumpc()) == ' ' || c == '\n' || c == '\r' || c == '\t');
+	return c;
+}
+
 }  // End namespace
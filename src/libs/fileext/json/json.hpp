@@ -3,12 +3,15 @@
  * @package json
  * @file    json.hpp
  * @author  dmryutov (dmryutov@gmail.com)
- * @version 1.0.1
+ * @version 1.1
  * @date    04.08.2017 -- 10.02.2018
  */
 #pragma once
 
+#include <ostream>
+#include <streambuf>
 #include <string>
+#include <vector>
 
 #include "../../json.hpp"
 #include "../../pugixml/pugixml.hpp"
@@ -52,6 +55,19 @@ public:
 	 */
 	void convert(bool addStyle = true, bool extractImages = false, char mergingMode = 0) override;
 
+protected:
+	/**
+	 * @brief
+	 *     Tokenize JSON file and write markup directly to output (streaming mode).
+	 *     Memory usage depends on nesting depth only
+	 * @param[out] output
+	 *     Output stream
+	 * @throw std::logic_error
+	 *     Invalid JSON
+	 * @since 1.1
+	 */
+	void streamHtml(std::ostream& output) override;
+
 private:
 	/**
 	 * @brief
@@ -91,6 +107,64 @@ private:
 	 * @since 1.0
 	 */
 	void addComma(pugi::xml_node& htmlNode) const;
+
+	/**
+	 * @brief
+	 *     Write value (opening part of array/object or scalar value) in streaming mode
+	 * @param[in] buffer
+	 *     Input buffer
+	 * @param[in] c
+	 *     First value symbol
+	 * @param[out] output
+	 *     Output stream
+	 * @param[in,out] bracketStack
+	 *     Close brackets of currently opened arrays/objects
+	 * @return
+	 *     True if array/object was opened
+	 * @since 1.1
+	 */
+	bool streamValue(std::streambuf* buffer, int c, std::ostream& output,
+					 std::vector<char>& bracketStack) const;
+
+	/**
+	 * @brief
+	 *     Write array/object element (key and value) in streaming mode
+	 * @param[in] buffer
+	 *     Input buffer
+	 * @param[in] c
+	 *     First element symbol
+	 * @param[out] output
+	 *     Output stream
+	 * @param[in,out] bracketStack
+	 *     Close brackets of currently opened arrays/objects
+	 * @return
+	 *     True if array/object was opened
+	 * @since 1.1
+	 */
+	bool streamElement(std::streambuf* buffer, int c, std::ostream& output,
+					   std::vector<char>& bracketStack) const;
+
+	/**
+	 * @brief
+	 *     Read and decode JSON string (opening quote is already read)
+	 * @param[in] buffer
+	 *     Input buffer
+	 * @return
+	 *     Decoded string
+	 * @since 1.1
+	 */
+	std::string readString(std::streambuf* buffer) const;
+
+	/**
+	 * @brief
+	 *     Skip whitespaces
+	 * @param[in] buffer
+	 *     Input buffer
+	 * @return
+	 *     First non-whitespace symbol (EOF if end of file)
+	 * @since 1.1
+	 */
+	int skipWhitespace(std::streambuf* buffer) const;
 };
 
 }  // End namespace
@@ -6,6 +6,7 @@
  * @date      12.08.2017 -- 18.10.2017
  */
 #include <algorithm>
+#include <cstring>
 #include <fstream>
 
 #include "../../tools.hpp"
@@ -38,6 +39,16 @@ const std::vector<std::string> BORDER_LIST {
 	"border-right",
 	"border-bottom"
 };
+/** Padding position list */
+const std::vector<std::string> PADDING_LIST {
+	"padding",
+	"padding-left",
+	"padding-right",
+	"padding-top",
+	"padding-bottom"
+};
+/** Style with no properties */
+const Style EMPTY_STYLE;
 
 // public:
 Odt::Odt(const std::string& fileName)
@@ -66,23 +77,24 @@ void Odt::convert(bool addStyle, bool extractImages, char mergingMode) {
 // Loading styles
 void Odt::getStyleMap(const pugi::xml_document& tree) {
 	for (const auto& node : tree.child("office:document-content").child("office:automatic-styles")) {
-		std::string key = node.attribute("style:name").value();
-		// Get parent tag attributes
-		for (const auto& attr : node.attributes()) {
-			std::string attrName = attr.name();
-			if (attrName != "style:name") {
-				attrName = attrName.substr(attrName.find_first_of(":") + 1);
-				m_styleMap[key][attrName] = attr.value();
-			}
+		if (strcmp(node.name(), "text:list-style") == 0) {
+			readListStyle(node);
+			continue;
 		}
-
-		// Get children tags attributes
-		for (const auto& child : node.children()) {
-			for (const auto& attr : child.attributes()) {
-				std::string attrName = attr.name();
-				attrName = attrName.substr(attrName.find_first_of(":") + 1);
-				m_styleMap[key][attrName] = attr.value();
-			}
+		auto& style = m_styleMap[node.attribute("style:name").value()];
+		readStyle(node, style);
+
+		// Precompute paragraph CSS
+		if (!style.m_textAlign.empty())
+			style.m_css += "text-align:"+ style.m_textAlign +"; ";
+		for (size_t i = 0; i < PADDING_LIST.size(); ++i) {
+			if (!style.m_paddingList[i].empty())
+				style.m_css += PADDING_LIST[i] +":"+ style.m_paddingList[i] +"; ";
+		}
+		getGeneralCss(style, nullptr, style.m_css);
+		for (size_t i = 0; i < BORDER_LIST.size(); ++i) {
+			if (!style.m_borderList[i].empty())
+				style.m_css += BORDER_LIST[i] +":"+ style.m_borderList[i] +"; ";
 		}
 	}
 }
@@ -91,39 +103,101 @@ void Odt::getListStyleMap() {
 	pugi::xml_document tree;
 	Ooxml::extractFile(m_fileName, "styles.xml", tree);
 
-	for (const auto& node : tree.select_nodes("//text:list-style")) {
-		auto styleNode = node.node();
-		std::string key = styleNode.attribute("style:name").value();
-
-		// Get children tags attributes
-		for (const auto& levelStyleNode : styleNode.children()) {
-			std::string levelStyleNodeName = levelStyleNode.name();
-			int level = levelStyleNode.attribute("text:level").as_int() - 1;
-			if (levelStyleNodeName == "text:list-level-style-bullet")
-				m_listStyleMap[key][level]["type"] = "ul";
-			else
-				m_listStyleMap[key][level]["type"] = "ol";
-
-			// Get parent tag attributes
-			for (const auto& attr : levelStyleNode.attributes()) {
-				std::string attrName = attr.name();
-				attrName = attrName.substr(attrName.find_first_of(":") + 1);
-				m_listStyleMap[key][level][attrName] = attr.value();
-			}
+	for (const auto& node : tree.select_nodes("//text:list-style"))
+		readListStyle(node.node());
+}
 
-			// Get children tags attributes
-			for (const auto& child : levelStyleNode.children()) {
-				std::string childName = child.name();
-				for (const auto& attr : child.attributes()) {
-					std::string attrName = attr.name();
-					attrName = attrName.substr(attrName.find_first_of(":") + 1);
-					m_listStyleMap[key][level][attrName] = attr.value();
-				}
+void Odt::readStyle(const pugi::xml_node& node, Style& style) {
+	auto header = HEADER_LIST.find(node.attribute("style:parent-style-name").value());
+	if (header != HEADER_LIST.end())
+		style.m_header = header->second;
+
+	// Get parent and children tags attributes
+	readStyleAttributes(node, style);
+	for (const auto& child : node.children())
+		readStyleAttributes(child, style);
+}
+
+void Odt::readStyleAttributes(const pugi::xml_node& node, Style& style) {
+	for (const auto& attr : node.attributes()) {
+		// Namespace prefix is ignored
+		const char* name  = attr.name();
+		const char* colon = strchr(name, ':');
+		if (colon)
+			name = colon + 1;
+		const char* value = attr.value();
+
+		if (strcmp(name, "font-weight") == 0 && strcmp(value, "bold") == 0)
+			style.m_textTagList.emplace_back("b");
+		else if (strcmp(name, "font-style") == 0 && strcmp(value, "italic") == 0)
+			style.m_textTagList.emplace_back("i");
+		else if (strcmp(name, "text-underline-style") == 0 && *value &&
+				 strcmp(value, "none") != 0)
+			style.m_textTagList.emplace_back("u");
+		else if (strcmp(name, "text-line-through-style") == 0 && *value &&
+				 strcmp(value, "none") != 0)
+			style.m_textTagList.emplace_back("s");
+		else if (strcmp(name, "text-position") == 0 && strncmp(value, "sub", 3) == 0)
+			style.m_textTagList.emplace_back("sub");
+		else if (strcmp(name, "text-position") == 0 && strncmp(value, "sup", 3) == 0)
+			style.m_textTagList.emplace_back("sup");
+		else if (strcmp(name, "font-name") == 0)
+			style.m_fontFamily = value;
+		else if (strcmp(name, "font-size") == 0)
+			style.m_fontSize = value;
+		else if (strcmp(name, "color") == 0)
+			style.m_color = value;
+		else if (strcmp(name, "background-color") == 0)
+			style.m_background = value;
+		else if (strcmp(name, "display") == 0)
+			style.m_isHidden = (strcmp(value, "none") == 0);
+		else if (strcmp(name, "text-align") == 0)
+			style.m_textAlign = value;
+		else if (strcmp(name, "min-row-height") == 0)
+			style.m_minRowHeight = value;
+		else if (strcmp(name, "vertical-align") == 0)
+			style.m_verticalAlign = value;
+		else if (strncmp(name, "padding", 7) == 0 || strncmp(name, "border", 6) == 0) {
+			for (size_t i = 0; i < PADDING_LIST.size(); ++i) {
+				if (PADDING_LIST[i] == name)
+					style.m_paddingList[i] = value;
+				else if (BORDER_LIST[i] == name)
+					style.m_borderList[i] = value;
 			}
 		}
 	}
 }
 
+void Odt::readListStyle(const pugi::xml_node& node) {
+	auto& levelList = m_listStyleMap[node.attribute("style:name").value()];
+	for (const auto& levelNode : node.children()) {
+		int level = levelNode.attribute("text:level").as_int() - 1;
+		if (level < 0)
+			continue;
+		if (static_cast<size_t>(level) >= levelList.size())
+			levelList.resize(level + 1);
+
+		auto& listLevel = levelList[level];
+		if (strcmp(levelNode.name(), "text:list-level-style-bullet") == 0) {
+			listLevel.m_tagName = "ul";
+			continue;
+		}
+		listLevel.m_tagName = "ol";
+		auto type = LIST_TYPE.find(levelNode.attribute("style:num-format").value());
+		if (type != LIST_TYPE.end())
+			listLevel.m_css = "list-style-type: "+ type->second +";";
+	}
+}
+
+const Style& Odt::getStyle(const char* name) const {
+	if (!*name)
+		return EMPTY_STYLE;
+	auto style = m_styleMap.find(name);
+	if (style == m_styleMap.end())
+		return EMPTY_STYLE;
+	return style->second;
+}
+
 // Building elements
 void Odt::buildElement(const pugi::xml_node& xmlNode, pugi::xml_node& htmlNode, bool inElement) {
 	std::string nodeName = xmlNode.name();
@@ -141,7 +215,7 @@ void Odt::buildElement(const pugi::xml_node& xmlNode, pugi::xml_node& htmlNode,
 	// `text:p` or other tags
 	else {
 		auto p = htmlNode;
-		std::string tagName = HEADER_LIST.at(xmlNode.attribute("parent-style-name").value());
+		std::string tagName = getStyle(xmlNode.attribute("text:style-name").value()).m_header;
 		if (tagName.empty())
 			tagName = "p";
 
@@ -189,9 +263,10 @@ void Odt::buildPlainText(const pugi::xml_node& xmlNode, pugi::xml_node& htmlNode
 		return;
 
 	// Wrap text with any modifiers it might have (bold/italics/underlined)
+	auto node = htmlNode;
 	if (m_addStyle)
-		addStyle(xmlNode, htmlNode);
-	htmlNode.append_child(pugi::node_pcdata).set_value(text.c_str());
+		addStyle(xmlNode, node);
+	node.append_child(pugi::node_pcdata).set_value(text.c_str());
 }
 
 void Odt::buildHyperlink(const pugi::xml_node& xmlNode, pugi::xml_node& htmlNode) {
@@ -301,12 +376,13 @@ void Odt::buildList(const pugi::xml_node& xmlNode, pugi::xml_node& htmlNode) {
 	int level = getIndentationLevel(xmlNode, key);
 
 	// Get list type
-	std::string tagName = m_listStyleMap[key][level]["type"];
-	auto ul = htmlNode.append_child(tagName.c_str());
-	if (tagName == "ol") {
-		std::string s = LIST_TYPE.at(m_listStyleMap[key][level]["num-format"]);
-		ul.append_attribute("style") = ("list-style-type: "+ s +";").c_str();
-	}
+	ListLevel listLevel;
+	auto levelList = m_listStyleMap.find(key);
+	if (levelList != m_listStyleMap.end() && static_cast<size_t>(level) < levelList->second.size())
+		listLevel = levelList->second[level];
+	auto ul = htmlNode.append_child(listLevel.m_tagName.c_str());
+	if (!listLevel.m_css.empty())
+		ul.append_attribute("style") = listLevel.m_css.c_str();
 
 	for (const auto& listNode : xmlNode) {
 		auto li = ul.append_child("li");
@@ -318,7 +394,7 @@ void Odt::buildList(const pugi::xml_node& xmlNode, pugi::xml_node& htmlNode) {
 int Odt::getIndentationLevel(pugi::xml_node xmlNode, std::string& key) const {
 	key = xmlNode.attribute("text:style-name").value();
 	int level = 0;
-	while (key.empty()) {
+	while (key.empty() && xmlNode) {
 		xmlNode = xmlNode.parent().parent();
 		key = xmlNode.attribute("text:style-name").value();
 		level++;
@@ -336,111 +412,52 @@ void Odt::addTextStyle(pugi::xml_node& node, const std::string& style) const {
 }
 
 void Odt::addStyle(const pugi::xml_node& xmlNode, pugi::xml_node& htmlNode) {
-	std::unordered_map<std::string, std::string> parentStyleMap;
-	std::unordered_map<std::string, std::string> elementStyleMap;
-	std::string parentKey  = xmlNode.parent().parent().attribute("text:style-name").value();
-	std::string elementKey = xmlNode.parent().attribute("text:style-name").value();
-	auto& currentElementStyle = m_styleMap.at(elementKey);
-	auto& currentParentStyle  = m_styleMap.at(parentKey);
-	std::string value;
+	const Style& parentStyle  = getStyle(
+		xmlNode.parent().parent().attribute("text:style-name").value()
+	);
+	const Style& elementStyle = getStyle(xmlNode.parent().attribute("text:style-name").value());
 	auto node = htmlNode;
 
 	// Add text style tags such as b/i/u/...
-	if (currentElementStyle["font-weight"] == "bold")
-		addTextStyle(htmlNode, "b");
-	if (currentElementStyle["font-style"] == "italic")
-		addTextStyle(htmlNode, "i");
-	if (!currentElementStyle["text-underline-style"].empty())
-		addTextStyle(htmlNode, "u");
-	if (!currentElementStyle["text-line-through-style"].empty())
-		addTextStyle(htmlNode, "s");
-
-	value = currentElementStyle["text-position"].substr(0, 3);
-	if (value == "sub")
-		addTextStyle(htmlNode, "sub");
-	else if (value == "sup")
-		addTextStyle(htmlNode, "sup");
-
-	// Get style for "style" attribute
-	value = currentParentStyle["text-align"];
-	if (!value.empty()) parentStyleMap["text-align"] = value;
-
-	value = currentParentStyle["padding"];
-	if (!value.empty()) parentStyleMap["padding"] = value;
-	value = currentParentStyle["padding-left"];
-	if (!value.empty()) parentStyleMap["padding-left"] = value;
-	value = currentParentStyle["padding-right"];
-	if (!value.empty()) parentStyleMap["padding-right"] = value;
-	value = currentParentStyle["padding-top"];
-	if (!value.empty()) parentStyleMap["padding-top"] = value;
-	value = currentParentStyle["padding-bottom"];
-	if (!value.empty()) parentStyleMap["padding-bottom"] = value;
-
-	/*value = currentParentStyle["margin"];
-	if (!value.empty()) parentStyleMap["margin"] = value;
-	value = currentParentStyle["margin-left"];
-	if (!value.empty()) parentStyleMap["margin-left"] = value;
-	value = currentParentStyle["margin-right"];
-	if (!value.empty()) parentStyleMap["margin-right"] = value;
-	value = currentParentStyle["margin-top"];
-	if (!value.empty()) parentStyleMap["margin-top"] = value;
-	value = currentParentStyle["margin-bottom"];
-	if (!value.empty()) parentStyleMap["margin-bottom"] = value;*/
-
-	addGeneralStyle(parentKey, parentStyleMap);
-	addGeneralStyle(elementKey, elementStyleMap);
-
-	for (const auto& border : BORDER_LIST) {
-		value = currentParentStyle[border];
-		if (!value.empty())
-			parentStyleMap[border] = value;
-	}
+	for (const auto& tag : elementStyle.m_textTagList)
+		addTextStyle(htmlNode, tag);
 
 	// Add parent style
-	std::string style;
-	for (const auto& sm : parentStyleMap)
-		style += sm.first + ":" + sm.second + "; ";
-	std::string styleAttr = htmlNode.attribute("style").value();
-	if (!style.empty() &&
-		styleAttr.substr(std::max(0, (int)(styleAttr.size()-style.size()))) != style
-	) {
-		if (styleAttr.empty())
+	const std::string& style = parentStyle.m_css;
+	auto styleAttr = node.attribute("style");
+	if (!style.empty()) {
+		const char* value = styleAttr.value();
+		size_t size = strlen(value);
+		if (!styleAttr)
 			node.append_attribute("style") = style.c_str();
-		else
-			node.attribute("style").set_value((styleAttr + style).c_str());
+		else if (size < style.size() || style.compare(value + size - style.size()) != 0)
+			styleAttr.set_value((value + style).c_str());
 	}
 
-	// Add element style
-	style.clear();
-	for (const auto& sm : elementStyleMap) {
-		if (sm.second != parentStyleMap[sm.first])
-			style += sm.first + ":" + sm.second + "; ";
+	// Add element style (only properties which differ from parent ones)
+	if (&parentStyle != m_spanParent || &elementStyle != m_spanElement) {
+		m_spanParent  = &parentStyle;
+		m_spanElement = &elementStyle;
+		m_spanCss.clear();
+		getGeneralCss(elementStyle, &parentStyle, m_spanCss);
 	}
-	if (!style.empty()) {
+	if (!m_spanCss.empty()) {
 		htmlNode = htmlNode.append_child("span");
-		htmlNode.append_attribute("style") = style.c_str();
+		htmlNode.append_attribute("style") = m_spanCss.c_str();
 	}
 }
 
-void Odt::addGeneralStyle(const std::string& key,
-						  std::unordered_map<std::string, std::string>& styleMap)
-{
-	auto& currentNodeStyle = m_styleMap.at(key);
-	std::string value;
-	value = currentNodeStyle["font-name"];
-	if (!value.empty()) styleMap["font-family"] = "'"+ value +"'";
-
-	value = currentNodeStyle["font-size"];
-	if (!value.empty()) styleMap["font-size"] = value;
-
-	value = currentNodeStyle["color"];
-	if (!value.empty()) styleMap["color"] = value;
-
-	value = currentNodeStyle["background-color"];
-	if (!value.empty()) styleMap["background-color"] = value;
-
-	if (currentNodeStyle["display"] == "none")
-		styleMap["display"] = "none";
+void Odt::getGeneralCss(const Style& style, const Style* parent, std::string& css) {
+	if (!style.m_fontFamily.empty() && (!parent || style.m_fontFamily != parent->m_fontFamily))
+		css += "font-family:'"+ style.m_fontFamily +"'; ";
+	if (!style.m_fontSize.empty() && (!parent || style.m_fontSize != parent->m_fontSize))
+		css += "font-size:"+ style.m_fontSize +"; ";
+	if (!style.m_color.empty() && (!parent || style.m_color != parent->m_color))
+		css += "color:"+ style.m_color +"; ";
+	if (!style.m_background.empty() && (!parent || style.m_background != parent->m_background))
+		css += "background-color:"+ style.m_background +"; ";
+	if (style.m_isHidden && (!parent || !parent->m_isHidden))
+		css += "display:none; ";
 }
 
 void Odt::addImageStyle(const pugi::xml_node& xmlNode, pugi::xml_node& htmlNode) const {
@@ -451,54 +468,34 @@ void Odt::addImageStyle(const pugi::xml_node& xmlNode, pugi::xml_node& htmlNode)
 }
 
 void Odt::addTableStyle(const pugi::xml_node& xmlNode) {
-	std::string key = xmlNode.attribute("table:style-name").value();
-	auto& currentNodeStyle = m_styleMap[key];
-	m_borderMap.clear();
-
-	for (const auto& border : BORDER_LIST) {
-		std::string value = currentNodeStyle[border];
-		if (!value.empty())
-			m_borderMap[border] = value;
-	}
+	m_tableStyle = &getStyle(xmlNode.attribute("table:style-name").value());
 }
 
 void Odt::addRowStyle(const pugi::xml_node& xmlNode, pugi::xml_node& htmlNode) {
-	std::string key = xmlNode.attribute("table:style-name").value();
-
-	std::string value = m_styleMap[key]["min-row-height"];
-	if (!value.empty()) {
-		value = "height:" + value;
-		htmlNode.append_attribute("style") = value.c_str();
-	}
+	const Style& style = getStyle(xmlNode.attribute("table:style-name").value());
+	if (!style.m_minRowHeight.empty())
+		htmlNode.append_attribute("style") = ("height:"+ style.m_minRowHeight).c_str();
 }
 
 void Odt::addCellStyle(const pugi::xml_node& xmlNode, pugi::xml_node& htmlNode) {
-	std::unordered_map<std::string, std::string> styleMap;
-	std::string key = xmlNode.attribute("table:style-name").value();
-	std::string value;
-	auto& currentNodeStyle = m_styleMap.at(key);
-
-	value = currentNodeStyle["vertical-align"];
-	if (!value.empty()) styleMap["vertical-align"] = value;
-
-	value = currentNodeStyle["background-color"];
-	if (!value.empty()) styleMap["background"] = value;
-
-	for (const auto& border : BORDER_LIST) {
-		value = currentNodeStyle[border];
-		if (!value.empty())
-			styleMap[border] = value;
-		else if (!m_borderMap.at(border).empty())
-			styleMap[border] = m_borderMap.at(border);
-		else if (border != "border")
-			styleMap[border] = "1px none #000";
-	}
-
+	const Style& cellStyle  = getStyle(xmlNode.attribute("table:style-name").value());
+	const Style& tableStyle = m_tableStyle ? *m_tableStyle : EMPTY_STYLE;
 	std::string style;
-	for (const auto& sm : styleMap)
-		style += sm.first + ":" + sm.second + "; ";
-	if (!style.empty())
-		htmlNode.append_attribute("style") = style.c_str();
+
+	if (!cellStyle.m_verticalAlign.empty())
+		style += "vertical-align:"+ cellStyle.m_verticalAlign +"; ";
+	if (!cellStyle.m_background.empty())
+		style += "background:"+ cellStyle.m_background +"; ";
+
+	for (size_t i = 0; i < BORDER_LIST.size(); ++i) {
+		if (!cellStyle.m_borderList[i].empty())
+			style += BORDER_LIST[i] +":"+ cellStyle.m_borderList[i] +"; ";
+		else if (!tableStyle.m_borderList[i].empty())
+			style += BORDER_LIST[i] +":"+ tableStyle.m_borderList[i] +"; ";
+		else if (i != 0)
+			style += BORDER_LIST[i] +":1px none #000; ";
+	}
+	m_styleTable.addStyle(htmlNode, style);
 }
 
 }  // End namespace
\ No newline at end of file
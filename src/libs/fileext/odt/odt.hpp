@@ -3,7 +3,7 @@
  * @package   odt
  * @file      odt.hpp
  * @author    dmryutov (dmryutov@gmail.com)
- * @version   1.0
+ * @version   1.1
  * @date      12.08.2017 -- 18.10.2017
  */
 #pragma once
@@ -24,6 +24,55 @@
  */
 namespace odt {
 
+/**
+ * @struct Style
+ * @brief
+ *     Compiled automatic style
+ * @details
+ *     Style properties are read once from `office:automatic-styles`, text tags and CSS of
+ *     paragraph are precomputed
+ */
+struct Style {
+	/** Header tag (h2, h3, p) based on parent style name */
+	std::string m_header;
+	/** Text style tags (b, i, u, s, sub, sup) */
+	std::vector<std::string> m_textTagList;
+	/** Font family */
+	std::string m_fontFamily;
+	/** Font size */
+	std::string m_fontSize;
+	/** Text color */
+	std::string m_color;
+	/** Background color */
+	std::string m_background;
+	/** Hidden text */
+	bool m_isHidden = false;
+	/** Text align */
+	std::string m_textAlign;
+	/** Padding values (all, left, right, top, bottom) */
+	std::string m_paddingList[5];
+	/** Border values (all, top, left, right, bottom) */
+	std::string m_borderList[5];
+	/** Minimum table row height */
+	std::string m_minRowHeight;
+	/** Vertical align of table cell */
+	std::string m_verticalAlign;
+	/** Precomputed CSS of paragraph */
+	std::string m_css;
+};
+
+/**
+ * @struct ListLevel
+ * @brief
+ *     Compiled list style level
+ */
+struct ListLevel {
+	/** List tag (ul, ol) */
+	std::string m_tagName = "ul";
+	/** Precomputed CSS (list style type) */
+	std::string m_css;
+};
+
 /**
  * @class Odt
  * @brief
@@ -60,6 +109,8 @@ private:
 	/**
 	 * @brief
 	 *     Get style from `content.xml`
+	 * @details
+	 *     Every automatic style is compiled once into @ref Style record
 	 * @param[in] tree
 	 *     XML document content
 	 * @since 1.0
@@ -72,6 +123,48 @@ private:
 	 * @since 1.0
 	 */
 	void getListStyleMap();
+
+	/**
+	 * @brief
+	 *     Read style properties from style element and its children
+	 * @param[in] node
+	 *     XML `style:style` node
+	 * @param[out] style
+	 *     Compiled style
+	 * @since 1.1
+	 */
+	static void readStyle(const pugi::xml_node& node, Style& style);
+
+	/**
+	 * @brief
+	 *     Read style properties from attributes of element
+	 * @param[in] node
+	 *     XML-node (`style:style` or its child)
+	 * @param[out] style
+	 *     Compiled style
+	 * @since 1.1
+	 */
+	static void readStyleAttributes(const pugi::xml_node& node, Style& style);
+
+	/**
+	 * @brief
+	 *     Read list style levels
+	 * @param[in] node
+	 *     XML `text:list-style` node
+	 * @since 1.1
+	 */
+	void readListStyle(const pugi::xml_node& node);
+
+	/**
+	 * @brief
+	 *     Get compiled style by name
+	 * @param[in] name
+	 *     Style name
+	 * @return
+	 *     Compiled style (empty style if name is unknown)
+	 * @since 1.1
+	 */
+	const Style& getStyle(const char* name) const;
 	/// @}
 
 	/// @name Building elements
@@ -216,15 +309,16 @@ private:
 
 	/**
 	 * @brief
-	 *     Add general parent and element style
-	 * @param[in] node
-	 *     XML-node
-	 * @param[out] styleMap
-	 *     Reference to style map
-	 * @since 1.0
+	 *     Get CSS of general properties (font, color, ...)
+	 * @param[in] style
+	 *     Compiled style
+	 * @param[in] parent
+	 *     Parent style (properties with the same value are skipped) or nullptr
+	 * @param[out] css
+	 *     CSS string
+	 * @since 1.1
 	 */
-	void addGeneralStyle(const std::string& key,
-						 std::unordered_map<std::string, std::string>& styleMap);
+	static void getGeneralCss(const Style& style, const Style* parent, std::string& css);
 
 	/**
 	 * @brief
@@ -269,12 +363,18 @@ private:
 	void addCellStyle(const pugi::xml_node& xmlNode, pugi::xml_node& htmlNode);
 	/// @}
 
-	/** Document style information */
-	std::unordered_map<std::string, std::unordered_map<std::string, std::string>> m_styleMap;
-	/** List style information */
-	std::unordered_map<std::string, std::unordered_map<int, std::unordered_map<std::string, std::string>>> m_listStyleMap;
-	/** Stores table border style */
-	std::unordered_map<std::string, std::string> m_borderMap;
+	/** Compiled automatic styles */
+	std::unordered_map<std::string, Style> m_styleMap;
+	/** Compiled list styles (levels) */
+	std::unordered_map<std::string, std::vector<ListLevel>> m_listStyleMap;
+	/** Style of current table (borders are inherited by cells) */
+	const Style* m_tableStyle = nullptr;
+	/** Parent style of last span */
+	const Style* m_spanParent = nullptr;
+	/** Style of last span */
+	const Style* m_spanElement = nullptr;
+	/** CSS of last span (shared by spans with the same styles) */
+	std::string m_spanCss;
 };
 
 }  // End namespace
\ No newline at end of file
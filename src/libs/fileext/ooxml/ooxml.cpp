@@ -5,6 +5,7 @@
  * @author  dmryutov (dmryutov@gmail.com)
  * @date    01.01.2017 -- 18.10.2017
  */
+#include <fstream>
 #include <iostream>
 
 #include "ooxml.hpp"
@@ -12,6 +13,7 @@
 
 namespace ooxml {
 
+// Ooxml public:
 void Ooxml::extractFile(const std::string& zipName, const std::string& fileName,
 						pugi::xml_document& tree)
 {
@@ -38,7 +40,7 @@ void Ooxml::extractFile(const std::string& zipName, const std::string& fileName,
 }
 
 
-// private:
+// Ooxml private:
 void* Ooxml::getFileContent(const std::string& zipName, const std::string& fileName,
 							mz_zip_archive* zipArchive, size_t& size)
 {
@@ -66,4 +68,84 @@ void Ooxml::clear(mz_zip_archive* zipArchive, void* content) {
 	mz_zip_reader_end(zipArchive);
 }
 
+
+// FileReader public:
+FileReader::FileReader(const std::string& zipName, const std::string& fileName) {
+	memset(&m_zipArchive, 0, sizeof(m_zipArchive));
+	if (!mz_zip_reader_init_file(&m_zipArchive, zipName.c_str(), 0)) {
+		std::cerr << "std::invalid_argument: Invalid zip file!" << std::endl;
+		return;
+	}
+	m_state = mz_zip_reader_extract_file_iter_new(&m_zipArchive, fileName.c_str(), 0);
+	if (!m_state)
+		std::cerr << "std::logic_error: File extracting error!" << std::endl;
+}
+
+FileReader::~FileReader() {
+	if (m_state)
+		mz_zip_reader_extract_iter_free(m_state);
+	mz_zip_reader_end(&m_zipArchive);
+}
+
+size_t FileReader::read(char* buffer, size_t size) {
+	if (!m_state)
+		return 0;
+	return mz_zip_reader_extract_iter_read(m_state, buffer, size);
+}
+
+
+
+// Archive public:
+Archive::Archive(const std::string& zipName)
+	: m_file(zipName)
+{
+	const char* data = m_file.data();
+	size_t size      = m_file.size();
+	if (!data) {
+		std::ifstream inputFile(zipName, std::ios::binary);
+		m_data.assign(std::istreambuf_iterator<char>(inputFile), std::istreambuf_iterator<char>());
+		data = m_data.data();
+		size = m_data.size();
+	}
+
+	memset(&m_zipArchive, 0, sizeof(m_zipArchive));
+	m_isOpen = mz_zip_reader_init_mem(&m_zipArchive, data, size, 0);
+	if (!m_isOpen)
+		std::cerr << "std::invalid_argument: Invalid zip file!" << std::endl;
+}
+
+Archive::~Archive() {
+	if (m_isOpen)
+		mz_zip_reader_end(&m_zipArchive);
+}
+
+bool Archive::extractFile(const std::string& fileName, std::string& buffer) const {
+	buffer.clear();
+	mz_uint32 index;
+	mz_zip_archive_file_stat fileStat;
+	if (!m_isOpen ||
+		!mz_zip_reader_locate_file_v2(&m_zipArchive, fileName.c_str(), nullptr, 0, &index) ||
+		!mz_zip_reader_file_stat(&m_zipArchive, index, &fileStat)
+	)
+		return false;
+
+	// Inflate directly into buffer
+	buffer.resize(static_cast<size_t>(fileStat.m_uncomp_size));
+	if (!buffer.empty() &&
+		!mz_zip_reader_extract_to_mem(&m_zipArchive, index, &buffer[0], buffer.size(), 0)
+	) {
+		buffer.clear();
+		return false;
+	}
+	return true;
+}
+
+bool Archive::extractFile(const std::string& fileName, pugi::xml_document& tree) const {
+	std::string buffer;
+	if (!extractFile(fileName, buffer))
+		return false;
+	tree.load_buffer(buffer.data(), buffer.size());
+	return true;
+}
+
 }  // End namespace
\ No newline at end of file
@@ -3,7 +3,7 @@
  * @package ooxml
  * @file    ooxml.hpp
  * @author  dmryutov (dmryutov@gmail.com)
- * @version 1.1
+ * @version 1.2
  * @date    01.01.2017 -- 18.10.2017
  */
 #pragma once
@@ -12,6 +12,7 @@
 
 #include "../../miniz/miniz.h"
 #include "../../pugixml/pugixml.hpp"
+#include "../../tools.hpp"
 
 
 /**
@@ -101,4 +102,108 @@ private:
 	static void clear(mz_zip_archive* zipArchive, void* content);
 };
 
+/**
+ * @class FileReader
+ * @brief
+ *     Incremental reader of file from archive
+ * @details
+ *     File is inflated block by block, so its content is never held in memory as a whole
+ */
+class FileReader {
+public:
+	/**
+	 * @param[in] zipName
+	 *     Archive path
+	 * @param[in] fileName
+	 *     Extracting file name
+	 * @since 1.2
+	 */
+	FileReader(const std::string& zipName, const std::string& fileName);
+
+	/** Destructor */
+	~FileReader();
+
+	FileReader(const FileReader&) = delete;
+	FileReader& operator=(const FileReader&) = delete;
+
+	/**
+	 * @brief
+	 *     Read next block of extracted file
+	 * @param[out] buffer
+	 *     Output buffer
+	 * @param[in] size
+	 *     Buffer size
+	 * @return
+	 *     Number of read bytes (0 if file is over or can not be extracted)
+	 * @since 1.2
+	 */
+	size_t read(char* buffer, size_t size);
+
+private:
+	/** Archive handler */
+	mz_zip_archive m_zipArchive;
+	/** Extracting state (nullptr if file can not be extracted) */
+	mz_zip_reader_extract_iter_state* m_state = nullptr;
+};
+
+/**
+ * @class Archive
+ * @brief
+ *     Archive which is opened once and read from memory
+ * @details
+ *     Archive file is memory-mapped and its central directory is read once. Files can be
+ *     extracted from several threads at the same time.
+ */
+class Archive {
+public:
+	/**
+	 * @param[in] zipName
+	 *     Archive path
+	 * @since 1.2
+	 */
+	Archive(const std::string& zipName);
+
+	/** Destructor */
+	~Archive();
+
+	Archive(const Archive&) = delete;
+	Archive& operator=(const Archive&) = delete;
+
+	/**
+	 * @brief
+	 *     Extract file and put its content into string buffer
+	 * @param[in] fileName
+	 *     Extracting file name
+	 * @param[out] buffer
+	 *     String buffer, where you need to put the data from extracted file
+	 * @return
+	 *     True if file was extracted
+	 * @since 1.2
+	 */
+	bool extractFile(const std::string& fileName, std::string& buffer) const;
+
+	/**
+	 * @brief
+	 *     Extract file and put its content into XML-tree
+	 * @param[in] fileName
+	 *     Extracting file name
+	 * @param[out] tree
+	 *     XML-tree, where you need to put the data from extracted file
+	 * @return
+	 *     True if file was extracted
+	 * @since 1.2
+	 */
+	bool extractFile(const std::string& fileName, pugi::xml_document& tree) const;
+
+private:
+	/** Memory-mapped archive */
+	tools::MappedFile m_file;
+	/** Archive content (if file can not be mapped) */
+	std::string m_data;
+	/** Archive handler (reading from memory does not change it) */
+	mutable mz_zip_archive m_zipArchive;
+	/** True if archive was opened */
+	bool m_isOpen = false;
+};
+
 }  // End namespace
\ No newline at end of file
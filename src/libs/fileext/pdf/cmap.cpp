@@ -0,0 +1,124 @@
+/**
+ * @brief     PDF files into HTML сonverter
+ * @package   pdf
+ * @file      cmap.cpp
+ * @author    dmryutov (dmryutov@gmail.com)
+ * @date      18.10.2026 -- 18.10.2026
+ */
+#include <algorithm>
+
+#include "../../encoding/encoding.hpp"
+
+#include "cmap.hpp"
+
+
+namespace pdf {
+
+/** Max length of range which is stored as separate chars */
+const unsigned int MAX_EXPANDED_RANGE = 0x10000;
+
+// public:
+void CMap::addChar(unsigned int code, const std::string& value) {
+	m_charList.emplace_back(code, toUtf8(value));
+}
+
+void CMap::addRange(unsigned int from, unsigned int to, const std::string& value) {
+	if (from > to)
+		return;
+
+	// Single UTF-16 unit (not surrogate) is stored as arithmetic sequence
+	if (value.size() <= 4) {
+		unsigned int target = static_cast<unsigned int>(strtoul(value.c_str(), nullptr, 16));
+		if (target < 0xD800 || target > 0xDFFF) {
+			m_rangeList.push_back({from, to, target});
+			return;
+		}
+	}
+	// Otherwise every char is stored separately
+	for (unsigned int code = from; code <= to && code - from < MAX_EXPANDED_RANGE; ++code)
+		m_charList.emplace_back(code, toUtf8(value, code - from));
+}
+
+void CMap::build() {
+	// Later transformations override earlier ones
+	std::stable_sort(m_charList.begin(), m_charList.end(),
+					 [](const std::pair<unsigned int, std::string>& a,
+						const std::pair<unsigned int, std::string>& b) { return a.first < b.first; });
+	size_t count = 0;
+	for (size_t i = 0; i < m_charList.size(); ++i) {
+		if (i + 1 < m_charList.size() && m_charList[i + 1].first == m_charList[i].first)
+			continue;
+		if (count != i)
+			m_charList[count] = std::move(m_charList[i]);
+		++count;
+	}
+	m_charList.resize(count);
+	m_charList.shrink_to_fit();
+
+	std::stable_sort(m_rangeList.begin(), m_rangeList.end(),
+					 [](const Range& a, const Range& b) { return a.m_from < b.m_from; });
+	m_rangeList.shrink_to_fit();
+}
+
+bool CMap::decode(unsigned int code, std::string& output) const {
+	// Sequences are processed after single chars, so they have priority
+	auto range = std::upper_bound(m_rangeList.begin(), m_rangeList.end(), code,
+								  [](unsigned int c, const Range& r) { return c < r.m_from; });
+	if (range != m_rangeList.begin() && code <= (--range)->m_to) {
+		encoding::appendUtf8(output, range->m_target + code - range->m_from);
+		return true;
+	}
+
+	auto item = std::lower_bound(m_charList.begin(), m_charList.end(), code,
+								 [](const std::pair<unsigned int, std::string>& c, unsigned int v) {
+									 return c.first < v;
+								 });
+	if (item != m_charList.end() && item->first == code) {
+		output += item->second;
+		return true;
+	}
+	return false;
+}
+
+bool CMap::empty() const {
+	return m_charList.empty() && m_rangeList.empty();
+}
+
+bool CMap::operator==(const CMap& other) const {
+	if (m_charList != other.m_charList || m_rangeList.size() != other.m_rangeList.size())
+		return false;
+	for (size_t i = 0; i < m_rangeList.size(); ++i) {
+		const Range& a = m_rangeList[i];
+		const Range& b = other.m_rangeList[i];
+		if (a.m_from != b.m_from || a.m_to != b.m_to || a.m_target != b.m_target)
+			return false;
+	}
+	return true;
+}
+
+
+// private:
+std::string CMap::toUtf8(const std::string& value, unsigned int offset) const {
+	// Split to UTF-16 units
+	std::vector<unsigned int> unitList;
+	for (size_t i = 0; i < value.size(); i += 4)
+		unitList.push_back(static_cast<unsigned int>(strtoul(value.substr(i, 4).c_str(), nullptr, 16)));
+	if (unitList.empty())
+		return "";
+	unitList.back() += offset;
+
+	std::string result;
+	for (size_t i = 0; i < unitList.size(); ++i) {
+		unsigned int unit = unitList[i];
+		// Surrogate pair
+		if (unit >= 0xD800 && unit <= 0xDBFF && i + 1 < unitList.size() &&
+			unitList[i + 1] >= 0xDC00 && unitList[i + 1] <= 0xDFFF)
+		{
+			unit = 0x10000 + ((unit - 0xD800) << 10) + (unitList[++i] - 0xDC00);
+		}
+		encoding::appendUtf8(result, unit);
+	}
+	return result;
+}
+
+}  // End namespace
@@ -0,0 +1,124 @@
+/**
+ * @brief     PDF files into HTML сonverter
+ * @package   pdf
+ * @file      cmap.hpp
+ * @author    dmryutov (dmryutov@gmail.com)
+ * @version   1.0
+ * @date      18.10.2026 -- 18.10.2026
+ */
+#pragma once
+
+#include <string>
+#include <utility>
+#include <vector>
+
+
+namespace pdf {
+
+/**
+ * @class CMap
+ * @brief
+ *     ToUnicode character map. Maps numeric char codes to UTF-8 text
+ */
+class CMap {
+public:
+	/**
+	 * @brief
+	 *     Add transformation of single char (`bfchar`)
+	 * @param[in] code
+	 *     Char code
+	 * @param[in] value
+	 *     Hex-representation of UTF-16BE text
+	 * @since 1.0
+	 */
+	void addChar(unsigned int code, const std::string& value);
+
+	/**
+	 * @brief
+	 *     Add transformation of char sequence (`bfrange`)
+	 * @param[in] from
+	 *     First char code
+	 * @param[in] to
+	 *     Last char code
+	 * @param[in] value
+	 *     Hex-representation of UTF-16BE text for first char (last unit is incremented
+	 *     for each next char)
+	 * @since 1.0
+	 */
+	void addRange(unsigned int from, unsigned int to, const std::string& value);
+
+	/**
+	 * @brief
+	 *     Prepare tables for lookup. Should be called after all transformations are added
+	 * @since 1.0
+	 */
+	void build();
+
+	/**
+	 * @brief
+	 *     Decode char code
+	 * @param[in] code
+	 *     Char code
+	 * @param[out] output
+	 *     UTF-8 text (appended)
+	 * @return
+	 *     True if code has transformation
+	 * @since 1.0
+	 */
+	bool decode(unsigned int code, std::string& output) const;
+
+	/**
+	 * @brief
+	 *     Check if map has no transformations
+	 * @return
+	 *     True if map is empty
+	 * @since 1.0
+	 */
+	bool empty() const;
+
+	/**
+	 * @brief
+	 *     Compare transformations of two maps
+	 * @param[in] other
+	 *     Other map
+	 * @return
+	 *     True if maps are equal
+	 * @since 1.0
+	 */
+	bool operator==(const CMap& other) const;
+
+private:
+	/**
+	 * @class Range
+	 * @brief
+	 *     Sequence of chars which are mapped to sequence of code points
+	 */
+	struct Range {
+		/** First char code */
+		unsigned int m_from;
+		/** Last char code */
+		unsigned int m_to;
+		/** Code point of first char */
+		unsigned int m_target;
+	};
+
+	/**
+	 * @brief
+	 *     Convert hex-representation of UTF-16BE text to UTF-8
+	 * @param[in] value
+	 *     Hex-representation of UTF-16BE text
+	 * @param[in] offset
+	 *     Number which is added to last UTF-16 unit
+	 * @return
+	 *     UTF-8 text
+	 * @since 1.0
+	 */
+	std::string toUtf8(const std::string& value, unsigned int offset = 0) const;
+
+	/** Single char transformations (sorted by code) */
+	std::vector<std::pair<unsigned int, std::string>> m_charList;
+	/** Sequence transformations (sorted by first code) */
+	std::vector<Range> m_rangeList;
+};
+
+}  // End namespace
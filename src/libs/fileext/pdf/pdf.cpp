@@ -7,6 +7,7 @@
  * @date      06.08.2017 -- 29.01.2018
  */
 #include <math.h>
+#include <algorithm>
 #include <fstream>
 #include <regex>
 
@@ -17,6 +18,11 @@
 
 #include "pdf.hpp"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#include <emmintrin.h>
+	#define PDF_USE_SSE2
+#endif
+
 
 namespace pdf {
 
@@ -24,17 +30,43 @@ namespace pdf {
 const std::regex OBJECT_MASK("([0-9]+\\s*[0-9]+\\s*)obj((.|\n|\r)*?)endobj", std::regex::icase);
 const std::regex STREAM_MASK("stream((.|\n|\r)*?)endstream", std::regex::icase);
 const std::regex OPTIONS_MASK("<<((.|\n|\r)*?)>>", std::regex::icase);
-const std::regex BT_ET_MASK("BT((.|\n|\r)*?)ET", std::regex::icase);
-const std::regex TJ_FONT_MASK("\\/F[a-z]*([0-9]+)((.|\n|\r)*?)\\[((.|\n|\r)*?)\\]\\s*TJ", std::regex::icase);
-const std::regex TJ_MASK("\\[((.|\n|\r)*?)\\]\\s*TJ", std::regex::icase);
-const std::regex TD_TJ_MASK("Td\\s*\\/F[a-z]*([0-9]+)((.|\n|\r)*?)(\\((.|\n|\r)*?\\))\\s*Tj");
-const std::regex CHAR_MASK("([0-9]+)\\s+beginbfchar((.|\n|\r)*?)endbfchar", std::regex::icase);
-const std::regex CHAR_TYPE1_MASK("<([0-9a-fA-F]{2,4})>\\s+<([0-9a-fA-F]{4,512})>", std::regex::icase);
-const std::regex RANGE_MASK("([0-9]+)\\s+beginbfrange((.|\n|\r)*?)endbfrange", std::regex::icase);
-const std::regex RANGE_TYPE1_MASK("<([0-9a-fA-F]{1,4})>\\s*<([0-9a-fA-F]{1,4})>\\s*<([0-9a-fA-F]{1,4})>", std::regex::icase);
-const std::regex RANGE_TYPE2_MASK("<([0-9a-fA-F]{1,4})>\\s*<([0-9a-fA-F]{1,4})>\\s*\\[(.*?)\\]", std::regex::icase);
 const std::regex SPEC_CHAR_MASK("\\s+");
 const std::regex TEXT_CHAR_MASK("[^0-9]");
+/** Size of output chunk for inflating */
+const unsigned int INFLATE_CHUNK_SIZE = 65536;
+/** Max trusted ratio of decoded size hint (`/DL`) to encoded stream size */
+const size_t MAX_SIZE_HINT_RATIO = 64;
+
+/**
+ * @brief
+ *     Compress PNG data with fastest deflate level (custom zlib function of LodePNG)
+ * @param[out] out
+ *     Compressed data (allocated with `malloc`)
+ * @param[out] outSize
+ *     Compressed data size
+ * @param[in] in
+ *     Input data
+ * @param[in] inSize
+ *     Input data size
+ * @return
+ *     Error code (0 if no errors)
+ * @since 1.1
+ */
+unsigned compressFast(unsigned char** out, size_t* outSize, const unsigned char* in,
+					  size_t inSize, const LodePNGCompressSettings*)
+{
+	mz_ulong size = mz_compressBound(inSize);
+	*out = (unsigned char*)malloc(size);
+	if (!*out)
+		return 83;  // LodePNG "memory allocation failed"
+	if (mz_compress2(*out, &size, in, inSize, MZ_BEST_SPEED) != MZ_OK) {
+		free(*out);
+		*out = nullptr;
+		return 111;  // LodePNG "deflate error"
+	}
+	*outSize = size;
+	return 0;
+}
 
 // public:
 Pdf::Pdf(const std::string& fileName)
@@ -86,9 +118,18 @@ void Pdf::convert(bool addStyle, bool extractImages, char mergingMode) {
 				// transformations that will be used in the second step
 				bool hasDirtyText = getDirtyTextList(streamData);
 				if (!hasDirtyText) {
-					std::unordered_map<std::string, std::string> tList;
-					getTransformationList(streamData, tList);
-					m_transformationList[optionList["OBJECT_ID"]] = tList;
+					std::shared_ptr<CMap> cmap = std::make_shared<CMap>();
+					getTransformationList(streamData, *cmap);
+					// Fonts with identical char maps share one table
+					auto& cached = m_cmapCache[std::hash<std::string>()(streamData)];
+					if (cached && *cached == *cmap) {
+						m_transformationList[optionList["OBJECT_ID"]] = cached;
+					}
+					else {
+						if (!cached)
+							cached = cmap;
+						m_transformationList[optionList["OBJECT_ID"]] = cmap;
+					}
 				}
 			}
 		}
@@ -121,6 +162,10 @@ void Pdf::convert(bool addStyle, bool extractImages, char mergingMode) {
 }
 
 
+void Pdf::setFastImageMode(bool fastImageMode) {
+	m_fastImageMode = fastImageMode;
+}
+
 // private:
 void Pdf::getObjectOptionList(const std::string& object,
 							  std::unordered_map<std::string, std::string>& optionList) const
@@ -141,6 +186,37 @@ void Pdf::getObjectOptionList(const std::string& object,
 				optionList[tempOptionList[i]] = "true";
 		}
 	}
+
+	// Filters should be applied in declared order, so save them as list of names
+	size_t end = object.find("stream");
+	size_t pos = object.find("/Filter");
+	if (pos == std::string::npos || pos > end)
+		return;
+	pos = object.find_first_not_of(" \t\n\r\f", pos + 7);
+	if (pos == std::string::npos)
+		return;
+	bool isArray = object[pos] == '[';
+	std::string filterList;
+	while (pos < object.size() && (object[pos] == '/' || isArray)) {
+		if (object[pos] == ']')
+			break;
+		if (object[pos] == '/') {
+			size_t nameEnd = object.find_first_of(" \t\n\r\f/[]<>()", pos + 1);
+			if (nameEnd == std::string::npos)
+				nameEnd = object.size();
+			if (!filterList.empty())
+				filterList += ' ';
+			filterList += object.substr(pos + 1, nameEnd - pos - 1);
+			pos = nameEnd;
+		}
+		else {
+			++pos;
+		}
+		if (!isArray)
+			break;
+	}
+	if (!filterList.empty())
+		optionList["Filter"] = filterList;
 }
 
 std::string Pdf::decodeStream(const std::string& stream,
@@ -160,20 +236,19 @@ std::string Pdf::decodeStream(const std::string& stream,
 					 : static_cast<int>(stream.size());
 		data = stream.substr(0, length);
 
-		// Find option with instructions for compressing data in current stream and apply
-		// corresponding functions for decoding. PDF supports a lot of methods, but text is
-		// encoded in three ways: ASCII Hex, ASCII 85-base, GZ/Deflate.
-		for (const auto& option : optionList) {
-			std::string optionName = option.first;
-			if (optionName == "ASCIIHexDecode")
+		// Apply decoding functions in order in which filters are declared. PDF supports a lot
+		// of methods, but text is encoded in three ways: ASCII Hex, ASCII 85-base, GZ/Deflate.
+		// `DL` option (if exists) is a size of decoded data
+		size_t sizeHint = (optionList.find("DL") != optionList.end())
+						  ? strtoul(optionList["DL"].c_str(), nullptr, 10) : 0;
+		for (const auto& filter : tools::explode(optionList["Filter"], ' ')) {
+			if (filter == "ASCIIHexDecode")
 				data = decodeAsciiHex(data);
-			else if (optionName == "ASCII85Decode")
+			else if (filter == "ASCII85Decode")
 				data = decodeAscii85(data);
-			else if (optionName == "FlateDecode" || optionName == "FlateDecode]") {
-				//std::cout << optionName << " " << optionList["Image"] << std::endl << std::endl;
-				data = decodeFlate(data);
-			}
-			else if (optionName == "CCITTFaxDecode")
+			else if (filter == "FlateDecode")
+				data = decodePredictor(decodeFlate(data, sizeHint), optionList);
+			else if (filter == "CCITTFaxDecode")
 				data = decodeCcittFax(data, optionList);
 		}
 	}
@@ -205,8 +280,8 @@ std::string Pdf::decodeAsciiHex(const std::string& input) const {
 				isComment = true;
 				break;
 			default: {
-				int code = tools::hexCharToDec(c);
-				if (code == 0 && c != '0')
+				int code = tools::hexCharToDec(toupper(c));
+				if (code < 0)
 					return "";
 
 				if (isOdd)
@@ -280,24 +355,109 @@ std::string Pdf::decodeAscii85(const std::string& input) const {
 	return result;
 }
 
-std::string Pdf::decodeFlate(const std::string& input) const {
-	unsigned long  originalLength = (unsigned char)input.size();
-	unsigned long  decodedLength  = originalLength * 2;
-	unsigned char* originalString = (unsigned char*)input.c_str();
-	unsigned char* decodedString  = (unsigned char*)malloc(decodedLength);
-
-	int status = uncompress(decodedString, &decodedLength, originalString, originalLength);
-	while (status == -5) {
-		decodedLength *= 2;
-		decodedString = (unsigned char*)realloc(decodedString, decodedLength);
-		status = uncompress(decodedString, &decodedLength, originalString, originalLength);
+std::string Pdf::decodeFlate(const std::string& input, size_t sizeHint) const {
+	std::string result;
+	mz_stream stream;
+	memset(&stream, 0, sizeof(stream));
+	if (mz_inflateInit(&stream) != MZ_OK)
+		return result;
+
+	// Inflate stream once, appending each output chunk to result
+	// Size hint comes from file => do not trust it more than reasonable compression ratio
+	if (sizeHint)
+		result.reserve(std::min(sizeHint, input.size() * MAX_SIZE_HINT_RATIO));
+	else
+		result.reserve(input.size() * 4);
+	unsigned char buffer[INFLATE_CHUNK_SIZE];
+	stream.next_in  = (const unsigned char*)input.data();
+	stream.avail_in = static_cast<unsigned int>(input.size());
+	int status;
+	do {
+		stream.next_out  = buffer;
+		stream.avail_out = INFLATE_CHUNK_SIZE;
+		status = mz_inflate(&stream, MZ_SYNC_FLUSH);
+		result.append((char*)buffer, INFLATE_CHUNK_SIZE - stream.avail_out);
+	} while (status == MZ_OK);
+
+	// Truncated or corrupted streams are common. Keep everything that was decoded
+	mz_inflateEnd(&stream);
+	return result;
+}
+
+std::string Pdf::decodePredictor(const std::string& input,
+								 std::unordered_map<std::string, std::string>& optionList) const
+{
+	int predictor = getIntOption(optionList, "Predictor", 1);
+	int colors    = getIntOption(optionList, "Colors", 1);
+	int bits      = getIntOption(optionList, "BitsPerComponent", 8);
+	int columns   = getIntOption(optionList, "Columns", 1);
+	if (predictor < 2 || colors < 1 || bits < 1 || columns < 1)
+		return input;
+
+	size_t pixelSize = std::max(1, colors * bits / 8);
+	size_t rowSize   = (static_cast<size_t>(colors) * bits * columns + 7) / 8;
+
+	// TIFF predictor 2 (only 8 bits per component)
+	if (predictor == 2) {
+		if (bits != 8)
+			return input;
+		std::string result = input;
+		for (size_t row = 0; row + rowSize <= result.size(); row += rowSize) {
+			for (size_t i = pixelSize; i < rowSize; ++i)
+				result[row + i] += result[row + i - pixelSize];
+		}
+		return result;
 	}
 
-	std::string result(decodedString, decodedString + decodedLength);
-	free(decodedString);
+	// PNG predictors. Every row starts with byte of filter type
+	std::string result;
+	result.reserve(input.size() / (rowSize + 1) * rowSize);
+	std::vector<unsigned char> prior(rowSize, 0);
+	std::vector<unsigned char> current(rowSize);
+	for (size_t pos = 0; pos + rowSize < input.size(); pos += rowSize + 1) {
+		unsigned char type = input[pos];
+		const unsigned char* row = (const unsigned char*)input.data() + pos + 1;
+		for (size_t i = 0; i < rowSize; ++i) {
+			int left    = (i >= pixelSize) ? current[i - pixelSize] : 0;
+			int up      = prior[i];
+			int upLeft  = (i >= pixelSize) ? prior[i - pixelSize] : 0;
+			switch (type) {
+				case 1:  // Sub
+					current[i] = row[i] + left;
+					break;
+				case 2:  // Up
+					current[i] = row[i] + up;
+					break;
+				case 3:  // Average
+					current[i] = row[i] + (left + up) / 2;
+					break;
+				case 4: {  // Paeth
+					int p  = left + up - upLeft;
+					int pa = abs(p - left);
+					int pb = abs(p - up);
+					int pc = abs(p - upLeft);
+					current[i] = row[i] + ((pa <= pb && pa <= pc) ? left : (pb <= pc) ? up : upLeft);
+					break;
+				}
+				default:  // None
+					current[i] = row[i];
+			}
+		}
+		result.append(current.begin(), current.end());
+		prior.swap(current);
+	}
 	return result;
 }
 
+int Pdf::getIntOption(std::unordered_map<std::string, std::string>& optionList,
+					  const std::string& name, int defaultValue) const
+{
+	auto option = optionList.find(name);
+	if (option == optionList.end())
+		return defaultValue;
+	return atoi(option->second.c_str());
+}
+
 std::string Pdf::decodeCcittFax(const std::string& input,
 								std::unordered_map<std::string, std::string>& optionList) const
 {
@@ -330,82 +490,224 @@ std::string Pdf::decodeCcittFax(const std::string& input,
 	return header + input;
 }
 
-bool Pdf::getDirtyTextList(std::string stream) {
+bool Pdf::getDirtyTextList(const std::string& stream) {
 	bool hasDirtyText = false;
-	std::smatch containerList;
-	// Extract text containers from pair `BT`-`ET`
-	while (std::regex_search(stream, containerList, BT_ET_MASK)) {
-		std::string res = containerList[1];
-		std::smatch partList;
-		// Find text that is displayed by PDF-viewers on the screen. There are many variants,
-		// but consider a pair: `[...] TJ` and `Td (...) Tj`
-		if (std::regex_search(res, partList, TJ_FONT_MASK))
-			m_textList.emplace_back(partList[4], partList[1]);
-		else if (std::regex_search(res, partList, TJ_MASK))
-			m_textList.emplace_back(partList[1], "1");
-		else if (std::regex_search(res, partList, TD_TJ_MASK))
-			m_textList.emplace_back(partList[4], partList[1]);
-
-		hasDirtyText = true;
-		stream = containerList.suffix().str();
+	// Text operators are processed only inside of `BT`-`ET` container
+	bool isText = false;
+	// True if text can be added to last item of text list (same container and font)
+	bool canAppend = false;
+	std::string font = "1";
+	std::string lastName;
+	// Position of last string/array operand
+	size_t operandBegin = 0;
+	size_t operandEnd   = 0;
+
+	size_t size = stream.size();
+	size_t pos  = 0;
+	while (pos < size) {
+		char c = stream[pos];
+		switch (c) {
+			case '\0': case '\t': case '\n': case '\f': case '\r': case ' ':
+				++pos;
+				break;
+			// Comment
+			case '%':
+				pos = stream.find_first_of("\r\n", pos);
+				break;
+			// Literal string
+			case '(':
+				operandBegin = pos;
+				pos = operandEnd = skipString(stream, pos);
+				break;
+			// Hex string or dictionary
+			case '<':
+				if (pos + 1 < size && stream[pos + 1] == '<') {
+					pos += 2;
+				}
+				else {
+					operandBegin = pos;
+					pos = stream.find('>', pos);
+					pos = operandEnd = (pos == std::string::npos) ? size : pos + 1;
+				}
+				break;
+			// Array (only contents are needed)
+			case '[': {
+				size_t end = pos + 1;
+				while (end < size && stream[end] != ']') {
+					if (stream[end] == '(') {
+						end = skipString(stream, end);
+					}
+					else if (stream[end] == '<') {
+						end = stream.find('>', end);
+						end = (end == std::string::npos) ? size : end + 1;
+					}
+					else {
+						++end;
+					}
+				}
+				operandBegin = pos + 1;
+				operandEnd   = end;
+				pos = end + 1;
+				break;
+			}
+			case '>': case ']': case ')': case '{': case '}':
+				++pos;
+				break;
+			// Name
+			case '/': {
+				size_t end = skipToken(stream, pos + 1);
+				lastName.assign(stream, pos + 1, end - pos - 1);
+				pos = end;
+				break;
+			}
+			// Number or operator
+			default: {
+				size_t end = skipToken(stream, pos + 1);
+				const char* token = stream.c_str() + pos;
+				size_t length = end - pos;
+				pos = end;
+				if (isdigit(c) || c == '-' || c == '+' || c == '.')
+					break;
+
+				if (length == 2 && token[0] == 'B' && token[1] == 'T') {
+					isText    = true;
+					canAppend = false;
+				}
+				else if (length == 2 && token[0] == 'E' && token[1] == 'T') {
+					isText = false;
+				}
+				else if (length == 2 && token[0] == 'T' && token[1] == 'f') {
+					font = getFontNumber(lastName);
+					canAppend = false;
+				}
+				else if (isText && operandEnd > operandBegin &&
+						 ((length == 2 && token[0] == 'T' && (token[1] == 'j' || token[1] == 'J')) ||
+						  (length == 1 && (token[0] == '\'' || token[0] == '"'))))
+				{
+					if (canAppend)
+						m_textList.back().first.append(stream, operandBegin, operandEnd - operandBegin);
+					else
+						m_textList.emplace_back(stream.substr(operandBegin, operandEnd - operandBegin), font);
+					canAppend    = true;
+					hasDirtyText = true;
+				}
+				// Inline image: skip binary data between `ID` and `EI`
+				else if (length == 2 && token[0] == 'I' && token[1] == 'D') {
+					pos = stream.find("EI", pos + 1);
+					while (pos != std::string::npos && !isspace(stream[pos - 1]))
+						pos = stream.find("EI", pos + 2);
+					pos = (pos == std::string::npos) ? size : pos + 2;
+				}
+				operandBegin = operandEnd = 0;
+			}
+		}
 	}
 
 	return hasDirtyText;
 }
 
-void Pdf::getTransformationList(const std::string& stream,
-								std::unordered_map<std::string, std::string>& transformationList) const
-{
-	std::smatch sm, sm2;
-	// Individual chars
-	std::string data = stream;
-	while (std::regex_search(data, sm, CHAR_MASK)) {
-		// Before the data there is a number indicating the number of lines to read.
-		// Take it into account
-		size_t count = stoi(sm[1]);
-		std::vector<std::string> current = tools::explode(tools::trim(sm[2]), '\n');
-		// Read line by line
-		for (size_t k = 0; k < count && k < current.size(); ++k) {
-			std::string str = tools::trim(current[k]);
-			if (std::regex_search(str, sm2, CHAR_TYPE1_MASK))
-				transformationList[tools::rpad(sm2[1], 4, '0')] = sm2[2];
+size_t Pdf::skipString(const std::string& stream, size_t pos) const {
+	// Strings can contain balanced pairs of parentheses and escaped chars
+	int depth = 0;
+	for (size_t size = stream.size(); pos < size; ++pos) {
+		char c = stream[pos];
+		if (c == '\\')
+			++pos;
+		else if (c == '(')
+			++depth;
+		else if (c == ')' && --depth == 0)
+			return pos + 1;
+	}
+	return stream.size();
+}
+
+size_t Pdf::skipToken(const std::string& stream, size_t pos) const {
+	for (size_t size = stream.size(); pos < size; ++pos) {
+		switch (stream[pos]) {
+			case '\0': case '\t': case '\n': case '\f': case '\r': case ' ':
+			case '(': case ')': case '<': case '>': case '[': case ']':
+			case '{': case '}': case '/': case '%':
+				return pos;
 		}
-		data = sm.suffix().str();
+	}
+	return stream.size();
+}
+
+std::string Pdf::getFontNumber(const std::string& name) const {
+	// Font names look like `F1`, `Fa12` and so on
+	size_t pos = 1;
+	while (pos < name.size() && islower(name[pos]))
+		++pos;
+	if (name.empty() || name[0] != 'F' || pos == name.size() ||
+		name.find_first_not_of("0123456789", pos) != std::string::npos)
+		return "1";
+	return name.substr(pos);
+}
+
+void Pdf::getTransformationList(const std::string& stream, CMap& cmap) const {
+	std::string from;
+	std::string to;
+	std::string value;
+
+	// Individual chars
+	size_t pos = 0;
+	while ((pos = stream.find("beginbfchar", pos)) != std::string::npos) {
+		size_t end = stream.find("endbfchar", pos);
+		if (end == std::string::npos)
+			end = stream.size();
+		while (readHexString(stream, pos, end, from) && readHexString(stream, pos, end, value))
+			cmap.addChar(static_cast<unsigned int>(strtoul(from.c_str(), nullptr, 16)), value);
+		pos = end;
 	}
 
 	// Ranges
-	data = stream;
-	while (std::regex_search(data, sm, RANGE_MASK)) {
-		// Before the data there is a number indicating the number of lines to read
-		size_t count = stoi(sm[1]);
-		std::vector<std::string> current = tools::explode(tools::trim(sm[2]), '\n');
-		// Read line by line
-		for (size_t k = 0; k < count && k < current.size(); ++k) {
-			// Sequence of first type
-			std::string str = tools::trim(current[k]);
-			if (std::regex_search(str, sm2, RANGE_TYPE1_MASK)) {
-				// Convert data to decimal (it's easier to iterate)
-				int from  = std::stoi(sm2[1], nullptr, 16);
-				int to    = std::stoi(sm2[2], nullptr, 16);
-				int _from = std::stoi(sm2[3], nullptr, 16);
-
-				for (int m = from, n = 0; m <= to; ++m, ++n)
-					transformationList[tools::intToHex(m, 4)] = tools::intToHex(_from + n, 4);
-			}
+	pos = 0;
+	while ((pos = stream.find("beginbfrange", pos)) != std::string::npos) {
+		size_t end = stream.find("endbfrange", pos);
+		if (end == std::string::npos)
+			end = stream.size();
+		while (readHexString(stream, pos, end, from) && readHexString(stream, pos, end, to)) {
+			unsigned int first = static_cast<unsigned int>(strtoul(from.c_str(), nullptr, 16));
+			unsigned int last  = static_cast<unsigned int>(strtoul(to.c_str(), nullptr, 16));
+			size_t next = stream.find_first_not_of(" \t\n\r\f", pos);
 			// Sequence of second type
-			else if (std::regex_search(str, sm2, RANGE_TYPE1_MASK)) {
-				// Convert data to decimal (it's easier to iterate)
-				int from  = std::stoi(sm2[1], nullptr, 16);
-				int to    = std::stoi(sm2[2], nullptr, 16);
-				std::vector<std::string> parts = tools::explode(sm2[3], " \n\r\t\b\f", true);
-
-				for (int m = from, n = 0; m <= to && n < (int)parts.size(); ++m, ++n)
-					transformationList[tools::intToHex(m, 4)] = tools::intToHex(std::stoi(parts[n], nullptr, 16), 4);
+			if (next < end && stream[next] == '[') {
+				size_t arrayEnd = std::min(stream.find(']', next), end);
+				pos = next + 1;
+				for (unsigned int code = first; code <= last &&
+					 readHexString(stream, pos, arrayEnd, value); ++code)
+				{
+					cmap.addChar(code, value);
+				}
+				pos = (arrayEnd < end) ? arrayEnd + 1 : end;
+			}
+			// Sequence of first type
+			else if (readHexString(stream, pos, end, value)) {
+				cmap.addRange(first, last, value);
 			}
 		}
+		pos = end;
+	}
+	cmap.build();
+}
 
-		data = sm.suffix().str();
+bool Pdf::readHexString(const std::string& stream, size_t& pos, size_t end,
+						std::string& hex) const
+{
+	size_t begin = stream.find('<', pos);
+	if (begin >= end)
+		return false;
+	size_t last = stream.find('>', begin);
+	if (last >= end)
+		return false;
+
+	hex.clear();
+	for (size_t i = begin + 1; i < last; ++i) {
+		if (isxdigit(stream[i]))
+			hex += stream[i];
 	}
+	pos = last + 1;
+	return true;
 }
 
 void Pdf::getImages(std::string imageData,
@@ -426,41 +728,36 @@ void Pdf::getImages(std::string imageData,
 			 optionList.find("CCITTFaxDecode]") != optionList.end())
 		ext = "tiff";
 	else {
-		std::vector<unsigned char> png;
+		unsigned width  = getIntOption(optionList, "Width", 0);
+		unsigned height = getIntOption(optionList, "Height", 0);
+		size_t pixelCount = static_cast<size_t>(width) * height;
+		const unsigned char* pixels = (const unsigned char*)imageData.data();
 		std::vector<unsigned char> img;
+		unsigned channels = 0;
 		if (optionList.find("DeviceRGB") != optionList.end()) {
-			for (size_t i = 0; i < imageData.size(); ++i) {
-				img.emplace_back(imageData[i]);
-				if ((i + 1) % 3 == 0)
-					img.emplace_back(255);
-			}
+			if (imageData.size() >= pixelCount * 3)
+				channels = 3;
 		}
 		else if (optionList.find("DeviceGray") != optionList.end()) {
-			for (size_t i = 0; i < imageData.size(); ++i) {
-				char c = 255 - imageData[i];
-				img.emplace_back(c);
-				img.emplace_back(c);
-				img.emplace_back(c);
-				img.emplace_back(255);
+			if (imageData.size() >= pixelCount) {
+				img.resize(pixelCount);
+				invertGray(pixels, pixelCount, img.data());
+				pixels   = img.data();
+				channels = 1;
 			}
 		}
 		else if (optionList.find("DeviceCMYK") != optionList.end()) {
-			for (size_t i = 0; i < imageData.size(); i += 4) {
-				float c = (float)imageData[i] / 100;
-				float m = (float)imageData[i + 1] / 100;
-				float y = (float)imageData[i + 2] / 100;
-				float k = (float)imageData[i + 3];
-				c = c * (1 - k) + k;
-				m = m * (1 - k) + k;
-				y = y * (1 - k) + k;
-				img.emplace_back(static_cast<unsigned char>((1 - c) * 255));
-				img.emplace_back(static_cast<unsigned char>((1 - m) * 255));
-				img.emplace_back(static_cast<unsigned char>((1 - y) * 255));
-				img.emplace_back(255);
+			if (imageData.size() >= pixelCount * 4) {
+				img.resize(pixelCount * 4);
+				convertCmyk(pixels, pixelCount, img.data());
+				pixels   = img.data();
+				channels = 4;
 			}
 		}
-		imageData.clear();
-		lodepng::encode(png, img, stoi(optionList["Width"]), stoi(optionList["Height"]));
+
+		std::vector<unsigned char> png;
+		if (channels && pixelCount)
+			encodePng(png, pixels, width, height, channels);
 		imageData.assign(png.begin(), png.end());
 	}
 
@@ -472,10 +769,86 @@ void Pdf::getImages(std::string imageData,
 	}
 }
 
+void Pdf::invertGray(const unsigned char* input, size_t size, unsigned char* output) const {
+	size_t i = 0;
+#ifdef PDF_USE_SSE2
+	const __m128i mask = _mm_set1_epi8((char)0xFF);
+	for (; i + 16 <= size; i += 16) {
+		__m128i value = _mm_loadu_si128((const __m128i*)(input + i));
+		_mm_storeu_si128((__m128i*)(output + i), _mm_xor_si128(value, mask));
+	}
+#endif
+	for (; i < size; ++i)
+		output[i] = 255 - input[i];
+}
+
+void Pdf::convertCmyk(const unsigned char* input, size_t pixelCount, unsigned char* output) const {
+	// R = (255 - C) * (255 - K) / 255 (same for G and B), alpha is always 255
+	size_t i = 0;
+#ifdef PDF_USE_SSE2
+	const __m128i mask  = _mm_set1_epi8((char)0xFF);
+	const __m128i zero  = _mm_setzero_si128();
+	const __m128i round = _mm_set1_epi16(128);
+	const __m128i alpha = _mm_set1_epi32((int)0xFF000000);
+	for (; i + 4 <= pixelCount; i += 4) {
+		// 4 pixels, inverted (255 - x)
+		__m128i value = _mm_xor_si128(_mm_loadu_si128((const __m128i*)(input + i * 4)), mask);
+		__m128i part[2] = {_mm_unpacklo_epi8(value, zero), _mm_unpackhi_epi8(value, zero)};
+		for (auto& p : part) {
+			// Broadcast K to all components of pixel and divide product by 255 with rounding
+			__m128i k = _mm_shufflehi_epi16(_mm_shufflelo_epi16(p, 0xFF), 0xFF);
+			p = _mm_add_epi16(_mm_mullo_epi16(p, k), round);
+			p = _mm_srli_epi16(_mm_add_epi16(p, _mm_srli_epi16(p, 8)), 8);
+		}
+		__m128i result = _mm_or_si128(_mm_packus_epi16(part[0], part[1]), alpha);
+		_mm_storeu_si128((__m128i*)(output + i * 4), result);
+	}
+#endif
+	for (; i < pixelCount; ++i) {
+		const unsigned char* pixel = input + i * 4;
+		unsigned k = 255 - pixel[3];
+		for (int j = 0; j < 3; ++j) {
+			unsigned value = (255 - pixel[j]) * k + 128;
+			output[i * 4 + j] = static_cast<unsigned char>((value + (value >> 8)) >> 8);
+		}
+		output[i * 4 + 3] = 255;
+	}
+}
+
+void Pdf::encodePng(std::vector<unsigned char>& png, const unsigned char* image,
+					unsigned width, unsigned height, unsigned channels) const
+{
+	LodePNGColorType colorType = (channels == 1) ? LCT_GREY : (channels == 3) ? LCT_RGB : LCT_RGBA;
+	if (!m_fastImageMode) {
+		lodepng::encode(png, image, width, height, colorType);
+		return;
+	}
+
+	// Fast mode: keep color type, do not filter scanlines and use fastest deflate level
+	lodepng::State state;
+	state.info_raw.colortype       = colorType;
+	state.info_png.color.colortype = colorType;
+	state.encoder.auto_convert     = 0;
+	state.encoder.filter_strategy  = LFS_ZERO;
+	state.encoder.zlibsettings.custom_zlib = compressFast;
+	lodepng::encode(png, image, width, height, state);
+}
+
 void Pdf::transformText(pugi::xml_node& htmlNode) const {
 	for (const auto& textPair : m_textList) {
-		const auto& font = m_fontList.at(m_fontNameList.at(textPair.second));
-		const auto& transformationList = m_transformationList.at(font.first);
+		// Font (and its char map) may be missing in broken files
+		bool isMultiByte = false;
+		const CMap* cmap = nullptr;
+		auto fontName = m_fontNameList.find(textPair.second);
+		if (fontName != m_fontNameList.end()) {
+			auto font = m_fontList.find(fontName->second);
+			if (font != m_fontList.end()) {
+				isMultiByte = font->second.second;
+				auto transformation = m_transformationList.find(font->second.first);
+				if (transformation != m_transformationList.end())
+					cmap = transformation->second.get();
+			}
+		}
 
 		// We are interested in 2 situations: text in `<>` (hex) and text in `()` (plain-text)
 		bool isHex = false;
@@ -486,7 +859,7 @@ void Pdf::transformText(pugi::xml_node& htmlNode) const {
 		std::string document;
 		std::string text = textPair.first;
 		size_t textSize = text.size();
-		int step = font.second ? 4 : 2;
+		size_t step = isMultiByte ? 4 : 2;
 		for (size_t j = 0; j < textSize; ++j) {
 			char c = text[j];
 			switch (c) {
@@ -498,10 +871,11 @@ void Pdf::transformText(pugi::xml_node& htmlNode) const {
 				// End of hex-data
 				case '>':
 					for (size_t k = 0; k < hex.size(); k += step) {
-						std::string chex = tools::rpad(hex.substr(k, step), 4, '0');
-						if (transformationList.find(chex) != transformationList.end())
-							chex = transformationList.at(chex);
-						document += encoding::htmlSpecialDecode(chex); /*html_entity_decode("&#x".chex.";");*/
+						unsigned int code = 0;
+						for (size_t m = k; m < k + step && m < hex.size(); ++m)
+							code = code * 16 + tools::hexCharToDec(toupper(hex[m]));
+						if (!cmap || !cmap->decode(code, document))
+							encoding::appendUtf8(document, code);
 					}
 					isHex = false;
 					break;
@@ -542,14 +916,11 @@ void Pdf::transformText(pugi::xml_node& htmlNode) const {
 				}
 				default:
 					// Add current char to hex-data
-					if (isHex)
+					if (isHex && isxdigit(c))
 						hex += c;
 					// Add current char to plain text
 					if (isPlain) {
-						std::string key = tools::intToHex(c, 4);
-						if (transformationList.find(key) != transformationList.end())
-							plain += encoding::htmlSpecialDecode(transformationList.at(key));
-						else
+						if (!cmap || !cmap->decode(static_cast<unsigned char>(c), plain))
 							plain += c;
 					}
 			}
@@ -4,17 +4,19 @@
  * @file      pdf.hpp
  * @author    dmryutov (dmryutov@gmail.com)
  * @copyright Alex Rembish (https://github.com/rembish/TextAtAnyCost)
- * @version   1.0
+ * @version   1.1
  * @date      06.08.2017 -- 18.10.2017
  */
 #pragma once
 
+#include <memory>
 #include <string>
 #include <vector>
 #include <unordered_map>
 
 #include "../../pugixml/pugixml.hpp"
 #include "../fileext.hpp"
+#include "cmap.hpp"
 
 
 /**
@@ -54,6 +56,15 @@ public:
 	 */
 	void convert(bool addStyle = true, bool extractImages = false, char mergingMode = 0) override;
 
+	/**
+	 * @brief
+	 *     Set images encoding mode
+	 * @param[in] fastImageMode
+	 *     True if images should be encoded to PNG as fast as possible (bigger files)
+	 * @since 1.1
+	 */
+	void setFastImageMode(bool fastImageMode);
+
 private:
 	/**
 	 * @brief
@@ -78,6 +89,7 @@ private:
 	 *     - ASCII Hex
 	 *     - ASCII 85-base
 	 *     - GZ/Deflate
+	 *     Filters are applied in order in which they are declared in `Filter` option.
 	 * @param[in] stream
 	 *     Stream data
 	 * @param[in] optionList
@@ -114,13 +126,54 @@ private:
 	/**
 	 * @brief
 	 *     Decode GZ/Deflate encoding method (the most common type of compression in PDF)
+	 * @details
+	 *     Stream is inflated incrementally in one pass, so decoding time is linear
 	 * @param[in] input
 	 *     Stream data
+	 * @param[in] sizeHint
+	 *     Expected size of decoded data (0 if unknown)
 	 * @return
 	 *     Decoded stream data
 	 * @since 1.0
 	 */
-	std::string decodeFlate(const std::string& input) const;
+	std::string decodeFlate(const std::string& input, size_t sizeHint = 0) const;
+
+	/**
+	 * @brief
+	 *     Reverse prediction of decoded stream data (`DecodeParms` option)
+	 * @details
+	 *     Predictor possible values:
+	 *       Value  | Description
+	 *     :------: | -----------
+	 *         1    | No prediction
+	 *         2    | TIFF Predictor 2
+	 *     10 .. 15 | PNG prediction (filter type is set for each row)
+	 * @param[in] input
+	 *     Decoded stream data
+	 * @param[in] optionList
+	 *     List of current object options
+	 * @return
+	 *     Stream data without prediction
+	 * @since 1.1
+	 */
+	std::string decodePredictor(const std::string& input,
+								std::unordered_map<std::string, std::string>& optionList) const;
+
+	/**
+	 * @brief
+	 *     Get integer value of object option
+	 * @param[in] optionList
+	 *     List of current object options
+	 * @param[in] name
+	 *     Option name
+	 * @param[in] defaultValue
+	 *     Value if option does not exist
+	 * @return
+	 *     Option value
+	 * @since 1.1
+	 */
+	int getIntOption(std::unordered_map<std::string, std::string>& optionList,
+					 const std::string& name, int defaultValue) const;
 
 	/**
 	 * @brief
@@ -149,13 +202,53 @@ private:
 	/**
 	 * @brief
 	 *     Get array of dirty texts from `BT`-`ET` containers
+	 * @details
+	 *     Content stream is tokenized in one pass. Operands of `Tj`, `TJ`, `'` and `"`
+	 *     operators are collected together with font which is set by last `Tf` operator
 	 * @param[in] stream
 	 *     Stream data
 	 * @return
 	 *     True if at least one container contains dirty text
 	 * @since 1.0
 	 */
-	bool getDirtyTextList(std::string stream);
+	bool getDirtyTextList(const std::string& stream);
+
+	/**
+	 * @brief
+	 *     Skip literal string (including nested parentheses and escaped chars)
+	 * @param[in] stream
+	 *     Stream data
+	 * @param[in] pos
+	 *     Position of opening parenthesis
+	 * @return
+	 *     Position after closing parenthesis
+	 * @since 1.1
+	 */
+	size_t skipString(const std::string& stream, size_t pos) const;
+
+	/**
+	 * @brief
+	 *     Skip regular token (name, number or operator)
+	 * @param[in] stream
+	 *     Stream data
+	 * @param[in] pos
+	 *     Position of token char
+	 * @return
+	 *     Position of first whitespace or delimiter char after token
+	 * @since 1.1
+	 */
+	size_t skipToken(const std::string& stream, size_t pos) const;
+
+	/**
+	 * @brief
+	 *     Get font number from font resource name (`F1`, `Fa12` and so on)
+	 * @param[in] name
+	 *     Font resource name
+	 * @return
+	 *     Font number ("1" if name has another format)
+	 * @since 1.1
+	 */
+	std::string getFontNumber(const std::string& name) const;
 
 	/**
 	 * @brief
@@ -183,12 +276,28 @@ private:
 	 *                                                0000 -> abcd, 0001 -> 0123 4567, 0002 -> 8900
 	 * @param[in] stream
 	 *     Stream data
-	 * @param[out] transformationList
+	 * @param[out] cmap
 	 *     Table of transformations
 	 * @since 1.0
 	 */
-	void getTransformationList(const std::string& stream,
-							   std::unordered_map<std::string, std::string>& transformationList) const;
+	void getTransformationList(const std::string& stream, CMap& cmap) const;
+
+	/**
+	 * @brief
+	 *     Read next hex string (`<...>`) before given position
+	 * @param[in] stream
+	 *     Stream data
+	 * @param[in,out] pos
+	 *     Search start position. Position after hex string on success
+	 * @param[in] end
+	 *     Search end position
+	 * @param[out] hex
+	 *     Hex digits
+	 * @return
+	 *     True if hex string was found
+	 * @since 1.1
+	 */
+	bool readHexString(const std::string& stream, size_t& pos, size_t end, std::string& hex) const;
 
 	/**
 	 * @brief
@@ -224,6 +333,50 @@ private:
 	 */
 	void transformText(pugi::xml_node& htmlNode) const;
 
+	/**
+	 * @brief
+	 *     Invert gray image samples
+	 * @param[in] input
+	 *     Gray samples
+	 * @param[in] size
+	 *     Number of samples
+	 * @param[out] output
+	 *     Inverted samples (buffer of `size` bytes)
+	 * @since 1.1
+	 */
+	void invertGray(const unsigned char* input, size_t size, unsigned char* output) const;
+
+	/**
+	 * @brief
+	 *     Convert CMYK image samples to RGBA
+	 * @param[in] input
+	 *     CMYK samples
+	 * @param[in] pixelCount
+	 *     Number of pixels
+	 * @param[out] output
+	 *     RGBA samples (buffer of `pixelCount * 4` bytes)
+	 * @since 1.1
+	 */
+	void convertCmyk(const unsigned char* input, size_t pixelCount, unsigned char* output) const;
+
+	/**
+	 * @brief
+	 *     Encode image to PNG
+	 * @param[out] png
+	 *     PNG data
+	 * @param[in] image
+	 *     Image samples
+	 * @param[in] width
+	 *     Image width
+	 * @param[in] height
+	 *     Image height
+	 * @param[in] channels
+	 *     Number of channels (1 - gray, 3 - RGB, 4 - RGBA)
+	 * @since 1.1
+	 */
+	void encodePng(std::vector<unsigned char>& png, const unsigned char* image,
+				   unsigned width, unsigned height, unsigned channels) const;
+
 	/**
 	 * @brief
 	 *     Write binary data
@@ -246,12 +399,16 @@ private:
 	std::string m_data;
 	/** Array of dirty texts */
 	std::vector<std::pair<std::string, std::string>> m_textList;
-	/** Table of transformations */
-	std::unordered_map<std::string, std::unordered_map<std::string, std::string>> m_transformationList;
+	/** Table of transformations (char map by object) */
+	std::unordered_map<std::string, std::shared_ptr<const CMap>> m_transformationList;
+	/** Char maps by hash of stream data (for sharing identical maps) */
+	std::unordered_map<size_t, std::shared_ptr<const CMap>> m_cmapCache;
 	/** List of fonts and links to transformation table */
 	std::unordered_map<std::string, std::pair<std::string, bool>> m_fontList;
 	/** List of font names and links to objects */
 	std::unordered_map<std::string, std::string> m_fontNameList;
+	/** True if images should be encoded to PNG as fast as possible */
+	bool m_fastImageMode = false;
 };
 
 }  // End namespace
\ No newline at end of file
@@ -7,9 +7,9 @@
  * @date      05.08.2017 -- 10.02.2018
  */
 #include <list>
-#include <regex>
 #include <unordered_map>
 
+#include "../../encoding/encoding.hpp"
 #include "../../tools.hpp"
 
 #include "ppt.hpp"
@@ -17,7 +17,6 @@
 
 namespace ppt {
 
-const std::regex HEADER_MASK("(\xA8|\xA0)\x0F", std::regex::icase);
 /** Inline style */
 const std::string STYLE = "div{font-family: monospace;font-size: 13px}.slide{margin-bottom: 20px;"
 						  "padding-bottom: 10px;border-bottom: 1px solid #ddd}.slide-number{"
@@ -56,73 +55,90 @@ void Ppt::convert(bool addStyle, bool extractImages, char mergingMode) {
 	Cfb::clear();
 
 	// Start looking for all `UserEditAtom` structures, which are required to get offsets
-	// to `PersistDirectory`
-	int offsetLastEdit = offsetToCurrentEdit;
+	// to `PersistDirectory`. The first one is the live edit
+	Record record;
+	int offsetLastEdit  = offsetToCurrentEdit;
+	int docPersistIdRef = -1;
 	std::unordered_map<int, int> persistDirEntry;
-	std::string live;
 	std::list<int> offsetPersistDirectory;
 	do {
-		std::string userEditAtom = getRecord(ppdStream, offsetLastEdit, 0x0FF5);
-		live = userEditAtom;
-		offsetPersistDirectory.push_front(readByte<int>(userEditAtom, 12, 4));
-		offsetLastEdit = readByte<int>(userEditAtom, 8, 4);
+		if (!readRecord(ppdStream, offsetLastEdit, record, 0x0FF5) || record.m_length < 20)
+			return;
+		if (docPersistIdRef == -1)
+			docPersistIdRef = readByte<int>(ppdStream, record.m_offset + 16, 4);
+		offsetPersistDirectory.push_front(readByte<int>(ppdStream, record.m_offset + 12, 4));
+
+		// Previous edits are always located before current one
+		int offsetPrevEdit = readByte<int>(ppdStream, record.m_offset + 8, 4);
+		if (offsetPrevEdit >= offsetLastEdit)
+			break;
+		offsetLastEdit = offsetPrevEdit;
 	} while (offsetLastEdit != 0x00000000);
 
 	// Iterate through all offsets
 	for (const auto& offset : offsetPersistDirectory) {
-		std::string rgPersistDirEntry = getRecord(ppdStream, offset, 0x1772);
-		if (rgPersistDirEntry.empty())
+		if (!readRecord(ppdStream, offset, record, 0x1772))
 			return;
 		// Read 4 bytes:
 		// - 20 bits is the initial ID of entry in PersistDirectory,
 		// - 12 bits are the number of subsequent offsets
-		int size = static_cast<int>(rgPersistDirEntry.size());
-		for (int k = 0; k < size; ) {
-			int persist = readByte<int>(rgPersistDirEntry, k, 4);
+		size_t end = record.m_offset + record.m_length;
+		for (size_t k = record.m_offset; k + 4 <= end; ) {
+			int persist = readByte<int>(ppdStream, k, 4);
 			int persistId = persist & 0x000FFFFF;
 			int cPersist = ((persist & 0xFFF00000) >> 20) & 0x00000FFF;
 			k += 4;
 
-			for (int i = 0; i < cPersist; i++)
-				persistDirEntry[persistId + i] = readByte<int>(rgPersistDirEntry, k + i*4, 4);
-			k += cPersist * 4;
+			for (int i = 0; i < cPersist && k + 4 <= end; ++i, k += 4)
+				persistDirEntry[persistId + i] = readByte<int>(ppdStream, k, 4);
+		}
+	}
+
+	// Find entry with `DocumentContainer` and its `SlideListWithTextContainer` (masters and
+	// notes lists have the same type, but instance 1 and 2)
+	Record slideList;
+	auto entry = persistDirEntry.find(docPersistIdRef);
+	if (entry == persistDirEntry.end() ||
+		!readRecord(ppdStream, entry->second, record, 0x03E8) ||
+		!findRecord(ppdStream, record, 0x0FF0, slideList, 0)
+	)
+		return;
+
+	// Read `SlideList` structure. Text atoms after `SlidePersistAtom` belong to its slide
+	std::vector<Slide> slideDataList;
+	size_t end = slideList.m_offset + slideList.m_length;
+	for (size_t i = slideList.m_offset; i < end; i = record.m_offset + record.m_length) {
+		if (!readRecord(ppdStream, i, record))
+			break;
+
+		switch (record.m_type) {
+			// RT_SlidePersistAtom (Pointer to slide. Refer to `PersistDirectory` to get this slide)
+			case 0x03F3: {
+				slideDataList.emplace_back();
+				int pid = readByte<int>(ppdStream, record.m_offset, 4);
+				entry = persistDirEntry.find(pid);
+				slideDataList.back().m_isFound = entry != persistDirEntry.end() &&
+					readRecord(ppdStream, entry->second, slideDataList.back().m_record, 0x03EE);
+				break;
+			}
+			// RT_TextCharsAtom (Unicode-character occurrence)
+			// RT_TextBytesAtom (Plain text)
+			case 0x0FA0:
+			case 0x0FA8: {
+				if (!slideDataList.empty())
+					slideDataList.back().m_textList.push_back(record);
+				break;
+			}
 		}
 	}
 
-	// In the last entry, find ID of the entry with `DocumentContainer`
-	int docPersistIdRef = readByte<int>(live, 16, 4);
-	std::string documentContainer = getRecord(ppdStream, persistDirEntry[docPersistIdRef], 0x03E8);
-	// Skip a lot of trash data before `SlideList` structure
-	size_t offset = 48;
-	std::string trashRecord;
-	trashRecord = getRecord(documentContainer, offset, 0x0409);  // exObjList
-	if (!trashRecord.empty())
-		offset += trashRecord.size() + 8;
-	trashRecord = getRecord(documentContainer, offset, 0x03F2);  // documentTextInfo
-	offset += trashRecord.size() + 8;
-	trashRecord = getRecord(documentContainer, offset, 0x07E4);  // soundCollection
-	if (!trashRecord.empty())
-		offset += trashRecord.size() + 8;
-	trashRecord = getRecord(documentContainer, offset, 0x040B);  // drawingGroup
-	offset += trashRecord.size() + 8;
-	trashRecord = getRecord(documentContainer, offset, 0x0FF0);  // masterList
-	offset += trashRecord.size() + 8;
-	trashRecord = getRecord(documentContainer, offset, 0x07D0);  // docInfoList
-	if (!trashRecord.empty())
-		offset += trashRecord.size() + 8;
-	trashRecord = getRecord(documentContainer, offset, 0x0FD9);  // slideHF
-	if (!trashRecord.empty())
-		offset += trashRecord.size() + 8;
-	trashRecord = getRecord(documentContainer, offset, 0x0FD9);  // notesHF
-	if (!trashRecord.empty())
-		offset += trashRecord.size() + 8;
-	trashRecord.clear();
-
-	// Read `SlideList` structure
+	// Slides are independent from each other => decode them concurrently
+	tools::parallelFor(slideDataList.size(), [&](size_t i) {
+		readSlide(ppdStream, slideDataList[i]);
+	});
+
 	int slideCount = 1;
-	std::string slideList = getRecord(documentContainer, offset, 0x0FF0);
-	std::string text;
-	for (size_t i = 0; i < slideList.size(); ) {
+	for (auto& slide : slideDataList) {
 		// Add HTML tags
 		auto slideDiv = bodyTag.append_child("div");
 		slideDiv.append_attribute("class") = "slide";
@@ -132,100 +148,118 @@ void Ppt::convert(bool addStyle, bool extractImages, char mergingMode) {
 		slideNumberDiv.append_attribute("class") = "slide-number";
 		slideNumberDiv.append_child(pugi::node_pcdata).set_value(slideNumber.c_str());
 
+		if (slide.m_hasTitle) {
+			auto slideTitleDiv = slideDiv.append_child("div");
+			slideTitleDiv.append_attribute("class") = "slide-title";
+			slideTitleDiv.append_child(pugi::node_pcdata).set_value(slide.m_title.c_str());
+		}
+
 		auto slideDataDiv = slideDiv.append_child("div");
 		slideDataDiv.append_attribute("class") = "slide-data";
+		for (const auto& paragraph : slide.m_paragraphList)
+			addParagraph(paragraph, slideDataDiv);
+		std::vector<std::string>().swap(slide.m_paragraphList);
+	}
+}
 
 
-		std::string block = getRecord(slideList, i);
-		switch (getRecordType(slideList, static_cast<int>(i))) {
-			// RT_SlidePersistAtom (Pointer to slide. Refer to `PersistDirectory` to get this slide)
-			case 0x03F3: {
-				int pid = readByte<int>(block, 0 , 4);
-				std::string slide = getRecord(ppdStream, persistDirEntry[pid], 0x03EE);
-
-				// Skip a lot of trash data before `Drawing` structure
-				offset = 32;
-				trashRecord = getRecord(slide, offset, 0x03F9);  // slideShowSlideInfoAtom
-				if (!trashRecord.empty())
-					offset += trashRecord.size() + 8;
-				trashRecord = getRecord(slide, offset, 0x0FD9);  // perSlideHFContainer
-				if (!trashRecord.empty())
-					offset += trashRecord.size() + 8;
-				trashRecord = getRecord(slide, offset, 0x3714);  // rtSlideSyncInfo12
-				if (!trashRecord.empty())
-					offset += trashRecord.size() + 8;
-
-				// `Drawing` is an MS Drawing object that has similar PPT header structure. Search
-				// text directly (reading of all possible nested structures is too complicated)
-				std::string drawing = getRecord(slide, offset, 0x040C);
-				offset += drawing.size() + 8;
-
-				// Try to extract slide title (Office 2003 and earlier)
-				offset += 40;  // slideSchemeColorSchemeAtom
-				if (getRecordType(slide, static_cast<int>(offset)) == 0x0FBA) {  // slideNameAtom
-					std::string title  = unicodeToUtf8(getRecord(slide, offset, 0x0FBA));
-					auto slideTitleDiv = slideDiv.insert_child_after("div", slideNumberDiv);
-					slideTitleDiv.append_attribute("class") = "slide-title";
-					slideTitleDiv.append_child(pugi::node_pcdata).set_value(title.c_str());
-				}
-
-				std::smatch offsetList;
-				while (std::regex_search(drawing, offsetList, HEADER_MASK)) {
-					offset = offsetList.position(1);
-					// Check that block header starts with two "zeros", otherwise we probably
-					// found something in the middle of other data
-					std::string header = drawing.substr(offset - 2, 2);
-					if (header[0] == '\x00' && header[1] == '\x00') {
-						// Read either Plain text or Unicode
-						if (offsetList[1] == (char)0xA8 || offsetList[1] == -88)
-							addParagraph(getRecord(drawing, offset - 2, 0x0FA8), slideDataDiv);
-						else
-							addParagraph(unicodeToUtf8(getRecord(drawing, offset - 2, 0x0FA0)),
-										 slideDataDiv);
-					}
-
-					drawing = drawing.substr(offset + 2);
-				}
+// private:
+bool Ppt::readRecord(const std::string& stream, size_t offset, Record& record,
+					 unsigned short recType) const
+{
+	if (offset > stream.size() || stream.size() - offset < 8)
+		return false;
+
+	// `rh` header: version (4 bits), instance (12 bits), type (2 bytes) and length (4 bytes)
+	unsigned short options = readByte<unsigned short>(stream, offset, 2);
+	record.m_version  = options & 0x000F;
+	record.m_instance = options >> 4;
+	record.m_type     = readByte<unsigned short>(stream, offset + 2, 2);
+	record.m_offset   = offset + 8;
+	record.m_length   = readByte<unsigned int>(stream, offset + 4, 4);
+	return (recType == 0 || recType == record.m_type) &&
+		   record.m_length <= stream.size() - record.m_offset;
+}
 
-				break;
-			}
-			// RT_TextCharsAtom (Unicode-character occurrence)
-			case 0x0FA0: {
-				addParagraph(unicodeToUtf8(block), slideDataDiv);
-				break;
-			}
-			// RT_TextBytesAtom (Plain text)
-			case 0x0FA8: {
-				addParagraph(block, slideDataDiv);
-				break;
-			}
-		}
-		// Shift by length of block with title
-		i += block.size() + 8;
+bool Ppt::findRecord(const std::string& stream, const Record& container, unsigned short recType,
+					 Record& record, int instance) const
+{
+	size_t end = container.m_offset + container.m_length;
+	for (size_t i = container.m_offset; i < end; i = record.m_offset + record.m_length) {
+		if (!readRecord(stream, i, record))
+			return false;
+		if (record.m_type == recType && (instance == -1 || record.m_instance == instance))
+			return true;
 	}
+	return false;
 }
 
+void Ppt::readSlide(const std::string& stream, Slide& slide) const {
+	Record child;
+	if (slide.m_isFound) {
+		// Try to extract slide title (Office 2003 and earlier)
+		if (findRecord(stream, slide.m_record, 0x0FBA, child)) {  // slideNameAtom
+			slide.m_title    = unicodeToUtf8(stream.substr(child.m_offset, child.m_length));
+			slide.m_hasTitle = true;
+		}
 
-// private:
-unsigned short Ppt::getRecordLength(const std::string& stream, size_t offset,
-									  unsigned short recType) const
-{
-	std::string rh = stream.substr(offset, 8);
-	if (recType != 0 && recType != readByte<unsigned short>(rh, 2, 2))
-		return 0;
-	return readByte<int>(rh, 4, 4);
+		// `Drawing` is an MS Drawing object that has similar PPT header structure
+		if (findRecord(stream, slide.m_record, 0x040C, child))
+			readText(stream, child, slide.m_paragraphList);
+	}
+
+	for (const auto& record : slide.m_textList)
+		slide.m_paragraphList.emplace_back(getText(stream, record));
 }
 
-unsigned short Ppt::getRecordType(const std::string& stream, int offset) const {
-	std::string rh = stream.substr(offset, 8);
-	return readByte<unsigned short>(rh, 2, 2);
+void Ppt::readText(const std::string& stream, const Record& container,
+				   std::vector<std::string>& paragraphList) const
+{
+	// End offsets of containers which are being walked through
+	std::vector<size_t> endList {container.m_offset + container.m_length};
+	size_t offset = container.m_offset;
+	Record record;
+	while (!endList.empty()) {
+		// Leave container if it is over or its content is broken
+		if (offset >= endList.back() || !readRecord(stream, offset, record) ||
+			record.m_offset + record.m_length > endList.back()
+		) {
+			offset = endList.back();
+			endList.pop_back();
+			continue;
+		}
+
+		// Descend into container
+		if (record.m_version == 0x0F) {
+			endList.push_back(record.m_offset + record.m_length);
+			offset = record.m_offset;
+			continue;
+		}
+		if (record.m_type == 0x0FA0 || record.m_type == 0x0FA8)
+			paragraphList.emplace_back(getText(stream, record));
+		offset = record.m_offset + record.m_length;
+	}
 }
 
-std::string Ppt::getRecord(const std::string& stream, size_t offset, unsigned short recType) const {
-	unsigned short length = getRecordLength(stream, offset, recType);
-	if (length == 0)
-		return "";
-	return stream.substr(offset + 8, length);
+std::string Ppt::getText(const std::string& stream, const Record& record) const {
+	// RT_TextCharsAtom (UTF-16)
+	if (record.m_type == 0x0FA0)
+		return unicodeToUtf8(stream.substr(record.m_offset, record.m_length));
+
+	// RT_TextBytesAtom (low bytes of UTF-16 characters)
+	std::string text;
+	text.reserve(record.m_length);
+	size_t end = record.m_offset + record.m_length;
+	for (size_t i = record.m_offset; i < end; ++i) {
+		unsigned char c = static_cast<unsigned char>(stream[i]);
+		if (c == '\r')
+			text += '\n';
+		else if (c < 0x80)
+			text += static_cast<char>(c);
+		else
+			encoding::appendUtf8(text, c);
+	}
+	return text;
 }
 
 void Ppt::addParagraph(const std::string& text, pugi::xml_node& htmlNode) const {
@@ -4,7 +4,7 @@
  * @file      ppt.hpp
  * @author    dmryutov (dmryutov@gmail.com)
  * @copyright Alex Rembish (https://github.com/rembish/TextAtAnyCost)
- * @version   1.0.1
+ * @version   1.2
  * @date      05.08.2017 -- 10.02.2018
  */
 #pragma once
@@ -24,6 +24,46 @@
  */
 namespace ppt {
 
+/**
+ * @struct Record
+ * @brief
+ *     Record header and location of record data in stream
+ * @since 1.1
+ */
+struct Record {
+	/** Record version (0x0F for containers) */
+	unsigned short m_version  = 0;
+	/** Record instance */
+	unsigned short m_instance = 0;
+	/** Record type */
+	unsigned short m_type     = 0;
+	/** Data offset in stream */
+	size_t m_offset = 0;
+	/** Data length */
+	size_t m_length = 0;
+};
+
+/**
+ * @struct Slide
+ * @brief
+ *     Slide records and decoded slide content
+ * @since 1.2
+ */
+struct Slide {
+	/** Slide container */
+	Record m_record;
+	/** True if slide container was found */
+	bool m_isFound = false;
+	/** Text records which follow slide in `SlideList` */
+	std::vector<Record> m_textList;
+	/** Slide title */
+	std::string m_title;
+	/** True if slide has title */
+	bool m_hasTitle = false;
+	/** Paragraph list */
+	std::vector<std::string> m_paragraphList;
+};
+
 /**
  * @class Ppt
  * @brief
@@ -57,49 +97,79 @@ public:
 private:
 	/**
 	 * @brief
-	 *     Get current structure length
+	 *     Read record header
 	 * @param[in] stream
 	 *     Stream data
 	 * @param[in] offset
-	 *     Structure offset
+	 *     Record offset
+	 * @param[out] record
+	 *     Record header
 	 * @param[in] recType
-	 *     Structure type
+	 *     Expected record type (0 if any type is allowed)
 	 * @return
-	 *     Structure length
-	 * @since 1.0
+	 *     True if record has expected type and fits into stream
+	 * @since 1.1
 	 */
-	unsigned short getRecordLength(const std::string& stream, size_t offset,
-									 unsigned short recType = 0) const;
+	bool readRecord(const std::string& stream, size_t offset, Record& record,
+					unsigned short recType = 0) const;
 
 	/**
 	 * @brief
-	 *     Get current structure type in accordance with MS documentation
+	 *     Find child record of container
 	 * @param[in] stream
 	 *     Stream data
-	 * @param[in] offset
-	 *     Structure offset
+	 * @param[in] container
+	 *     Container record
+	 * @param[in] recType
+	 *     Child record type
+	 * @param[out] record
+	 *     Found record
+	 * @param[in] instance
+	 *     Child record instance (-1 if any instance is allowed)
 	 * @return
-	 *     Structure type
-	 * @since 1.0
+	 *     True if record was found
+	 * @since 1.1
 	 */
-	unsigned short getRecordType(const std::string& stream, int offset) const;
+	bool findRecord(const std::string& stream, const Record& container, unsigned short recType,
+					Record& record, int instance = -1) const;
 
 	/**
 	 * @brief
-	 *     Get record data from stream by offset, possibly a given type
-	 * @note
-	 *     Title is not sent back
+	 *     Decode slide title and text (can be called for several slides at the same time)
 	 * @param[in] stream
 	 *     Stream data
-	 * @param[in] offset
-	 *     Structure offset
-	 * @param[in] recType
-	 *     Structure type
+	 * @param[in,out] slide
+	 *     Slide data
+	 * @since 1.2
+	 */
+	void readSlide(const std::string& stream, Slide& slide) const;
+
+	/**
+	 * @brief
+	 *     Walk through record tree of container and get all text atoms
+	 * @param[in] stream
+	 *     Stream data
+	 * @param[in] container
+	 *     Container record
+	 * @param[out] paragraphList
+	 *     Paragraph list
+	 * @since 1.1
+	 */
+	void readText(const std::string& stream, const Record& container,
+				  std::vector<std::string>& paragraphList) const;
+
+	/**
+	 * @brief
+	 *     Get text of `TextCharsAtom` or `TextBytesAtom` record
+	 * @param[in] stream
+	 *     Stream data
+	 * @param[in] record
+	 *     Text record
 	 * @return
-	 *     Record data
-	 * @since 1.0
+	 *     UTF-8 text
+	 * @since 1.1
 	 */
-	std::string getRecord(const std::string& stream, size_t offset, unsigned short recType = 0) const;
+	std::string getText(const std::string& stream, const Record& record) const;
 
 	/**
 	 * @brief
@@ -99,12 +99,16 @@ Formatting& Formatting::operator=(const Formatting& obj) {
 
 
 // HtmlText public:
-HtmlText::HtmlText(const Formatting& format, bool addStyle)
-: m_format(format), m_addStyle(addStyle) {
-	m_nodeList.emplace_back(m_tree);
+HtmlText::HtmlText(const Formatting& format, bool addStyle, pugi::xml_node& tree)
+: m_format(format), m_root(tree.append_child(pugi::node_element)), m_addStyle(addStyle) {
+	m_nodeList.emplace_back(m_root);
 }
 
-void HtmlText::addSubtree(pugi::xml_node& node) const {
+HtmlText::~HtmlText() {
+	m_root.parent().remove_child(m_root);
+}
+
+void HtmlText::addSubtree(pugi::xml_node& node) {
 	std::string style;
 	std::string nodeName = node.name();
 	auto parentNode = m_nodeList[0].child("parent");
@@ -121,17 +125,29 @@ void HtmlText::addSubtree(pugi::xml_node& node) const {
 	else if (!style.empty())
 		node.append_attribute("style") = style.c_str();
 
-	for (const auto& child : parentNode)
-		node.append_copy(child);
+	// Nodes can be moved only inside the same document
+	if (node.root() != m_root.root()) {
+		for (const auto& child : parentNode)
+			node.append_copy(child);
+		return;
+	}
+	while (parentNode.first_child())
+		node.append_move(parentNode.first_child());
+}
+
+void HtmlText::formatChanged() {
+	m_isFormatChanged = true;
 }
 
 void HtmlText::clearText() {
 	m_text.clear();
 	m_formatStack.clear();
+	m_isFormatChanged = true;
 
 	m_nodeList.clear();
-	m_tree.reset();
-	m_nodeList.emplace_back(m_tree);
+	while (m_root.first_child())
+		m_root.remove_child(m_root.first_child());
+	m_nodeList.emplace_back(m_root);
 }
 
 void HtmlText::close() {
@@ -202,10 +202,29 @@ public:
  * @class HtmlText
  * @brief
  *     Parts of HTML text before adding to tree
+ * @details
+ *     Text is collected into runs. Formatting is compared with formatting stack only when it
+ *     could be changed. Runs are built inside the output tree and then moved to their
+ *     paragraph
  */
 class HtmlText {
 public:
-	HtmlText(const Formatting& format, bool addStyle);
+	/**
+	 * @param[in] format
+	 *     Current formatting
+	 * @param[in] addStyle
+	 *     Should read and add styles to HTML-tree
+	 * @param[in,out] tree
+	 *     Output HTML-tree (temporary node is added to it while text is converted)
+	 * @since 1.1
+	 */
+	HtmlText(const Formatting& format, bool addStyle, pugi::xml_node& tree);
+
+	/** Destructor */
+	~HtmlText();
+
+	HtmlText(const HtmlText&) = delete;
+	HtmlText& operator=(const HtmlText&) = delete;
 
 	/**
 	 * @brief
@@ -221,12 +240,19 @@ public:
 
 	/**
 	 * @brief
-	 *     Copy nodes to main tree
+	 *     Move nodes to main tree (copy if node belongs to another document)
 	 * @param[in,out] node
 	 *     HTML-node
 	 * @since 1.0
 	 */
-	void addSubtree(pugi::xml_node& node) const;
+	void addSubtree(pugi::xml_node& node);
+
+	/**
+	 * @brief
+	 *     Mark that current formatting could be changed
+	 * @since 1.1
+	 */
+	void formatChanged();
 
 	/**
 	 * @brief
@@ -264,21 +290,25 @@ private:
 	std::deque<Formatting> m_formatStack;
 	/** HTML text */
 	std::string m_text;
-	/** HTML-tree */
-	pugi::xml_document m_tree;
+	/** Temporary node in output HTML-tree */
+	pugi::xml_node m_root;
 	/** HTML-nodes stack */
 	std::vector<pugi::xml_node> m_nodeList;
 	/** Should read and add styles to HTML-tree */
 	bool m_addStyle;
+	/** True if formatting could be changed since last added text */
+	bool m_isFormatChanged = true;
 };
 
 
 template <typename T>
 void HtmlText::add(T str) {
-	if (!m_addStyle) {
+	// Formatting is the same as on top of stack => continue current run
+	if (!m_addStyle || !m_isFormatChanged) {
 		m_text += str;
 		return;
 	}
+	m_isFormatChanged = false;
 
 	Formatting lastFormat;
 	if (!m_formatStack.empty()) {
@@ -6,11 +6,133 @@
  * @copyright lvu (https://github.com/lvu/rtf2html)
  * @date      31.07.2016 -- 18.10.2017
  */
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+
 #include "keyword.hpp"
 
 
 namespace rtf {
 
+/**
+ * @struct KeywordName
+ * @brief
+ *     Control word and its id
+ */
+struct KeywordName {
+	/** Control word */
+	const char* m_name;
+	/** Control word id */
+	KeywordId m_id;
+};
+
+/** Known control words (sorted by name for binary search) */
+constexpr KeywordName KEYWORD_TABLE[] = {
+	{"b",          KW_B},
+	{"bin",        KW_BIN},
+	{"bliptag",    KW_BLIPTAG},
+	{"blue",       KW_BLUE},
+	{"bullet",     KW_BULLET},
+	{"cb",         KW_CB},
+	{"cell",       KW_CELL},
+	{"cellx",      KW_CELLX},
+	{"cf",         KW_CF},
+	{"clvertalb",  KW_CLVERTALB},
+	{"clvertalc",  KW_CLVERTALC},
+	{"clvertalt",  KW_CLVERTALT},
+	{"clvmgf",     KW_CLVMGF},
+	{"clvmrg",     KW_CLVMRG},
+	{"colortbl",   KW_COLORTBL},
+	{"emdash",     KW_EMDASH},
+	{"emfblip",    KW_EMFBLIP},
+	{"emspace",    KW_EMSPACE},
+	{"endash",     KW_ENDASH},
+	{"enspace",    KW_ENSPACE},
+	{"f",          KW_F},
+	{"fcharset",   KW_FCHARSET},
+	{"fdecor",     KW_FDECOR},
+	{"filetbl",    KW_FILETBL},
+	{"fmodern",    KW_FMODERN},
+	{"fnil",       KW_FNIL},
+	{"fonttbl",    KW_FONTTBL},
+	{"footer",     KW_FOOTER},
+	{"footerf",    KW_FOOTERF},
+	{"froman",     KW_FROMAN},
+	{"fs",         KW_FS},
+	{"fscript",    KW_FSCRIPT},
+	{"fswiss",     KW_FSWISS},
+	{"green",      KW_GREEN},
+	{"header",     KW_HEADER},
+	{"headerf",    KW_HEADERF},
+	{"i",          KW_I},
+	{"info",       KW_INFO},
+	{"intbl",      KW_INTBL},
+	{"jpegblip",   KW_JPEGBLIP},
+	{"ldblquote",  KW_LDBLQUOTE},
+	{"li",         KW_LI},
+	{"line",       KW_LINE},
+	{"listtext",   KW_LISTTEXT},
+	{"lquote",     KW_LQUOTE},
+	{"macpict",    KW_MACPICT},
+	{"nestrow",    KW_NESTROW},
+	{"object",     KW_OBJECT},
+	{"outl",       KW_OUTL},
+	{"par",        KW_PAR},
+	{"pard",       KW_PARD},
+	{"pichgoal",   KW_PICHGOAL},
+	{"pict",       KW_PICT},
+	{"picwgoal",   KW_PICWGOAL},
+	{"plain",      KW_PLAIN},
+	{"pngblip",    KW_PNGBLIP},
+	{"pnlvlblt",   KW_PNLVLBLT},
+	{"qc",         KW_QC},
+	{"qj",         KW_QJ},
+	{"ql",         KW_QL},
+	{"qr",         KW_QR},
+	{"rdblquote",  KW_RDBLQUOTE},
+	{"red",        KW_RED},
+	{"row",        KW_ROW},
+	{"rquote",     KW_RQUOTE},
+	{"sect",       KW_SECT},
+	{"softline",   KW_SOFTLINE},
+	{"strike",     KW_STRIKE},
+	{"striked",    KW_STRIKED},
+	{"stylesheet", KW_STYLESHEET},
+	{"sub",        KW_SUB},
+	{"super",      KW_SUPER},
+	{"tab",        KW_TAB},
+	{"trleft",     KW_TRLEFT},
+	{"trowd",      KW_TROWD},
+	{"ul",         KW_UL},
+	{"uld",        KW_ULD},
+	{"uldash",     KW_ULDASH},
+	{"uldashd",    KW_ULDASHD},
+	{"uldb",       KW_ULDB},
+	{"ulnone",     KW_ULNONE},
+	{"ulth",       KW_ULTH},
+	{"ulw",        KW_ULW},
+	{"ulwave",     KW_ULWAVE},
+};
+/** Number of known control words */
+constexpr size_t KEYWORD_COUNT = sizeof(KEYWORD_TABLE) / sizeof(KEYWORD_TABLE[0]);
+/** Parameter limit (longer numbers are not valid RTF) */
+const int MAX_PARAMETER = 100000000;
+
+/** Compare strings at compile time */
+constexpr int compareNames(const char* a, const char* b) {
+	return (*a != *b || *a == '\0') ? (*a - *b) : compareNames(a + 1, b + 1);
+}
+
+/** Check that table is sorted at compile time */
+constexpr bool isTableSorted(size_t i) {
+	return i + 1 >= KEYWORD_COUNT ||
+		   (compareNames(KEYWORD_TABLE[i].m_name, KEYWORD_TABLE[i + 1].m_name) < 0 &&
+			isTableSorted(i + 1));
+}
+
+static_assert(isTableSorted(0), "RTF keyword table must be sorted by name");
+
 Keyword::Keyword(std::string::iterator& it) {
 	char currentChar = *it;
 	m_isControlChar = !isalpha(currentChar);
@@ -20,25 +142,46 @@ Keyword::Keyword(std::string::iterator& it) {
 		++it;
 	}
 	else {
+		const char* name = &*it;
+		size_t length = 0;
 		do {
-			m_name += currentChar;
+			++length;
 		}
 		while (isalpha(currentChar = *++it));
+		m_id = find(name, length);
 
-		std::string parameterText;
-		while ((isdigit(currentChar) || currentChar == '-')) {
-			parameterText += currentChar;
-			currentChar    = *++it;
+		// Parse parameter in place
+		bool isNegative = (currentChar == '-' && isdigit(*(it + 1)));
+		if (isNegative)
+			currentChar = *++it;
+		if (isdigit(currentChar)) {
+			m_parameter = 0;
+			do {
+				if (m_parameter < MAX_PARAMETER)
+					m_parameter = m_parameter * 10 + (currentChar - '0');
+			}
+			while (isdigit(currentChar = *++it));
+			if (isNegative)
+				m_parameter = -m_parameter;
 		}
 
-		if (parameterText.empty())
-			m_parameter = -1;
-		else
-			m_parameter = std::stoi(parameterText);
-
 		if (currentChar == ' ')
 			++it;
 	}
 }
 
-}  // End namespace
\ No newline at end of file
+KeywordId Keyword::find(const char* name, size_t length) {
+	// Name is not null-terminated => compare only its chars
+	auto entry = std::lower_bound(KEYWORD_TABLE, KEYWORD_TABLE + KEYWORD_COUNT, name,
+		[length](const KeywordName& item, const char* name) {
+			return strncmp(item.m_name, name, length) < 0;
+		}
+	);
+	if (entry != KEYWORD_TABLE + KEYWORD_COUNT && strncmp(entry->m_name, name, length) == 0 &&
+		entry->m_name[length] == '\0'
+	)
+		return entry->m_id;
+	return KW_UNKNOWN;
+}
+
+}  // End namespace
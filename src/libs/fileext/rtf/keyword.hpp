@@ -13,6 +13,95 @@
 
 namespace rtf {
 
+/** Known control words (other words are `KW_UNKNOWN`) */
+enum KeywordId : unsigned char {
+	KW_UNKNOWN,
+	KW_B,
+	KW_BIN,
+	KW_BLIPTAG,
+	KW_BLUE,
+	KW_BULLET,
+	KW_CB,
+	KW_CELL,
+	KW_CELLX,
+	KW_CF,
+	KW_CLVERTALB,
+	KW_CLVERTALC,
+	KW_CLVERTALT,
+	KW_CLVMGF,
+	KW_CLVMRG,
+	KW_COLORTBL,
+	KW_EMDASH,
+	KW_EMFBLIP,
+	KW_EMSPACE,
+	KW_ENDASH,
+	KW_ENSPACE,
+	KW_F,
+	KW_FCHARSET,
+	KW_FDECOR,
+	KW_FILETBL,
+	KW_FMODERN,
+	KW_FNIL,
+	KW_FONTTBL,
+	KW_FOOTER,
+	KW_FOOTERF,
+	KW_FROMAN,
+	KW_FS,
+	KW_FSCRIPT,
+	KW_FSWISS,
+	KW_GREEN,
+	KW_HEADER,
+	KW_HEADERF,
+	KW_I,
+	KW_INFO,
+	KW_INTBL,
+	KW_JPEGBLIP,
+	KW_LDBLQUOTE,
+	KW_LI,
+	KW_LINE,
+	KW_LISTTEXT,
+	KW_LQUOTE,
+	KW_MACPICT,
+	KW_NESTROW,
+	KW_OBJECT,
+	KW_OUTL,
+	KW_PAR,
+	KW_PARD,
+	KW_PICHGOAL,
+	KW_PICT,
+	KW_PICWGOAL,
+	KW_PLAIN,
+	KW_PNGBLIP,
+	KW_PNLVLBLT,
+	KW_QC,
+	KW_QJ,
+	KW_QL,
+	KW_QR,
+	KW_RDBLQUOTE,
+	KW_RED,
+	KW_ROW,
+	KW_RQUOTE,
+	KW_SECT,
+	KW_SOFTLINE,
+	KW_STRIKE,
+	KW_STRIKED,
+	KW_STYLESHEET,
+	KW_SUB,
+	KW_SUPER,
+	KW_TAB,
+	KW_TRLEFT,
+	KW_TROWD,
+	KW_UL,
+	KW_ULD,
+	KW_ULDASH,
+	KW_ULDASHD,
+	KW_ULDB,
+	KW_ULNONE,
+	KW_ULTH,
+	KW_ULW,
+	KW_ULWAVE
+};
+
 /**
  * @class Keyword
  * @brief
@@ -23,21 +112,35 @@ public:
 	/**
 	 * @details
 	 *     Iterator must point after backslash starting the keyword. After construction,
-	 *     iterator points at char following the keyword.
+	 *     iterator points at char following the keyword. Keyword is read in place (without
+	 *     memory allocation)
 	 * @param[in] it
 	 *     Begining of keyword iterator
 	 * @since 1.0
 	 */
 	Keyword(std::string::iterator& it);
 
-	/** Keyword name */
-	std::string m_name;
+	/**
+	 * @brief
+	 *     Find control word in table of known words
+	 * @param[in] name
+	 *     Control word
+	 * @param[in] length
+	 *     Control word length
+	 * @return
+	 *     Control word id (`KW_UNKNOWN` if word is not known)
+	 * @since 1.1
+	 */
+	static KeywordId find(const char* name, size_t length);
+
+	/** Keyword id */
+	KeywordId m_id = KW_UNKNOWN;
 	/** If char is control */
 	bool m_isControlChar;
 	/** Control char value */
 	char m_controlChar;
 	/** Parameter value */
-	int m_parameter;
+	int m_parameter = -1;
 };
 
-}  // End namespace
\ No newline at end of file
+}  // End namespace
@@ -61,7 +61,7 @@ void Rtf::convert(bool addStyle, bool extractImages, char mergingMode) {
 	int  listLevel = 0;
 
 	m_nodeList.emplace_back(m_htmlTree.append_child("html").append_child("body"));
-	HtmlText htmlText(currentFormat, m_addStyle);
+	HtmlText htmlText(currentFormat, m_addStyle, m_htmlTree);
 
 	auto dataEnd = data.end();
 	for (auto dataIter = data.begin(); dataIter != dataEnd; ) {
@@ -92,385 +92,441 @@ void Rtf::convert(bool addStyle, bool extractImages, char mergingMode) {
 					hasAsterisk   = false;
 					currentFormat = formatStack.back();
 					formatStack.pop_back();
-					skipGroup(dataIter);
+					htmlText.formatChanged();
+					skipGroup(dataIter, dataEnd);
 				}
 				else {
-					std::string& keyword = kw.m_name;
-					// Skip such groups
-					if (keyword == "filetbl"  || keyword == "stylesheet" || keyword == "header"  ||
-						keyword == "footer"   || keyword == "headerf"    || keyword == "footerf" ||
-						keyword == "object"   || keyword == "info"       ||
-						(keyword == "pict" && !m_extractImages)
-					)
-						skipGroup(dataIter);
-
-					// Color table
-					else if (keyword == "colortbl") {
-						Color color;
-						while (*dataIter != '}') {
-							switch (*dataIter) {
-								case '\\': {
-									Keyword kwColor(++dataIter);
-									if (kwColor.m_name == "red")
-										color.m_red = kwColor.m_parameter;
-									else if (kwColor.m_name == "green")
-										color.m_green = kwColor.m_parameter;
-									else if (kwColor.m_name == "blue")
-										color.m_blue = kwColor.m_parameter;
-									break;
-								}
-								case ';':
-									colorTable.emplace_back(color);
-									++dataIter;
-									break;
-								default:
-									++dataIter;
-									break;
-							}
-						}
-						++dataIter;
-					}
+					// Any control word can change formatting
+					htmlText.formatChanged();
+					switch (kw.m_id) {
+						// Skip such groups
+						case KW_FILETBL: case KW_STYLESHEET: case KW_HEADER: case KW_FOOTER:
+						case KW_HEADERF: case KW_FOOTERF:    case KW_OBJECT: case KW_INFO:
+							skipGroup(dataIter, dataEnd);
+							break;
 
-					// Font table
-					else if (keyword == "fonttbl") {
-						Font font;
-						int fontNum;
-						bool fullName = false;
-						bool inFont   = false;
-						while (!(*dataIter == '}' && !inFont)) {
-							switch (*dataIter) {
-								case '\\': {
-									Keyword kwFont(++dataIter);
-									if (kwFont.m_isControlChar && kwFont.m_controlChar == '*')
-										skipGroup(dataIter);
-									else if (kwFont.m_name == "f")
-										fontNum = kwFont.m_parameter;
-									else if (kwFont.m_name == "fcharset")
-										font.m_charset = kwFont.m_parameter;
-									else if (kwFont.m_name == "fnil")
-										font.m_family = Font::FF_NONE;
-									else if (kwFont.m_name == "froman")
-										font.m_family = Font::FF_SERIF;
-									else if (kwFont.m_name == "fswiss")
-										font.m_family = Font::FF_SANS_SERIF;
-									else if (kwFont.m_name == "fmodern")
-										font.m_family = Font::FF_MONOSPACE;
-									else if (kwFont.m_name == "fscript")
-										font.m_family = Font::FF_CURSIVE;
-									else if (kwFont.m_name == "fdecor")
-										font.m_family = Font::FF_FANTASY;
-									break;
+						// Color table
+						case KW_COLORTBL: {
+							Color color;
+							while (*dataIter != '}') {
+								switch (*dataIter) {
+									case '\\': {
+										Keyword kwColor(++dataIter);
+										if (kwColor.m_id == KW_RED)
+											color.m_red = kwColor.m_parameter;
+										else if (kwColor.m_id == KW_GREEN)
+											color.m_green = kwColor.m_parameter;
+										else if (kwColor.m_id == KW_BLUE)
+											color.m_blue = kwColor.m_parameter;
+										break;
+									}
+									case ';':
+										colorTable.emplace_back(color);
+										++dataIter;
+										break;
+									default:
+										++dataIter;
+										break;
 								}
-								case '{':
-									inFont = true;
-									++dataIter;
-									break;
-								case '}':
-									inFont = false;
-									fontTable[fontNum] = font;
-									font = Font();
-									fullName = false;
-									++dataIter;
-									break;
-								case ';':
-									fullName = true;
-									++dataIter;
-									break;
-								default:
-									if (!fullName && inFont)
-										font.m_name += *dataIter;
-									++dataIter;
-									break;
 							}
+							++dataIter;
+							break;
 						}
-						++dataIter;
-						break;
-					}
 
-					// Pictures
-					else if (keyword == "pict") {
-						std::string hexData;
-						std::string ext = "wmf";
-						int bracketCount = 1;
-						bool inTagList = false;
-						int imageWidth, imageHeight;
-						while (bracketCount > 0) {
-							switch (*dataIter) {
-								case '\\': {
-									Keyword kwPict(++dataIter);
-									if (kwPict.m_name == "emfblip")
-										ext = "emf";
-									else if (kwPict.m_name == "pngblip")
-										ext = "png";
-									else if (kwPict.m_name == "jpegblip")
-										ext = "jpg";
-									else if (kwPict.m_name == "macpict")
-										ext = "pict";
-									else if (kwPict.m_name == "bliptag") {
-										int tag = kwPict.m_parameter;
-										if (std::find(imageTagList.begin(), imageTagList.end(), tag) ==
-											imageTagList.end())
-										{
-											imageTagList.emplace_back(tag);
+						// Font table
+						case KW_FONTTBL: {
+							Font font;
+							int fontNum;
+							bool fullName = false;
+							bool inFont   = false;
+							while (!(*dataIter == '}' && !inFont)) {
+								switch (*dataIter) {
+									case '\\': {
+										Keyword kwFont(++dataIter);
+										if (kwFont.m_isControlChar && kwFont.m_controlChar == '*') {
+											skipGroup(dataIter, dataEnd);
+											break;
 										}
-										else {
-											inTagList = true;
+										switch (kwFont.m_id) {
+											case KW_F:
+												fontNum = kwFont.m_parameter;
+												break;
+											case KW_FCHARSET:
+												font.m_charset = kwFont.m_parameter;
+												break;
+											case KW_FNIL:
+												font.m_family = Font::FF_NONE;
+												break;
+											case KW_FROMAN:
+												font.m_family = Font::FF_SERIF;
+												break;
+											case KW_FSWISS:
+												font.m_family = Font::FF_SANS_SERIF;
+												break;
+											case KW_FMODERN:
+												font.m_family = Font::FF_MONOSPACE;
+												break;
+											case KW_FSCRIPT:
+												font.m_family = Font::FF_CURSIVE;
+												break;
+											case KW_FDECOR:
+												font.m_family = Font::FF_FANTASY;
+												break;
+											default:
+												break;
 										}
+										break;
 									}
-									else if (kwPict.m_name == "picwgoal")
-										imageWidth = 96 * kwPict.m_parameter / 1440;
-									else if (kwPict.m_name == "pichgoal")
-										imageHeight = 96 * kwPict.m_parameter / 1440;
-									break;
+									case '{':
+										inFont = true;
+										++dataIter;
+										break;
+									case '}':
+										inFont = false;
+										fontTable[fontNum] = font;
+										font = Font();
+										fullName = false;
+										++dataIter;
+										break;
+									case ';':
+										fullName = true;
+										++dataIter;
+										break;
+									default:
+										if (!fullName && inFont)
+											font.m_name += *dataIter;
+										++dataIter;
+										break;
 								}
-								case '{':
-									bracketCount++;
-									++dataIter;
-									break;
-								case '}':
-									bracketCount--;
-									++dataIter;
-									break;
-								case '\n':
-								case '\r':
-									++dataIter;
-									break;
-								default:
-									if (bracketCount == 1 && !inTagList)
-										hexData += *dataIter;
-									++dataIter;
-									break;
 							}
+							++dataIter;
+							break;
 						}
 
-						if (!inTagList) {
-							// Decode image from HEX representation
-							std::string imageData;
-							size_t hexDataSize = hexData.size();
-							for (size_t i = 0; i < hexDataSize; i += 2) {
-								char c = (char)std::stoi(hexData.substr(i, 2), nullptr, 16);
-								imageData.push_back(c);
+						// Pictures
+						case KW_PICT: {
+							if (!m_extractImages) {
+								skipGroup(dataIter, dataEnd);
+								break;
+							}
+
+							std::string hexData;
+							std::string ext = "wmf";
+							int bracketCount = 1;
+							bool inTagList = false;
+							int imageWidth, imageHeight;
+							while (bracketCount > 0) {
+								switch (*dataIter) {
+									case '\\': {
+										Keyword kwPict(++dataIter);
+										if (kwPict.m_id == KW_EMFBLIP)
+											ext = "emf";
+										else if (kwPict.m_id == KW_PNGBLIP)
+											ext = "png";
+										else if (kwPict.m_id == KW_JPEGBLIP)
+											ext = "jpg";
+										else if (kwPict.m_id == KW_MACPICT)
+											ext = "pict";
+										else if (kwPict.m_id == KW_BLIPTAG) {
+											int tag = kwPict.m_parameter;
+											if (std::find(imageTagList.begin(), imageTagList.end(), tag) ==
+												imageTagList.end())
+											{
+												imageTagList.emplace_back(tag);
+											}
+											else {
+												inTagList = true;
+											}
+										}
+										else if (kwPict.m_id == KW_PICWGOAL)
+											imageWidth = 96 * kwPict.m_parameter / 1440;
+										else if (kwPict.m_id == KW_PICHGOAL)
+											imageHeight = 96 * kwPict.m_parameter / 1440;
+										break;
+									}
+									case '{':
+										bracketCount++;
+										++dataIter;
+										break;
+									case '}':
+										bracketCount--;
+										++dataIter;
+										break;
+									case '\n':
+									case '\r':
+										++dataIter;
+										break;
+									default:
+										if (bracketCount == 1 && !inTagList)
+											hexData += *dataIter;
+										++dataIter;
+										break;
+								}
 							}
-							m_imageList.emplace_back(std::make_pair(std::move(imageData), ext));
 
-							// Add `data-tag` attribute and some style
-							std::string style = "width: " + std::to_string(imageWidth) + "px;";
-							style += "height: " + std::to_string(imageHeight) + "px;";
+							if (!inTagList) {
+								// Decode image from HEX representation
+								std::string imageData;
+								size_t hexDataSize = hexData.size();
+								for (size_t i = 0; i < hexDataSize; i += 2) {
+									char c = (char)std::stoi(hexData.substr(i, 2), nullptr, 16);
+									imageData.push_back(c);
+								}
+								m_imageList.emplace_back(std::make_pair(std::move(imageData), ext));
+
+								// Add `data-tag` attribute and some style
+								std::string style = "width: " + std::to_string(imageWidth) + "px;";
+								style += "height: " + std::to_string(imageHeight) + "px;";
 
-							auto node = m_nodeList.back().append_child("p").append_child("img");
-							node.append_attribute("data-tag") = m_imageList.size() - 1;
-							node.append_attribute("style") = style.c_str();
+								auto node = m_nodeList.back().append_child("p").append_child("img");
+								node.append_attribute("data-tag") = m_imageList.size() - 1;
+								node.append_attribute("style") = style.c_str();
+							}
+							break;
 						}
-					}
 
-					// Special chars
-					else if (keyword == "line" || keyword == "softline")
-						htmlText.add("\n");
-					else if (keyword == "tab") {
-						if (inLi)
-							m_inBullet = false;
-						else
-							htmlText.add("\t");
-					}
-					else if (keyword == "enspace" || keyword == "emspace")
-						htmlText.add("\u00A0");  // &nbsp;
-					else if (keyword == "endash")
-						htmlText.add("\u2013");  // &ndash;
-					else if (keyword == "emdash")
-						htmlText.add("\u2014");  // &mdash;
-					else if (keyword == "bullet")
-						htmlText.add("\u2022");  // &bull;
-					else if (keyword == "lquote")
-						htmlText.add("\u2018");  // &lsquo;
-					else if (keyword == "rquote")
-						htmlText.add("\u2019");  // &rsquo;
-					else if (keyword == "ldblquote")
-						htmlText.add("\u201C");  // &ldquo;
-					else if (keyword == "rdblquote")
-						htmlText.add("\u201D");  // &rdquo;
-
-					// Paragraph formatting
-					else if (keyword == "li")
-						currentFormat.m_listLevel = kw.m_parameter/20;
-					else if (keyword == "pard") {
-						currentFormat.m_listLevel  = 0;
-						currentFormat.m_parInTable = false;
-					}
-					else if (keyword == "par" || keyword == "sect") {
-						htmlText.close();
-						// Paragraph in tables
-						if (inTable) {
-							if (currentFormat.m_parInTable) {
-								htmlText.addSubtree(tcCurCell->m_node);
-								tcCurCell->m_node.append_child("br");
+						// Special chars
+						case KW_LINE: case KW_SOFTLINE:
+							htmlText.add("\n");
+							break;
+						case KW_TAB:
+							if (inLi)
+								m_inBullet = false;
+							else
+								htmlText.add("\t");
+							break;
+						case KW_ENSPACE: case KW_EMSPACE:
+							htmlText.add("\u00A0");  // &nbsp;
+							break;
+						case KW_ENDASH:
+							htmlText.add("\u2013");  // &ndash;
+							break;
+						case KW_EMDASH:
+							htmlText.add("\u2014");  // &mdash;
+							break;
+						case KW_BULLET:
+							htmlText.add("\u2022");  // &bull;
+							break;
+						case KW_LQUOTE:
+							htmlText.add("\u2018");  // &lsquo;
+							break;
+						case KW_RQUOTE:
+							htmlText.add("\u2019");  // &rsquo;
+							break;
+						case KW_LDBLQUOTE:
+							htmlText.add("\u201C");  // &ldquo;
+							break;
+						case KW_RDBLQUOTE:
+							htmlText.add("\u201D");  // &rdquo;
+							break;
+
+						// Paragraph formatting
+						case KW_LI:
+							currentFormat.m_listLevel = kw.m_parameter/20;
+							break;
+						case KW_PARD:
+							currentFormat.m_listLevel  = 0;
+							currentFormat.m_parInTable = false;
+							break;
+						case KW_PAR: case KW_SECT:
+							htmlText.close();
+							// Paragraph in tables
+							if (inTable) {
+								if (currentFormat.m_parInTable) {
+									htmlText.addSubtree(tcCurCell->m_node);
+									tcCurCell->m_node.append_child("br");
+								}
+								else {
+									tblCurTable->make(node);
+									// + t_str (= htmlText.str())
+									inTable = false;
+									delete tblCurTable;
+									tblCurTable = new Table(m_mergingMode);
+								}
 							}
 							else {
-								tblCurTable->make(node);
-								// + t_str (= htmlText.str())
-								inTable = false;
-								delete tblCurTable;
-								tblCurTable = new Table(m_mergingMode);
-							}
-						}
-						else {
-							// Lists
-							if (inLi) {
-								std::string parentName = lastLi.parent().name();
-								std::string liName = m_isUl ? "ul" : "ol";
-								bool changeList = (currentFormat.m_listLevel == listLevel &&
-												   parentName != liName);
-
-								// Increment list level
-								if (currentFormat.m_listLevel > listLevel || changeList) {
-									// Change list type (ul <-> ol)
-									if (changeList) {
-										lastLi = m_nodeList.back().parent();
+								// Lists
+								if (inLi) {
+									std::string parentName = lastLi.parent().name();
+									std::string liName = m_isUl ? "ul" : "ol";
+									bool changeList = (currentFormat.m_listLevel == listLevel &&
+													   parentName != liName);
+
+									// Increment list level
+									if (currentFormat.m_listLevel > listLevel || changeList) {
+										// Change list type (ul <-> ol)
+										if (changeList) {
+											lastLi = m_nodeList.back().parent();
+											m_nodeList.pop_back();
+										}
+
+										node = lastLi.append_child(liName.c_str());
+										m_nodeList.emplace_back(node);
+										inList = true;
+									}
+									// Decrement list level
+									if (currentFormat.m_listLevel < listLevel) {
 										m_nodeList.pop_back();
+										node = m_nodeList.back();
 									}
 
-									node = lastLi.append_child(liName.c_str());
-									m_nodeList.emplace_back(node);
-									inList = true;
+									// Add list item
+									node   = node.append_child("li");
+									lastLi = node;
+
+									listLevel = currentFormat.m_listLevel;
+									inLi = false;
+									m_isUl = false;
 								}
-								// Decrement list level
-								if (currentFormat.m_listLevel < listLevel) {
-									m_nodeList.pop_back();
-									node = m_nodeList.back();
+								// Raw paragraphs
+								else {
+									// Close list tags
+									if (inList) {
+										inList = false;
+										m_nodeList.pop_back();
+										node = m_nodeList.back();
+									}
+
+									listLevel = currentFormat.m_listLevel;
+									lastLi = node;
+									node = node.append_child("p");
 								}
+								htmlText.addSubtree(node);
+							}
+							htmlText.clearText();
+							break;
+						case KW_LISTTEXT:
+							inLi = true;
+							m_inBullet = true;
+							break;
+						case KW_PNLVLBLT:
+							m_isUl = true;
+							break;
 
-								// Add list item
-								node   = node.append_child("li");
-								lastLi = node;
+						// Character formatting
+						case KW_B:
+							currentFormat.m_isBold = !(kw.m_parameter == 0);
+							break;
+						case KW_I:
+							currentFormat.m_isItalic = !(kw.m_parameter == 0);
+							break;
+						case KW_UL:     case KW_ULDB:   case KW_ULTH: case KW_ULW:
+						case KW_ULWAVE: case KW_ULD:    case KW_ULDASH: case KW_ULDASHD:
+							currentFormat.m_isUnderlined = !(kw.m_parameter == 0);
+							break;
+						case KW_ULNONE:
+							currentFormat.m_isUnderlined = false;
+							break;
+						case KW_STRIKE: case KW_STRIKED:
+							currentFormat.m_isStruckOut = !(kw.m_parameter == 0);
+							break;
+						case KW_OUTL:
+							currentFormat.m_isOutlined = !(kw.m_parameter == 0);
+							break;
+						case KW_SUB:
+							currentFormat.m_isSub = !(kw.m_parameter == 0);
+							break;
+						case KW_SUPER:
+							currentFormat.m_isSup = !(kw.m_parameter == 0);
+							break;
 
-								listLevel = currentFormat.m_listLevel;
-								inLi = false;
-								m_isUl = false;
-							}
-							// Raw paragraphs
-							else {
-								// Close list tags
-								if (inList) {
-									inList = false;
-									m_nodeList.pop_back();
-									node = m_nodeList.back();
-								}
+						case KW_FS:
+							currentFormat.m_fontSize = kw.m_parameter / 2;
+							break;
+						case KW_F:
+							currentFormat.m_font = fontTable[kw.m_parameter];
+							break;
 
-								listLevel = currentFormat.m_listLevel;
-								lastLi = node;
-								node = node.append_child("p");
-							}
-							htmlText.addSubtree(node);
-						}
-						htmlText.clearText();
-					}
-					else if (keyword == "listtext") {
-						inLi = true;
-						m_inBullet = true;
-					}
-					else if (keyword == "pnlvlblt") {
-						m_isUl = true;
-					}
+						case KW_CF:
+							currentFormat.m_fontColor = colorTable[kw.m_parameter];
+							break;
+						case KW_CB:
+							currentFormat.m_backgroundColor = colorTable[kw.m_parameter];
+							break;
 
-					// Character formatting
-					else if (keyword == "b")
-						currentFormat.m_isBold = !(kw.m_parameter == 0);
-					else if (keyword == "i")
-						currentFormat.m_isItalic = !(kw.m_parameter == 0);
-					else if (keyword == "ul"     || keyword == "uldb"   || keyword == "ulth" ||
-							 keyword == "ulw"    || keyword == "ulwave" || keyword == "uld"  ||
-							 keyword == "uldash" || keyword == "uldashd"
-					)
-						currentFormat.m_isUnderlined = !(kw.m_parameter == 0);
-					else if (keyword == "ulnone")
-						currentFormat.m_isUnderlined = false;
-					else if (keyword == "strike" || keyword == "striked")
-						currentFormat.m_isStruckOut = !(kw.m_parameter == 0);
-					else if (keyword == "outl")
-						currentFormat.m_isOutlined = !(kw.m_parameter == 0);
-					else if (keyword == "sub")
-						currentFormat.m_isSub = !(kw.m_parameter == 0);
-					else if (keyword == "super")
-						currentFormat.m_isSup = !(kw.m_parameter == 0);
-
-					else if (keyword == "fs")
-						currentFormat.m_fontSize = kw.m_parameter / 2;
-					else if (keyword == "f")
-						currentFormat.m_font = fontTable[kw.m_parameter];
-
-					else if (keyword == "cf")
-						currentFormat.m_fontColor = colorTable[kw.m_parameter];
-					else if (keyword == "cb" /* || keyword == "cbpat"*/)
-						currentFormat.m_backgroundColor = colorTable[kw.m_parameter];
-
-					// paragraph style
-					else if (keyword == "ql")
-						currentFormat.m_horizontalAlign = "left";
-					else if (keyword == "qc")
-						currentFormat.m_horizontalAlign = "center";
-					else if (keyword == "qr")
-						currentFormat.m_horizontalAlign = "right";
-					else if (keyword == "qj")
-						currentFormat.m_horizontalAlign = "justify";
-
-					else if (keyword == "clvertalb")
-						currentFormat.m_verticalAlign = "bottom";
-					else if (keyword == "clvertalc")
-						currentFormat.m_verticalAlign = "middle";
-					else if (keyword == "clvertalt")
-						currentFormat.m_verticalAlign = "top";
-
-					else if (keyword == "plain") {
-						currentFormat.m_isBold          = false;
-						currentFormat.m_isItalic        = false;
-						currentFormat.m_isUnderlined    = false;
-						currentFormat.m_isStruckOut     = false;
-						currentFormat.m_isOutlined      = false;
-						currentFormat.m_isSub           = false;
-						currentFormat.m_isSup           = false;
-						currentFormat.m_fontSize        = 0;
-						currentFormat.m_font            = Font();
-						currentFormat.m_fontColor       = Color();
-						currentFormat.m_backgroundColor = Color();
-						currentFormat.m_horizontalAlign.clear();
-						currentFormat.m_verticalAlign.clear();
-					}
+						// paragraph style
+						case KW_QL:
+							currentFormat.m_horizontalAlign = "left";
+							break;
+						case KW_QC:
+							currentFormat.m_horizontalAlign = "center";
+							break;
+						case KW_QR:
+							currentFormat.m_horizontalAlign = "right";
+							break;
+						case KW_QJ:
+							currentFormat.m_horizontalAlign = "justify";
+							break;
 
-					// Table formatting
-					else if (keyword == "intbl")
-						currentFormat.m_parInTable = true;
-					else if (keyword == "trowd")
-						curCellDefs = cellDefsList.insert(cellDefsList.end(), PtrVec<TableCellDef>());
-					else if (keyword == "row" || keyword == "nestrow") {
-						if (!trCurRow->m_cellList.empty()) {
-							trCurRow->m_cellDefList = curCellDefs;
-							if (trCurRow->m_left == -1000)
-								trCurRow->m_left = lastRowLeft;
-							tblCurTable->push_back(trCurRow);
-							trCurRow = new TableRow;
-						}
-						inTable = true;
-					}
-					else if (keyword == "cell") {
-						htmlText.close();
-						htmlText.addSubtree(tcCurCell->m_node);
-						htmlText.clearText();
+						case KW_CLVERTALB:
+							currentFormat.m_verticalAlign = "bottom";
+							break;
+						case KW_CLVERTALC:
+							currentFormat.m_verticalAlign = "middle";
+							break;
+						case KW_CLVERTALT:
+							currentFormat.m_verticalAlign = "top";
+							break;
 
-						trCurRow->m_cellList.push_back(tcCurCell);
-						tcCurCell = new TableCell;
-					}
-					else if (keyword == "cellx") {
-						tcdCurCellDef->m_right = kw.m_parameter;
-						curCellDefs->push_back(tcdCurCellDef);
-						tcdCurCellDef = new TableCellDef;
-					}
-					else if (keyword == "trleft") {
-						trCurRow->m_left = kw.m_parameter;
-						lastRowLeft      = kw.m_parameter;
+						case KW_PLAIN:
+							currentFormat.m_isBold          = false;
+							currentFormat.m_isItalic        = false;
+							currentFormat.m_isUnderlined    = false;
+							currentFormat.m_isStruckOut     = false;
+							currentFormat.m_isOutlined      = false;
+							currentFormat.m_isSub           = false;
+							currentFormat.m_isSup           = false;
+							currentFormat.m_fontSize        = 0;
+							currentFormat.m_font            = Font();
+							currentFormat.m_fontColor       = Color();
+							currentFormat.m_backgroundColor = Color();
+							currentFormat.m_horizontalAlign.clear();
+							currentFormat.m_verticalAlign.clear();
+							break;
+
+						// Table formatting
+						case KW_INTBL:
+							currentFormat.m_parInTable = true;
+							break;
+						case KW_TROWD:
+							curCellDefs = cellDefsList.insert(cellDefsList.end(), PtrVec<TableCellDef>());
+							break;
+						case KW_ROW: case KW_NESTROW:
+							if (!trCurRow->m_cellList.empty()) {
+								trCurRow->m_cellDefList = curCellDefs;
+								if (trCurRow->m_left == -1000)
+									trCurRow->m_left = lastRowLeft;
+								tblCurTable->push_back(trCurRow);
+								trCurRow = new TableRow;
+							}
+							inTable = true;
+							break;
+						case KW_CELL:
+							htmlText.close();
+							htmlText.addSubtree(tcCurCell->m_node);
+							htmlText.clearText();
+
+							trCurRow->m_cellList.push_back(tcCurCell);
+							tcCurCell = new TableCell;
+							break;
+						case KW_CELLX:
+							tcdCurCellDef->m_right = kw.m_parameter;
+							curCellDefs->push_back(tcdCurCellDef);
+							tcdCurCellDef = new TableCellDef;
+							break;
+						case KW_TRLEFT:
+							trCurRow->m_left = kw.m_parameter;
+							lastRowLeft      = kw.m_parameter;
+							break;
+						case KW_CLVMGF:
+							tcdCurCellDef->m_isFirstMerged = true;
+							break;
+						case KW_CLVMRG:
+							tcdCurCellDef->m_isMerged = true;
+							break;
+						default:
+							break;
 					}
-					else if (keyword == "clvmgf")
-						tcdCurCellDef->m_isFirstMerged = true;
-					else if (keyword == "clvmrg")
-						tcdCurCellDef->m_isMerged = true;
 				}
 				break;
 			}
@@ -483,6 +539,7 @@ void Rtf::convert(bool addStyle, bool extractImages, char mergingMode) {
 				// Group closing actions
 				currentFormat = formatStack.back();
 				formatStack.pop_back();
+				htmlText.formatChanged();
 				++dataIter;
 				break;
 			case 13: case 10:
@@ -511,9 +568,9 @@ void Rtf::convert(bool addStyle, bool extractImages, char mergingMode) {
 
 
 // private:
-void Rtf::skipGroup(std::string::iterator& it) const {
+void Rtf::skipGroup(std::string::iterator& it, const std::string::iterator& end) const {
 	int count = 1;
-	while (count) {
+	while (count && it != end) {
 		switch (*it++) {
 			case '{':
 				count++;
@@ -522,9 +579,12 @@ void Rtf::skipGroup(std::string::iterator& it) const {
 				count--;
 				break;
 			case '\\': {
+				if (it == end)
+					break;
 				Keyword kw(it);
-				if (!kw.m_isControlChar && kw.m_name == "rkw_bin" && kw.m_parameter > 0)
-					std::next(it, kw.m_parameter);
+				// Skip binary data (its size is not trusted)
+				if (!kw.m_isControlChar && kw.m_id == KW_BIN && kw.m_parameter > 0)
+					it += std::min<std::ptrdiff_t>(kw.m_parameter, end - it);
 				break;
 			}
 		}
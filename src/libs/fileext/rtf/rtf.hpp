@@ -59,9 +59,11 @@ private:
 	 *     Skip rtf groups
 	 * @param[in] it
 	 *     Begining of group iterator
+	 * @param[in] end
+	 *     End of data iterator
 	 * @since 1.0
 	 */
-	void skipGroup(std::string::iterator& it) const;
+	void skipGroup(std::string::iterator& it, const std::string::iterator& end) const;
 
 	/**
 	 * @brief
@@ -7,10 +7,13 @@
  * @date      01.08.2016 -- 29.01.2018
  */
 #include <algorithm>
+#include <cstring>
 #include <fstream>
+#include <memory>
 #include <regex>
 #include <sstream>
 
+#include "../../encoding/encoding.hpp"
 #include "../../tools.hpp"
 
 #include "txt.hpp"
@@ -22,6 +25,10 @@
 
 namespace txt {
 
+/** Size of file block which is read at once (streaming mode) */
+const size_t BLOCK_SIZE = 1 << 20;
+/** Encoding which is used if file is not valid UTF-8 */
+const std::string DEFAULT_ENCODING = "CP1252";
 /** List symbol list */
 const std::vector<std::string> LIST_SYMBOL {"- ", "* ", "+ "};
 const std::regex URL_REGEX("<(https?:[\\/]{2}[^\\s]+?)>", std::regex::icase);
@@ -39,14 +46,18 @@ const std::regex LIST_REGEX("^\\d+\\. .*");
 const std::regex TABLE_REGEX("(\\|\\s*\\:)?\\s*\\-{3,}\\s*(\\:\\s*\\|)?");
 
 // public:
-Txt::Txt(const std::string& fileName)
-	: FileExtension(fileName) {}
+Txt::Txt(const std::string& fileName, const std::string& encoding)
+	: FileExtension(fileName), m_encoding(encoding) {}
 
 void Txt::convert(bool addStyle, bool extractImages, char mergingMode) {
 	m_addStyle      = addStyle;
 	m_extractImages = extractImages;
 	m_mergingMode   = mergingMode;
 
+	// If style flag = `false` and streaming mode is enabled (lines are written in `saveHtml()`)
+	if (!m_addStyle && m_streamMode)
+		return;
+
 	std::vector<std::string> data;
 	std::string line;
 
@@ -281,7 +292,97 @@ void Txt::convert(bool addStyle, bool extractImages, char mergingMode) {
 }
 
 
+// protected:
+void Txt::streamHtml(std::ostream& output) {
+	std::ifstream inputFile(m_fileName, std::ios::binary);
+	std::vector<char> buffer(BLOCK_SIZE);
+	std::unique_ptr<encoding::Decoder> decoder;
+	std::string decoded;
+	std::string line;
+	bool isFirstBlock = true;
+
+	while (inputFile.read(buffer.data(), BLOCK_SIZE) || inputFile.gcount()) {
+		const char* data = buffer.data();
+		size_t size = static_cast<size_t>(inputFile.gcount());
+
+		if (isFirstBlock) {
+			size_t bomSize = 0;
+			std::string fromCode = m_encoding.empty() ? detectEncoding(data, size, bomSize)
+													  : m_encoding;
+			if (!fromCode.empty())
+				decoder.reset(new encoding::Decoder(fromCode));
+			data += bomSize;
+			size -= bomSize;
+			isFirstBlock = false;
+		}
+		if (decoder) {
+			decoded.clear();
+			decoder->decode(data, size, decoded);
+			data = decoded.data();
+			size = decoded.size();
+		}
+		writeLines(output, data, size, line);
+	}
+	if (!line.empty())
+		writeLine(output, line.data(), line.size());
+}
+
+
 // private:
+std::string Txt::detectEncoding(const char* data, size_t size, size_t& bomSize) const {
+	const auto* bom = reinterpret_cast<const unsigned char*>(data);
+	if (size >= 3 && bom[0] == 0xEF && bom[1] == 0xBB && bom[2] == 0xBF) {
+		bomSize = 3;
+		return "";
+	}
+	if (size >= 2 && bom[0] == 0xFF && bom[1] == 0xFE) {
+		bomSize = 2;
+		return "UTF-16LE";
+	}
+	if (size >= 2 && bom[0] == 0xFE && bom[1] == 0xFF) {
+		bomSize = 2;
+		return "UTF-16BE";
+	}
+	return encoding::isUtf8(data, size, true) ? "" : DEFAULT_ENCODING;
+}
+
+void Txt::writeLines(std::ostream& output, const char* data, size_t size,
+					 std::string& line) const
+{
+	const char* end = data + size;
+	while (data < end) {
+		const char* newline = static_cast<const char*>(memchr(data, '\n', end - data));
+		if (!newline) {
+			line.append(data, end - data);
+			break;
+		}
+
+		if (line.empty()) {
+			writeLine(output, data, newline - data);
+		}
+		else {
+			line.append(data, newline - data);
+			writeLine(output, line.data(), line.size());
+			line.clear();
+		}
+		data = newline + 1;
+	}
+}
+
+void Txt::writeLine(std::ostream& output, const char* data, size_t size) const {
+	// Trim `\r` symbols (Windows line endings)
+	while (size && (*data == '\r' || *data == '\n')) {
+		++data;
+		--size;
+	}
+	while (size && (data[size - 1] == '\r' || data[size - 1] == '\n'))
+		--size;
+
+	output << "<p>";
+	tools::writeHtmlEscaped(output, data, size);
+	output << "</p>\n";
+}
+
 void Txt::parseGlobalElements() {
 	// URL
 	m_html = regex_replace(m_html, URL_REGEX, "<a href=\"$1\">$1</a>");
@@ -4,7 +4,7 @@
  * @file      txt.hpp
  * @author    dmryutov (dmryutov@gmail.com)
  * @copyright adhocore (https://github.com/adhocore/htmlup)
- * @version   1.1
+ * @version   1.2
  * @date      01.08.2016 -- 18.10.2017
  */
 #pragma once
@@ -33,9 +33,11 @@ public:
 	/**
 	 * @param[in] fileName
 	 *     File name
+	 * @param[in] encoding
+	 *     File encoding (detected automatically if empty)
 	 * @since 1.0
 	 */
-	Txt(const std::string& fileName);
+	Txt(const std::string& fileName, const std::string& encoding = "");
 
 	/** Destructor */
 	virtual ~Txt() = default;
@@ -53,7 +55,60 @@ public:
 	 */
 	void convert(bool addStyle = true, bool extractImages = false, char mergingMode = 0) override;
 
+protected:
+	/**
+	 * @brief
+	 *     Write lines as paragraphs directly to output (streaming mode, style flag = `false`)
+	 * @param[out] output
+	 *     Output stream
+	 * @since 1.2
+	 */
+	void streamHtml(std::ostream& output) override;
+
 private:
+	/**
+	 * @brief
+	 *     Detect encoding by BOM or UTF-8 validity of first block
+	 * @param[in] data
+	 *     First block of file
+	 * @param[in] size
+	 *     Block size
+	 * @param[out] bomSize
+	 *     Size of BOM (should be skipped)
+	 * @return
+	 *     Encoding name (empty if file is UTF-8)
+	 * @since 1.2
+	 */
+	std::string detectEncoding(const char* data, size_t size, size_t& bomSize) const;
+
+	/**
+	 * @brief
+	 *     Split data into lines and write them as paragraphs
+	 * @param[out] output
+	 *     Output stream
+	 * @param[in] data
+	 *     Input data
+	 * @param[in] size
+	 *     Data size
+	 * @param[in,out] line
+	 *     Unfinished line from previous block
+	 * @since 1.2
+	 */
+	void writeLines(std::ostream& output, const char* data, size_t size, std::string& line) const;
+
+	/**
+	 * @brief
+	 *     Write single line as paragraph
+	 * @param[out] output
+	 *     Output stream
+	 * @param[in] data
+	 *     Line data
+	 * @param[in] size
+	 *     Line size
+	 * @since 1.2
+	 */
+	void writeLine(std::ostream& output, const char* data, size_t size) const;
+
 	/**
 	 * @brief
 	 *     Parse global elements
@@ -70,6 +125,8 @@ private:
 
 	/** HTML content */
 	std::string m_html;
+	/** File encoding */
+	std::string m_encoding;
 };
 
 }  // End namespace
\ No newline at end of file
@@ -5,8 +5,11 @@
  * @author    dmryutov (dmryutov@gmail.com)
  * @date      04.08.2016 -- 10.02.2018
  */
+#include <algorithm>
+#include <cstring>
 #include <fstream>
 
+#include "../../encoding/encoding.hpp"
 #include "../../tools.hpp"
 
 #include "xml.hpp"
@@ -18,6 +21,8 @@ namespace xml {
 const std::string STYLE = "div{font-family:monospace;font-size:13px}.content{margin-left:25px}"
 						  ".tag{color:#881280}.attribute-name{color:#994500}"
 						  ".attribute-value{color:#1a1aa6}";
+/** XML whitespace symbols */
+const char WHITESPACE[] = " \t\n\r";
 
 // public:
 Xml::Xml(const std::string& fileName)
@@ -28,6 +33,12 @@ void Xml::convert(bool addStyle, bool extractImages, char mergingMode) {
 	m_extractImages = extractImages;
 	m_mergingMode   = mergingMode;
 
+	// Streaming mode (markup is written in `saveHtml()`)
+	if (m_streamMode) {
+		m_streamStyle = STYLE;
+		return;
+	}
+
 	auto htmlTag = m_htmlTree.append_child("html");
 	auto headTag = htmlTag.append_child("head");
 	auto bodyTag = htmlTag.append_child("body");
@@ -41,6 +52,116 @@ void Xml::convert(bool addStyle, bool extractImages, char mergingMode) {
 }
 
 
+// protected:
+void Xml::streamHtml(std::ostream& output) {
+	tools::MappedFile file(m_fileName);
+	const char* p   = file.data();
+	const char* end = p + file.size();
+	// `block` tag state for document and every opened element
+	std::vector<bool> blockStack {false};
+
+	while (p && p < end) {
+		// Text
+		if (*p != '<') {
+			const char* next = static_cast<const char*>(memchr(p, '<', end - p));
+			if (!next)
+				next = end;
+			const char* q = p;
+			while (q < next && strchr(WHITESPACE, *q))
+				++q;
+			if (q != next) {
+				if (blockStack.back()) {
+					output << "</div>";
+					blockStack.back() = false;
+				}
+				writeText(p, next, output);
+			}
+			p = next;
+			continue;
+		}
+
+		// CDATA section
+		if (end - p > 9 && !memcmp(p, "<![CDATA[", 9)) {
+			const char marker[] = "]]>";
+			const char* next = std::search(p + 9, end, marker, marker + 3);
+			if (blockStack.back()) {
+				output << "</div>";
+				blockStack.back() = false;
+			}
+			tools::writeHtmlEscaped(output, p + 9, next - p - 9);
+			p = (std::min)(next + 3, end);
+			continue;
+		}
+		// Comment
+		if (end - p > 4 && !memcmp(p, "<!--", 4)) {
+			const char marker[] = "-->";
+			p = (std::min)(std::search(p + 4, end, marker, marker + 3) + 3, end);
+			continue;
+		}
+		// Declaration, processing instruction
+		if (end - p > 1 && p[1] == '?') {
+			const char marker[] = "?>";
+			p = (std::min)(std::search(p + 2, end, marker, marker + 2) + 2, end);
+			continue;
+		}
+		// DOCTYPE (may contain internal subset)
+		if (end - p > 1 && p[1] == '!') {
+			int depth = 0;
+			for (++p; p < end && (*p != '>' || depth); ++p) {
+				if (*p == '[')
+					++depth;
+				else if (*p == ']')
+					--depth;
+			}
+			p = (std::min)(p + 1, end);
+			continue;
+		}
+
+		// Find tag end (ignoring `>` inside attribute values)
+		const char* tagEnd = p + 1;
+		char quote = 0;
+		for (; tagEnd < end && (*tagEnd != '>' || quote); ++tagEnd) {
+			if (quote && *tagEnd == quote)
+				quote = 0;
+			else if (!quote && (*tagEnd == '"' || *tagEnd == '\''))
+				quote = *tagEnd;
+		}
+		if (tagEnd == end)
+			break;
+
+		// End tag
+		if (p[1] == '/') {
+			if (blockStack.size() > 1) {
+				const char* name = p + 2;
+				const char* nameEnd = std::find_first_of(name, tagEnd, WHITESPACE, WHITESPACE + 4);
+				if (blockStack.back())
+					output << "</div>";
+				blockStack.pop_back();
+				output << "</div><div class=\"line\"><span class=\"tag\">&lt;/";
+				output.write(name, nameEnd - name);
+				output << "&gt;</span></div>";
+			}
+		}
+		// Start tag
+		else {
+			streamStartTag(p + 1, tagEnd, output, blockStack);
+		}
+		p = tagEnd + 1;
+	}
+
+	// Close unclosed elements
+	while (blockStack.size() > 1) {
+		if (blockStack.back())
+			output << "</div>";
+		blockStack.pop_back();
+		output << "</div>";
+	}
+	if (blockStack.back())
+		output << "</div>";
+	output << "\n";
+}
+
+
 // private:
 void Xml::treeWalker(const pugi::xml_node& xmlNode, pugi::xml_node& htmlNode) const {
 	auto blockDiv = htmlNode.append_child("div");
@@ -92,4 +213,98 @@ void Xml::treeWalker(const pugi::xml_node& xmlNode, pugi::xml_node& htmlNode) co
 		blockDiv.parent().remove_child(blockDiv);
 }
 
+void Xml::streamStartTag(const char* begin, const char* end, std::ostream& output,
+						 std::vector<bool>& blockStack) const
+{
+	bool isEmpty = (end > begin && end[-1] == '/');
+	if (isEmpty)
+		--end;
+
+	if (!blockStack.back()) {
+		output << "<div class=\"block\">";
+		blockStack.back() = true;
+	}
+
+	// Tag name
+	const char* nameEnd = std::find_first_of(begin, end, WHITESPACE, WHITESPACE + 4);
+	output << "<div class=\"line\"><span class=\"tag\">&lt;";
+	output.write(begin, nameEnd - begin);
+
+	// Attributes
+	const char* p = nameEnd;
+	while (true) {
+		while (p < end && strchr(WHITESPACE, *p))
+			++p;
+		const char* attrName = p;
+		while (p < end && *p != '=' && !strchr(WHITESPACE, *p))
+			++p;
+		const char* attrNameEnd = p;
+		while (p < end && *p != '"' && *p != '\'')
+			++p;
+		if (p == end || attrName == attrNameEnd)
+			break;
+		const char* value = ++p;
+		while (p < end && *p != value[-1])
+			++p;
+
+		output << " <span class=\"attribute-name\">";
+		output.write(attrName, attrNameEnd - attrName);
+		output << "</span>=\"<span class=\"attribute-value\">";
+		writeText(value, p, output);
+		output << "</span>\"";
+		++p;
+	}
+	output << "&gt;</span></div><div class=\"content\">";
+
+	if (isEmpty) {
+		output << "</div><div class=\"line\"><span class=\"tag\">&lt;/";
+		output.write(begin, nameEnd - begin);
+		output << "&gt;</span></div>";
+	}
+	else {
+		blockStack.push_back(false);
+	}
+}
+
+void Xml::writeText(const char* begin, const char* end, std::ostream& output) const {
+	while (begin < end) {
+		const char* entity = static_cast<const char*>(memchr(begin, '&', end - begin));
+		if (!entity) {
+			tools::writeHtmlEscaped(output, begin, end - begin);
+			return;
+		}
+		tools::writeHtmlEscaped(output, begin, entity - begin);
+
+		const char* entityEnd = static_cast<const char*>(memchr(entity, ';', end - entity));
+		std::string name = entityEnd ? std::string(entity + 1, entityEnd) : "";
+		std::string value;
+		if (name == "lt" || name == "gt" || name == "amp")
+			value = "&"+ name +";";
+		else if (name == "quot")
+			value = "\"";
+		else if (name == "apos")
+			value = "'";
+		else if (name.size() > 1 && name[0] == '#') {
+			try {
+				bool isHex = (name[1] == 'x' || name[1] == 'X');
+				value = encoding::htmlSpecialDecode(name.substr(isHex ? 2 : 1), isHex ? 16 : 10);
+			}
+			catch (...) {}
+		}
+
+		// Unknown entity is written as is
+		if (value.empty()) {
+			output << "&amp;";
+			begin = entity + 1;
+		}
+		else {
+			if (value[0] == '&')
+				output << value;
+			else
+				tools::writeHtmlEscaped(output, value.data(), value.size());
+			begin = entityEnd + 1;
+		}
+	}
+}
+
 }  // End namespace
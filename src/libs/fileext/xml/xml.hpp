@@ -3,12 +3,14 @@
  * @package xml
  * @file    xml.hpp
  * @author  dmryutov (dmryutov@gmail.com)
- * @version 1.0.1
+ * @version 1.1
  * @date    04.08.2016 -- 10.02.2018
  */
 #pragma once
 
+#include <ostream>
 #include <string>
+#include <vector>
 
 #include "../../pugixml/pugixml.hpp"
 #include "../fileext.hpp"
@@ -51,6 +53,17 @@ public:
 	 */
 	void convert(bool addStyle = true, bool extractImages = false, char mergingMode = 0) override;
 
+protected:
+	/**
+	 * @brief
+	 *     Tokenize memory-mapped XML file and write highlighted markup directly to output
+	 *     (streaming mode)
+	 * @param[out] output
+	 *     Output stream
+	 * @since 1.1
+	 */
+	void streamHtml(std::ostream& output) override;
+
 private:
 	/**
 	 * @brief
@@ -62,6 +75,35 @@ private:
 	 * @since 1.0
 	 */
 	void treeWalker(const pugi::xml_node& xmlNode, pugi::xml_node& htmlNode) const;
+
+	/**
+	 * @brief
+	 *     Write start tag in streaming mode
+	 * @param[in] begin
+	 *     Position after `<` symbol
+	 * @param[in] end
+	 *     Position of `>` symbol
+	 * @param[out] output
+	 *     Output stream
+	 * @param[in,out] blockStack
+	 *     Flags of opened `block` tags for each nesting level
+	 * @since 1.1
+	 */
+	void streamStartTag(const char* begin, const char* end, std::ostream& output,
+						std::vector<bool>& blockStack) const;
+
+	/**
+	 * @brief
+	 *     Write text with decoding of XML entities and escaping of HTML special characters
+	 * @param[in] begin
+	 *     Text begin
+	 * @param[in] end
+	 *     Text end
+	 * @param[out] output
+	 *     Output stream
+	 * @since 1.1
+	 */
+	void writeText(const char* begin, const char* end, std::ostream& output) const;
 };
 
 }  // End namespace
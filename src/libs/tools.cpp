@@ -6,6 +6,7 @@
  * @date    04.09.2016 -- 29.01.2018
  */
 #include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <ctime>
 #include <iostream>
@@ -45,10 +46,35 @@ std::mutex MUTEX;
 		_mkdir(dir);
 	}
 	std::string os_mkdtemp(char* dir) { return _mktemp(dir); }
+
+	MappedFile::MappedFile(const std::string& fileName) {
+		HANDLE file = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+								  OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+		if (file == INVALID_HANDLE_VALUE)
+			return;
+		LARGE_INTEGER fileSize;
+		if (GetFileSizeEx(file, &fileSize) && fileSize.QuadPart > 0) {
+			m_mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+			if (m_mapping) {
+				m_data = static_cast<const char*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+				m_size = m_data ? static_cast<size_t>(fileSize.QuadPart) : 0;
+			}
+		}
+		CloseHandle(file);
+	}
+
+	MappedFile::~MappedFile() {
+		if (m_data)
+			UnmapViewOfFile(m_data);
+		if (m_mapping)
+			CloseHandle(m_mapping);
+	}
 #else
 	#include <dirent.h>
+	#include <fcntl.h>
 	#include <limits.h>
 	#include <stdlib.h>
+	#include <sys/mman.h>
 	#include <unistd.h>
 
 	const bool IS_WINDOWS = false;
@@ -67,6 +93,27 @@ std::mutex MUTEX;
 	void os_rmdir(const char* dir) { rmdir(dir); }
 	void os_mkdir(const char* dir) { mkdir(dir, S_IRWXU); }
 	std::string os_mkdtemp(char* dir) { return mkdtemp(dir); }
+
+	MappedFile::MappedFile(const std::string& fileName) {
+		int file = open(fileName.c_str(), O_RDONLY);
+		if (file < 0)
+			return;
+		struct stat fileInfo;
+		if (fstat(file, &fileInfo) == 0 && fileInfo.st_size > 0) {
+			void* data = mmap(nullptr, fileInfo.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+			if (data != MAP_FAILED) {
+				madvise(data, fileInfo.st_size, MADV_SEQUENTIAL);
+				m_data = static_cast<const char*>(data);
+				m_size = fileInfo.st_size;
+			}
+		}
+		close(file);
+	}
+
+	MappedFile::~MappedFile() {
+		if (m_data)
+			munmap(const_cast<char*>(m_data), m_size);
+	}
 #endif
 
 // Files
@@ -174,6 +221,14 @@ int getFileCount(const std::string& name) {
 	return count;
 }
 
+const char* MappedFile::data() const {
+	return m_data;
+}
+
+size_t MappedFile::size() const {
+	return m_size;
+}
+
 
 // Strings
 std::string trim(const std::string& str, const std::string& delimiter) {
@@ -400,6 +455,24 @@ std::string xorEncrypt(const std::string& str, const std::string& key) {
 	return result;
 }
 
+void writeHtmlEscaped(std::ostream& output, const char* data, size_t size) {
+	const char* end   = data + size;
+	const char* start = data;
+	for (const char* p = data; p < end; ++p) {
+		const char* entity;
+		switch (*p) {
+			case '&': entity = "&amp;"; break;
+			case '<': entity = "&lt;";  break;
+			case '>': entity = "&gt;";  break;
+			default: continue;
+		}
+		output.write(start, p - start);
+		output << entity;
+		start = p + 1;
+	}
+	output.write(start, end - start);
+}
+
 
 // XML
 int xmlChildrenCount(const pugi::xml_node& node, const std::string& childName) {
@@ -462,4 +535,41 @@ char hexCharToDec(char c) {
 	return -1;
 }
 
+void parallelFor(size_t count, const std::function<void(size_t)>& function) {
+	size_t threadCount = std::min<size_t>(count, std::max(1u, std::thread::hardware_concurrency()));
+	if (threadCount <= 1) {
+		for (size_t i = 0; i < count; ++i)
+			function(i);
+		return;
+	}
+
+	std::atomic<size_t> nextIndex(0);
+	std::atomic<bool> hasError(false);
+	std::exception_ptr error;
+	std::mutex errorMutex;
+	auto worker = [&]() {
+		size_t i;
+		while (!hasError && (i = nextIndex++) < count) {
+			try {
+				function(i);
+			}
+			catch (...) {
+				LOCK lock(errorMutex);
+				if (!hasError)
+					error = std::current_exception();
+				hasError = true;
+			}
+		}
+	};
+
+	std::vector<std::thread> threadList;
+	for (size_t i = 1; i < threadCount; ++i)
+		threadList.emplace_back(worker);
+	worker();
+	for (auto& thread : threadList)
+		thread.join();
+	if (error)
+		std::rethrow_exception(error);
+}
+
 }  // End namespace
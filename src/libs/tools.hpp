@@ -3,12 +3,14 @@
  * @package tools
  * @file    tools.hpp
  * @author  dmryutov (dmryutov@gmail.com)
- * @version 1.3
+ * @version 1.5
  * @date    04.09.2016 -- 29.01.2018
  */
 #pragma once
 
+#include <functional>
 #include <mutex>
+#include <ostream>
 #include <string>
 #include <vector>
 
@@ -179,6 +181,53 @@ namespace tools {
 	 * @since 1.0
 	 */
 	int getFileCount(const std::string& name);
+
+	/**
+	 * @class MappedFile
+	 * @brief
+	 *     Read-only memory-mapped file
+	 */
+	class MappedFile {
+	public:
+		/**
+		 * @param[in] fileName
+		 *     File name
+		 * @since 1.4
+		 */
+		MappedFile(const std::string& fileName);
+
+		/** Destructor */
+		~MappedFile();
+
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		/**
+		 * @brief
+		 *     Get file content
+		 * @return
+		 *     Pointer to mapped data (nullptr if file is empty or can not be mapped)
+		 * @since 1.4
+		 */
+		const char* data() const;
+
+		/**
+		 * @brief
+		 *     Get file size
+		 * @return
+		 *     File size
+		 * @since 1.4
+		 */
+		size_t size() const;
+
+	private:
+		/** Mapped data */
+		const char* m_data = nullptr;
+		/** File size */
+		size_t m_size = 0;
+		/** File mapping handle (Windows only) */
+		void* m_mapping = nullptr;
+	};
 	/// @}
 
 	/// @name Strings
@@ -493,6 +542,19 @@ namespace tools {
 	 * @since 1.2
 	 */
 	std::string xorEncrypt(const std::string& str, const std::string& key);
+
+	/**
+	 * @brief
+	 *     Write string to stream with escaping of HTML special characters (`&`, `<`, `>`)
+	 * @param[out] output
+	 *     Output stream
+	 * @param[in] data
+	 *     Input string
+	 * @param[in] size
+	 *     String size
+	 * @since 1.4
+	 */
+	void writeHtmlEscaped(std::ostream& output, const char* data, size_t size);
 	/// @}
 
 	/// @name XML
@@ -565,6 +627,21 @@ namespace tools {
 	 * @since 1.0
 	 */
 	char hexCharToDec(char c);
+
+	/**
+	 * @brief
+	 *     Call function for each index in `[0, count)` using all hardware threads
+	 * @details
+	 *     Indexes are taken by worker threads one by one, so order of calls is not defined.
+	 *     If function throws exception then remaining indexes are skipped and first exception
+	 *     is rethrown in calling thread
+	 * @param[in] count
+	 *     Number of indexes
+	 * @param[in] function
+	 *     Function which is called with index
+	 * @since 1.5
+	 */
+	void parallelFor(size_t count, const std::function<void(size_t)>& function);
 	/// @}
 
 	/** Current executable file absolute path */
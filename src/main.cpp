@@ -9,6 +9,7 @@
 #include <iostream>
 #include <string>
 
+#include "libs/arena/arena.hpp"
 #include "libs/getoptpp/getoptpp.hpp"
 
 #include "libs/fileext/archive/archive.hpp"
@@ -50,9 +51,16 @@ const std::string VERSION = "1.0";
  *     True if should extract styles
  * @param[in] image
  *     True if should extract images
+ * @param[in] stream
+ *     True if should stream result (if converter supports it)
+ * @param[in] report
+ *     True if should report memory usage
+ * @param[in] fastImage
+ *     True if should encode images as fast as possible (PDF only, bigger files)
  * @since 1.0
  */
-void convertFile(std::string input, std::string output, bool style, bool image);
+void convertFile(std::string input, std::string output, bool style, bool image, bool stream,
+				 bool report, bool fastImage);
 
 /**
  * @brief
@@ -65,17 +73,29 @@ void convertFile(std::string input, std::string output, bool style, bool image);
  *     True if should extract styles
  * @param[in] image
  *     True if should extract images
+ * @param[in] stream
+ *     True if should stream result (if converter supports it)
+ * @param[in] report
+ *     True if should report memory usage
+ * @param[in] fastImage
+ *     True if should encode images as fast as possible (PDF only, bigger files)
  * @since 1.0
  */
-void convertFolder(std::string input, std::string output, bool style, bool image);
+void convertFolder(std::string input, std::string output, bool style, bool image, bool stream,
+				   bool report, bool fastImage);
 
 
-void convertFile(std::string input, std::string output, bool style, bool image) {
+void convertFile(std::string input, std::string output, bool style, bool image, bool stream,
+				 bool report, bool fastImage)
+{
 	size_t last = input.find_last_of("/");
 	std::string name = input.substr(last + 1);
 	std::string dir = input.substr(0, last);
 	std::string ext = pymagic::getFileExtension(input);
 
+	// All XML-trees of conversion are allocated in arena and freed at once
+	arena::Arena memory;
+	arena::Scope memoryScope(memory);
 	std::unique_ptr<fileext::FileExtension> document;
 	try {
 		if (ext == "docx")
@@ -102,15 +122,18 @@ void convertFile(std::string input, std::string output, bool style, bool image)
 			document.reset(new ppt::Ppt(input));
 		else if (ext == "epub")
 			document.reset(new epub::Epub(input));
-		else if (ext == "pdf")
-			document.reset(new pdf::Pdf(input));
+		else if (ext == "pdf") {
+			pdf::Pdf* pdfDocument = new pdf::Pdf(input);
+			pdfDocument->setFastImageMode(fastImage);
+			document.reset(pdfDocument);
+		}
 		else if (ext == "zip" || ext == "rar" || ext == "tar" || ext == "gz" ||
 				 ext == "bz2" || (tools::IS_WINDOWS && ext == "7z"))
 		{
 			std::string archive = input + ".archive";
 			archive::extractArchive(dir, name, ext, archive);
 			std::cout << "Archive extracted: " << input << std::endl;
-			convertFolder(archive, output, style, image);
+			convertFolder(archive, output, style, image, stream, report, fastImage);
 			return;
 		}
 		else {
@@ -118,9 +141,14 @@ void convertFile(std::string input, std::string output, bool style, bool image)
 			return;
 		}
 
+		document->setStreamMode(stream);
 		document->convert(style, image, 0);
 		document->saveHtml(output, name +".html");
 		std::cout << "Conversion complete: " << input << std::endl;
+		if (report)
+			std::cout << "Memory usage: " << memory.getAllocationCount() << " allocations, "
+					  << memory.getReservedSize() / 1024 << " KB arena, "
+					  << arena::getPeakMemoryUsage() << " KB peak RSS" << std::endl;
 	}
 	catch (...) {
 		std::cerr << "Error: " << input << std::endl;
@@ -129,7 +157,9 @@ void convertFile(std::string input, std::string output, bool style, bool image)
 
 }
 
-void convertFolder(std::string input, std::string output, bool style, bool image) {
+void convertFolder(std::string input, std::string output, bool style, bool image, bool stream,
+				   bool report, bool fastImage)
+{
 	DIR *dp = dp = opendir(input.c_str());
 	struct dirent *dirp;
 	if (dp) {
@@ -137,9 +167,9 @@ void convertFolder(std::string input, std::string output, bool style, bool image
 			if (dirp->d_name[0] != '.') {
 				std::string path = input +"/"+ dirp->d_name;
 				if (tools::isDirectory(path))
-					convertFolder(path, output, style, image);
+					convertFolder(path, output, style, image, stream, report, fastImage);
 				else
-					convertFile(path, output, style, image);
+					convertFile(path, output, style, image, stream, report, fastImage);
 			}
 		}
 		closedir(dp);
@@ -150,7 +180,7 @@ void convertFolder(std::string input, std::string output, bool style, bool image
 }
 
 int main(int argc, char* argv[]) {
-	bool isFile, style, image, help, version;
+	bool isFile, style, image, stream, report, fastImage, help, version;
 	std::string input, output;
 
 	try {
@@ -162,12 +192,15 @@ int main(int argc, char* argv[]) {
 			>> GetOpt::Option('o', "out",  output)
 			>> GetOpt::OptionPresent('s', "style",   style)
 			>> GetOpt::OptionPresent('i', "image",   image)
+			>> GetOpt::OptionPresent('m', "stream",  stream)
+			>> GetOpt::OptionPresent('r', "report",  report)
+			>> GetOpt::OptionPresent('q', "quick",   fastImage)
 			>> GetOpt::OptionPresent('h', "help",    help)
 			>> GetOpt::OptionPresent('v', "version", version);
 
 		if (help) {
 			std::cout << "Usage: " << std::endl
-					  << "\t" << APP << " -f|-d <input file|dir> -o <output dir> [-si]" << std::endl
+					  << "\t" << APP << " -f|-d <input file|dir> -o <output dir> [-simrq]" << std::endl
 					  << "\t" << APP << " -h|--help" << std::endl
 					  << "\t" << APP << " -v|--version" << std::endl
 					  << "Options:" << std::endl
@@ -176,6 +209,9 @@ int main(int argc, char* argv[]) {
 					  << "\t" << "-o|--out"     << "\t" << "output directory" << std::endl
 					  << "\t" << "-s|--style"   << "\t" << "extract styles" << std::endl
 					  << "\t" << "-i|--image"   << "\t" << "extract images" << std::endl
+					  << "\t" << "-m|--stream"  << "\t" << "stream result (bounded memory)" << std::endl
+					  << "\t" << "-r|--report"  << "\t" << "report memory usage" << std::endl
+					  << "\t" << "-q|--quick"   << "\t" << "fast image encoding (PDF, bigger files)" << std::endl
 					  << "\t" << "-h|--help"    << "\t" << "display help message" << std::endl
 					  << "\t" << "-v|--version" << "\t" << "display package version" << std::endl
 					  << std::endl;
@@ -211,9 +247,9 @@ int main(int argc, char* argv[]) {
 	input = tools::absolutePath(input);
 	tools::createDir(output);
 	if (isFile)
-		convertFile(input, output, style, image);
+		convertFile(input, output, style, image, stream, report, fastImage);
 	else
-		convertFolder(input, output, style, image);
+		convertFolder(input, output, style, image, stream, report, fastImage);
 
 	return 0;
 }
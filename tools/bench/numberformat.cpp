@@ -0,0 +1,124 @@
+/**
+ * @brief   Excel number format rendering microbenchmark
+ * @package bench
+ * @file    numberformat.cpp
+ * @author  dmryutov (dmryutov@gmail.com)
+ * @date    18.10.2026 -- 18.10.2026
+ * @details
+ *     Measures how many cells per second `NumberFormat::render()` formats for common format
+ *     strings, compared with `std::to_string` (used before compiled number formats). Build from
+ *     repository root:
+ *     @code
+ *     g++ -std=c++11 -O2 -Isrc tools/bench/numberformat.cpp \
+ *         src/libs/fileext/excel/numberformat.cpp -o numberformat
+ *     ./numberformat [cell count]
+ *     @endcode
+ */
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "libs/fileext/excel/numberformat.hpp"
+
+
+/** Default amount of rendered cells */
+const size_t CELL_COUNT = 5000000;
+/** Measured format strings */
+const std::vector<std::string> FORMAT_LIST = {
+	"General",
+	"0",
+	"#,##0.00",
+	"0.00%",
+	"0.00E+00",
+	"yyyy-mm-dd hh:mm",
+	"d-mmm-yy",
+	"#,##0.00_);[Red](#,##0.00)"
+};
+
+/**
+ * @brief
+ *     Print speed of rendered cells
+ * @param[in] title
+ *     Format name
+ * @param[in] cellCount
+ *     Amount of rendered cells
+ * @param[in] start
+ *     Start time
+ * @since 1.0
+ */
+void printSpeed(const std::string& title, size_t cellCount,
+				std::chrono::steady_clock::time_point start)
+{
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	std::cout << title << ": " << cellCount / seconds / 1e6 << " M cells/s ("
+			  << seconds << " s)" << std::endl;
+}
+
+/**
+ * @brief
+ *     Render values with `std::to_string` (reference implementation)
+ * @param[in] valueList
+ *     Cell values
+ * @return
+ *     Total length of rendered text
+ * @since 1.0
+ */
+size_t renderToString(const std::vector<double>& valueList) {
+	auto start = std::chrono::steady_clock::now();
+	size_t length = 0;
+	for (double value : valueList)
+		length += std::to_string(value).size();
+	printSpeed("std::to_string", valueList.size(), start);
+	return length;
+}
+
+/**
+ * @brief
+ *     Render values with compiled number format
+ * @param[in] formatString
+ *     Format string
+ * @param[in] valueList
+ *     Cell values
+ * @return
+ *     Total length of rendered text
+ * @since 1.0
+ */
+size_t renderFormat(const std::string& formatString, const std::vector<double>& valueList) {
+	excel::NumberFormat format(formatString);
+	std::string output;
+	auto start = std::chrono::steady_clock::now();
+	size_t length = 0;
+	for (double value : valueList) {
+		// Buffer is reused between cells like in `Sheet::putNumber()`
+		output.clear();
+		format.render(value, 0, output);
+		length += output.size();
+	}
+	printSpeed(formatString, valueList.size(), start);
+	return length;
+}
+
+int main(int argc, char* argv[]) {
+	size_t cellCount = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : CELL_COUNT;
+
+	// Integers, fractions and negative numbers; positive values are dates of 1982 -- 2119
+	std::vector<double> valueList;
+	valueList.reserve(cellCount);
+	for (size_t i = 0; i < cellCount; ++i) {
+		double value = 30000 + static_cast<double>(i * 7919 % 500000) / 10;
+		if (i % 7 == 0)
+			value = static_cast<double>(static_cast<long long>(value));
+		if (i % 11 == 0)
+			value = -value / 3;
+		valueList.push_back(value);
+	}
+
+	// Total length keeps compiler from dropping rendered text
+	size_t length = renderToString(valueList);
+	for (const auto& formatString : FORMAT_LIST)
+		length += renderFormat(formatString, valueList);
+	std::cout << "Rendered " << length << " characters" << std::endl;
+	return 0;
+}
@@ -0,0 +1,135 @@
+/**
+ * @brief   RTF conversion throughput benchmark
+ * @package bench
+ * @file    rtfspeed.cpp
+ * @author  dmryutov (dmryutov@gmail.com)
+ * @date    18.10.2026 -- 18.10.2026
+ * @details
+ *     Measures how many megabytes of RTF per second `Rtf::convert()` processes (including file
+ *     reading). If no file is given, document with fonts, colors, lists, tables, unicode escapes
+ *     and skipped groups is generated into `rtfspeed.rtf`. Benchmark uses only public converter
+ *     interface, so it also builds from older revisions for comparison. Build from repository
+ *     root:
+ *     @code
+ *     R=src/libs/fileext/rtf
+ *     g++ -std=c++11 -O2 -Isrc tools/bench/rtfspeed.cpp $R/formatting.cpp $R/keyword.cpp \
+ *         $R/rtf.cpp $R/table.cpp src/libs/fileext/fileext.cpp src/libs/tools.cpp \
+ *         src/libs/pugixml/pugixml.cpp -lpthread -o rtfspeed
+ *     ./rtfspeed [file.rtf | paragraph count]
+ *     @endcode
+ */
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include "libs/fileext/rtf/rtf.hpp"
+
+
+/** Default amount of generated paragraphs (about 12 MB) */
+const size_t PARAGRAPH_COUNT = 100000;
+/** Name of generated file */
+const std::string GENERATED_FILE = "rtfspeed.rtf";
+/** Amount of measured runs (best one is printed) */
+const int RUN_COUNT = 3;
+/** Words of generated text */
+const char* const WORD_LIST[] = {
+	"lorem", "ipsum", "dolor", "sit", "amet", "consectetur", "adipiscing", "elit", "sed", "do",
+	"eiusmod", "tempor"
+};
+
+/**
+ * @brief
+ *     Generate RTF document
+ * @param[in] fileName
+ *     Output file name
+ * @param[in] paragraphCount
+ *     Amount of paragraphs
+ * @since 1.0
+ */
+void generateDocument(const std::string& fileName, size_t paragraphCount) {
+	std::ofstream output(fileName, std::ios::binary);
+	output << "{\\rtf1\\ansi\\ansicpg1252\\deff0{\\fonttbl{\\f0\\froman\\fcharset0 Times New Roman;}"
+			  "{\\f1\\fswiss\\fcharset0 Arial;}{\\f2\\fmodern Courier New;}}\n"
+			  "{\\colortbl ;\\red255\\green0\\blue0;\\red0\\green0\\blue255;}\n"
+			  "{\\stylesheet{\\s0 Normal;}}\n{\\info{\\title T}}\n{\\*\\generator Gen;}\n"
+			  "\\viewkind4\\uc1\\pard\\sa200\\sl276\\slmult1\\lang9\\f0\\fs22 \n";
+
+	unsigned int seed = 3;
+	std::string text;
+	for (size_t i = 0; i < paragraphCount; ++i) {
+		text.clear();
+		for (int j = 0; j < 12; ++j) {
+			seed = seed * 1103515245 + 12345;
+			if (j > 0)
+				text += ' ';
+			text += WORD_LIST[(seed >> 16) % 12];
+		}
+
+		switch (i % 7) {
+			case 0:
+				output << "\\pard\\qc\\b Heading " << i << "\\b0\\par\n";
+				break;
+			case 1:
+				output << "\\pard\\ql\\f1\\cf1 " << text << " \\i italic\\i0  \\ul under\\ulnone  "
+						  "\\cf2 blue\\cf0 \\par\n";
+				break;
+			case 2:
+				output << "\\pard{\\pntext\\f2\\'B7\\tab}{\\*\\pn\\pnlvlblt\\pnf2\\pnindent0"
+						  "{\\pntxtb\\'B7}}\\fi-360\\li720 " << text << "\\par\n";
+				break;
+			case 3:
+				output << "\\trowd\\trleft-108\\clvertalc\\cellx3000\\cellx6000\\pard\\intbl "
+					   << text.substr(0, 20) << "\\cell second\\cell\\row\\pard\n";
+				break;
+			case 4:
+				output << "\\pard\\qj\\fs28 " << text << " \\ldblquote q\\rdblquote  \\endash  "
+						  "\\emdash  \\bullet \\lquote x\\rquote\\par\n";
+				break;
+			case 5:
+				output << "\\pard\\plain\\fs20 \\u4184?\\u4215?\\u4226?\\u4233?\\u4240? caf\\'e9 "
+						  "\\strike s\\strike0 \\super 2\\nosupersub\\par\n";
+				break;
+			default:
+				output << "{\\header\\pard header text\\par}\\pard\\sub x\\nosupersub\\line " << text
+					   << "\\tab end\\par\n";
+				break;
+		}
+	}
+	output << "}";
+}
+
+int main(int argc, char* argv[]) {
+	// Numeric argument is amount of generated paragraphs
+	std::string fileName = GENERATED_FILE;
+	char* end = nullptr;
+	size_t paragraphCount = (argc > 1) ? std::strtoul(argv[1], &end, 10) : PARAGRAPH_COUNT;
+	if (argc > 1 && (end == argv[1] || *end != '\0'))
+		fileName = argv[1];
+	else
+		generateDocument(fileName, paragraphCount);
+
+	std::ifstream inputFile(fileName, std::ios::binary);
+	inputFile.seekg(0, std::ios::end);
+	std::streamoff size = inputFile.tellg();
+	if (size <= 0) {
+		std::cerr << "Can not read " << fileName << std::endl;
+		return 1;
+	}
+	std::cout << fileName << ": " << size / 1e6 << " MB" << std::endl;
+
+	double bestTime = 1e9;
+	for (int i = 0; i < RUN_COUNT; ++i) {
+		// Converter keeps its tree, so every run needs a new instance
+		rtf::Rtf document(fileName);
+		auto start = std::chrono::steady_clock::now();
+		document.convert(true, false, 0);
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		bestTime = std::min(bestTime, seconds);
+	}
+	std::cout << "Rtf::convert: " << size / bestTime / 1e6 << " MB/s (" << bestTime << " s)"
+			  << std::endl;
+	return 0;
+}
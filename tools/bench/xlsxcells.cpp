@@ -0,0 +1,161 @@
+/**
+ * @brief   XLSX cell parsing microbenchmark
+ * @package bench
+ * @file    xlsxcells.cpp
+ * @author  dmryutov (dmryutov@gmail.com)
+ * @date    18.10.2026 -- 18.10.2026
+ * @details
+ *     Measures how many cells per second `X12Sheet::readColumnIndex()` and
+ *     `X12Sheet::readNumber()` parse (cell reference plus shared string index), compared with
+ *     parsing through temporary strings and `std::stoi`. Build from repository root:
+ *     @code
+ *     gcc -O2 -c src/libs/miniz/miniz.c -o miniz.o
+ *     E=src/libs/fileext/excel
+ *     g++ -std=c++11 -O2 -Isrc tools/bench/xlsxcells.cpp $E/book.cpp $E/excel.cpp \
+ *         $E/format.cpp $E/formula.cpp $E/numberformat.cpp $E/sharedstrings.cpp \
+ *         $E/sheet.cpp $E/xlsx.cpp src/libs/fileext/cfb/cfb.cpp src/libs/fileext/ooxml/ooxml.cpp \
+ *         src/libs/fileext/fileext.cpp src/libs/tools.cpp src/libs/pugixml/pugixml.cpp \
+ *         miniz.o -lpthread -o xlsxcells
+ *     ./xlsxcells [cell count]
+ *     @endcode
+ */
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "libs/fileext/excel/xlsx.hpp"
+
+
+/** Default amount of parsed cells */
+const size_t CELL_COUNT = 1000000;
+/** Columns per generated row */
+const int COL_COUNT = 30;
+
+/**
+ * @brief
+ *     Build column name from column index
+ * @param[in] colIndex
+ *     Column index
+ * @return
+ *     Column name (`A`, `B`, ..., `AA`, ...)
+ * @since 1.0
+ */
+std::string getColumnName(int colIndex) {
+	std::string name;
+	for (++colIndex; colIndex > 0; colIndex = (colIndex - 1) / 26)
+		name.insert(name.begin(), static_cast<char>('A' + (colIndex - 1) % 26));
+	return name;
+}
+
+/**
+ * @brief
+ *     Parse cells through temporary strings (reference implementation)
+ * @param[in] nameList
+ *     Cell names
+ * @param[in] valueList
+ *     Cell values (shared string indexes)
+ * @return
+ *     Checksum of parsed values
+ * @since 1.0
+ */
+long long parseStrings(const std::vector<std::string>& nameList,
+					   const std::vector<std::string>& valueList)
+{
+	long long checksum = 0;
+	for (size_t i = 0; i < nameList.size(); ++i) {
+		std::string cellName = nameList[i];
+		size_t rowStart = cellName.find_first_of("0123456789");
+		std::string colName = cellName.substr(0, rowStart);
+		int colIndex = 0;
+		for (char c : colName)
+			colIndex = colIndex * 26 + (c - 'A' + 1);
+		int rowIndex = std::stoi(cellName.substr(rowStart)) - 1;
+		int value    = std::stoi(valueList[i]);
+		checksum += rowIndex + colIndex - 1 + value;
+	}
+	return checksum;
+}
+
+/**
+ * @brief
+ *     Parse cells in place with `X12Sheet` helpers
+ * @param[in] nameList
+ *     Cell names
+ * @param[in] valueList
+ *     Cell values (shared string indexes)
+ * @return
+ *     Checksum of parsed values
+ * @since 1.0
+ */
+long long parseInPlace(const std::vector<std::string>& nameList,
+					   const std::vector<std::string>& valueList)
+{
+	long long checksum = 0;
+	for (size_t i = 0; i < nameList.size(); ++i) {
+		int colIndex;
+		int rowIndex;
+		int value;
+		const char* row = excel::X12Sheet::readColumnIndex(nameList[i].c_str(), colIndex);
+		const char* rowEnd   = excel::X12Sheet::readNumber(row, rowIndex);
+		const char* valueEnd = excel::X12Sheet::readNumber(valueList[i].c_str(), value);
+		// Reject overflow and trailing characters like `X12Sheet::handleRow()`
+		if (!rowEnd || *rowEnd || !valueEnd || *valueEnd)
+			throw std::logic_error("Invalid cell "+ nameList[i]);
+		checksum += rowIndex - 1 + colIndex + value;
+	}
+	return checksum;
+}
+
+/**
+ * @brief
+ *     Run parser and print its speed
+ * @param[in] title
+ *     Parser name
+ * @param[in] parser
+ *     Parser function
+ * @param[in] nameList
+ *     Cell names
+ * @param[in] valueList
+ *     Cell values
+ * @return
+ *     Checksum of parsed values
+ * @since 1.0
+ */
+long long measure(const char* title,
+				  long long (*parser)(const std::vector<std::string>&,
+									  const std::vector<std::string>&),
+				  const std::vector<std::string>& nameList,
+				  const std::vector<std::string>& valueList)
+{
+	auto start = std::chrono::steady_clock::now();
+	long long checksum = parser(nameList, valueList);
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	std::cout << title << ": " << nameList.size() / seconds / 1e6 << " M cells/s ("
+			  << seconds << " s)" << std::endl;
+	return checksum;
+}
+
+int main(int argc, char* argv[]) {
+	size_t cellCount = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : CELL_COUNT;
+
+	// Cells of `<c r="AB12" t="s"><v>345</v></c>` form
+	std::vector<std::string> nameList;
+	std::vector<std::string> valueList;
+	nameList.reserve(cellCount);
+	valueList.reserve(cellCount);
+	for (size_t i = 0; i < cellCount; ++i) {
+		nameList.emplace_back(getColumnName(i % COL_COUNT) + std::to_string(i / COL_COUNT + 1));
+		valueList.emplace_back(std::to_string(i % 5000));
+	}
+
+	long long checksum1 = measure("std::string + stoi", parseStrings, nameList, valueList);
+	long long checksum2 = measure("X12Sheet helpers  ", parseInPlace, nameList, valueList);
+	if (checksum1 != checksum2) {
+		std::cerr << "Checksum mismatch: " << checksum1 << " != " << checksum2 << std::endl;
+		return 1;
+	}
+	return 0;
+}